@@ -0,0 +1,168 @@
+#include "AutoTune.h"
+#include "Globals.h"
+#include "Config.h"
+
+namespace AutoTune {
+
+constexpr float RELAY_DUTY = 5.0f;           // Relay amplitude around the starting duty (%)
+constexpr float HYST_V = 0.02f;              // Relay hysteresis, voltage loop (V)
+constexpr float HYST_I = 0.005f;             // Relay hysteresis, current loop (A)
+constexpr uint8_t SETTLE_CYCLES = 2;         // Oscillation cycles discarded before measuring
+constexpr uint8_t MEASURE_CYCLES = 4;        // Oscillation cycles averaged
+constexpr unsigned long TIMEOUT_MS = 30000;  // Abort if no result in time
+constexpr float MIN_CC_CURRENT = 0.05f;      // Current loop test needs a load (A)
+
+// Shared with web/encoder callers
+static volatile State state = State::Idle;   // Current state
+static volatile bool startRequested = false; // Start pending for next tick
+static volatile bool stopRequested = false;  // Abort pending for next tick
+static volatile Loop loopUnderTest = Loop::Voltage;
+static const char* volatile status = "Idle"; // Status text
+static float ku = 0.0f;                      // Ultimate gain
+static float tu = 0.0f;                      // Ultimate period (s)
+
+// Test state (control task only)
+static float baseDuty = 0.0f;      // Duty at start, relay centre (%)
+static float setpoint = 0.0f;      // Relay switching point (V or A)
+static float hyst = 0.0f;          // Relay hysteresis (V or A)
+static bool relayHigh = true;      // Relay output state
+static unsigned long startMs = 0;  // Test start
+static unsigned long lastSwitchMs = 0; // Last high->low switch
+static float pvMax = 0.0f;         // Peak of current cycle
+static float pvMin = 0.0f;         // Trough of current cycle
+static uint8_t cycles = 0;         // High->low switches seen
+static uint8_t measured = 0;       // Cycles accumulated
+static float sumAmp = 0.0f;        // Sum of half peak-to-peak amplitudes
+static float sumPeriodMs = 0.0f;   // Sum of cycle periods (ms)
+
+// Request a relay test
+bool start(Loop loop) {
+  if (isActive()) return false;
+  if (!outputActive || !modeAuto) {
+    status = "Output off";
+    return false;
+  }
+  if (loop == Loop::Current && labI_meas < MIN_CC_CURRENT) {
+    status = "No load";
+    return false;
+  }
+  loopUnderTest = loop;
+  stopRequested = false;
+  status = "Starting";
+  startRequested = true;
+  return true;
+}
+
+// Abort a running test
+void stop() {
+  if (isActive()) stopRequested = true;
+}
+
+bool isActive() { return startRequested || state == State::Running; }
+
+// End the test and hand the duty back
+static void finish(State result, const char* text, float& duty) {
+  state = result;
+  status = text;
+  duty = baseDuty;
+}
+
+// Ziegler-Nichols PI from Ku/Tu, mapped onto DcControl's incremental structure at its
+// nominal tick (DcControl rescales gains for other tick periods).
+// DcControl adds the PID output to the duty every tick, so its Kd term carries the
+// proportional action (Kd/dt * delta e), Kp carries the integral action and Ki would
+// integrate twice; it is cleared.
+static bool applyGains(float amp, float periodS) {
+  const float dt = DC_CONTROL_UPDATE_INTERVAL / 1000.0f;
+  if (periodS < 2.0f * controlPeriodUs * 1e-6f) return false; // Oscillation faster than the loop can see
+  float ampEff = sqrtf(max(amp * amp - hyst * hyst, 1e-9f));
+  ku = 4.0f * RELAY_DUTY / (PI * ampEff);
+  tu = periodS;
+
+  float kc = 0.45f * ku;
+  float ti = tu / 1.2f;
+  float newKp = kc * dt / ti;
+  float newKd = kc * dt;
+
+  // Picked up and persisted by PreferencesManager::update()
+  if (loopUnderTest == Loop::Voltage) {
+    Kp = newKp;
+    Ki = 0.0f;
+    Kd = newKd;
+  } else {
+    Kp_I = newKp;
+    Ki_I = 0.0f;
+    Kd_I = newKd;
+  }
+  return true;
+}
+
+// Control tick: drive the relay while running
+bool tick(float& duty, bool fresh) {
+  if (startRequested) {
+    startRequested = false;
+    baseDuty = duty;
+    setpoint = (loopUnderTest == Loop::Voltage) ? rampedVset : rampedIset;
+    hyst = (loopUnderTest == Loop::Voltage) ? HYST_V : HYST_I;
+    relayHigh = true;
+    startMs = lastSwitchMs = millis();
+    pvMax = -1e9f;
+    pvMin = 1e9f;
+    cycles = measured = 0;
+    sumAmp = sumPeriodMs = 0.0f;
+    state = State::Running;
+    status = "Running";
+  }
+  if (state != State::Running) return false;
+
+  // Protections drop the output; the test follows them
+  if (stopRequested) { finish(State::Aborted, "Stopped", duty); return false; }
+  if (!outputActive) { finish(State::Aborted, "Protection", duty); return false; }
+  if (!modeAuto) { finish(State::Aborted, "Manual mode", duty); return false; }
+  if (millis() - startMs > TIMEOUT_MS) { finish(State::Aborted, "Timeout", duty); return false; }
+
+  // Between conversions labV/I_meas repeat the last sample; switching on them would skew the
+  // peaks and the period, so the relay holds until the next one
+  if (!fresh) {
+    duty = baseDuty + (relayHigh ? RELAY_DUTY : -RELAY_DUTY);
+    return true;
+  }
+
+  float pv = (loopUnderTest == Loop::Voltage) ? labV_meas : labI_meas;
+  float err = setpoint - pv;
+  if (pv > pvMax) pvMax = pv;
+  if (pv < pvMin) pvMin = pv;
+
+  if (relayHigh && err < -hyst) {
+    // High->low switch closes one oscillation cycle
+    unsigned long now = millis();
+    relayHigh = false;
+    if (cycles > SETTLE_CYCLES) {
+      sumAmp += (pvMax - pvMin) * 0.5f;
+      sumPeriodMs += now - lastSwitchMs;
+      measured++;
+    }
+    cycles++;
+    lastSwitchMs = now;
+    pvMax = pvMin = pv;
+
+    if (measured >= MEASURE_CYCLES) {
+      bool ok = applyGains(sumAmp / MEASURE_CYCLES, sumPeriodMs / MEASURE_CYCLES / 1000.0f);
+      finish(ok ? State::Done : State::Aborted, ok ? "Done" : "Too fast", duty);
+      return false;
+    }
+  } else if (!relayHigh && err > hyst) {
+    relayHigh = true;
+  }
+
+  duty = baseDuty + (relayHigh ? RELAY_DUTY : -RELAY_DUTY);
+  return true;
+}
+
+State getState() { return state; }
+Loop getLoop() { return loopUnderTest; }
+const char* getStatus() { return status; }
+float getKu() { return ku; }
+float getTu() { return tu; }
+
+} // namespace AutoTune
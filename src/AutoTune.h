@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Relay-feedback PID autotuner for the voltage (CV) and current (CC) loops
+namespace AutoTune {
+
+enum class Loop : uint8_t { Voltage, Current };
+enum class State : uint8_t { Idle, Running, Done, Aborted };
+
+bool start(Loop loop);        // Request a relay test (output must be on, auto mode)
+void stop();                  // Abort a running test
+bool isActive();              // Test requested or running
+bool tick(float& duty, bool fresh); // Control tick: drives duty while running, false when control is handed back;
+                                    // the relay only switches on a fresh sample
+
+State getState();             // Current state
+Loop getLoop();               // Loop under test (or last tested)
+const char* getStatus();      // Short status text
+float getKu();                // Ultimate gain (% duty per V or A)
+float getTu();                // Ultimate period (s)
+
+} // namespace AutoTune
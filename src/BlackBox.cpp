@@ -0,0 +1,164 @@
+#include "BlackBox.h"
+#include "Globals.h"
+#include "Config.h"
+#include "DcControl.h"
+#include "ControlTask.h"
+#include "ErrMgr.h"
+#include <LittleFS.h>
+#include <time.h>
+
+namespace BlackBox {
+
+constexpr uint16_t WRITE_CHUNK = 64;       // Ticks written per update() pass
+
+static_assert(sizeof(BlackBoxHeader) == 32, "Header layout is part of the file format");
+static_assert(sizeof(BlackBoxTick) == 20, "Tick layout is part of the file format");
+static_assert(BLACKBOX_POST < BLACKBOX_DEPTH, "Post-fault ticks must fit the ring");
+
+static BlackBoxTick ring[BLACKBOX_DEPTH];  // Written by the control tick until frozen
+static uint16_t head = 0;                  // Next write
+static uint16_t filled = 0;                // Valid ticks
+static uint32_t lastUs = 0;                // Previous tick time
+static ErrMgr::Cursor errors;              // Place in the error event stream
+static uint16_t postLeft = 0;              // Ticks still to record after the trigger
+static bool capturing = false;             // Trigger seen, filling the post-fault ticks
+static volatile bool frozen = false;       // Ring handed to update() for writing
+static BlackBoxHeader pending = {};        // Header of the frozen record
+static uint32_t missed = 0;
+
+static bool mounted = false;
+static uint32_t nextSeq = 0;               // Sequence of the next record
+static Info records[SLOTS];                  // Stored records by slot
+static bool used[SLOTS] = {};
+static File file;                          // Record being written
+static uint16_t written = 0;               // Ticks of the frozen record on flash
+static uint32_t writeStartMs = 0;          // millis() when the record's file was opened
+static uint32_t lostAtStart = 0;           // ControlTask missed + overrun ticks then
+static WriteStats lastWrite = {};          // Cost of the last completed write
+
+String path(uint8_t slot) { return "/bb" + String(slot) + ".bin"; }
+
+void begin(bool fsMounted) {
+  mounted = fsMounted;
+  if (!mounted) return;
+  for (uint8_t s = 0; s < SLOTS; s++) {
+    File f = LittleFS.open(path(s).c_str(), "r");
+    if (!f) continue;
+    BlackBoxHeader h;
+    if (f.read((uint8_t*)&h, sizeof(h)) == sizeof(h) && h.magic == MAGIC && h.version == VERSION) {
+      records[s] = {s, h.seq, h.errorMask, h.newBits, h.uptimeMs, h.unixTime, h.count};
+      used[s] = true;
+      if (h.seq + 1 > nextSeq) nextSeq = h.seq + 1;
+    }
+    f.close();
+  }
+}
+
+static int16_t scaled(float v, float k) { return (int16_t)constrain(lroundf(v * k), -32768L, 32767L); }
+
+void tick(bool fresh) {
+  uint32_t rising = ErrMgr::pollRising(errors);
+  uint32_t code = ErrMgr::code();
+  if (frozen) {
+    if (rising) missed++;
+    return;
+  }
+
+  uint32_t now = micros();
+  float intV, intI;
+  DcControl::getIntegrals(intV, intI);
+  BlackBoxTick& t = ring[head];
+  t.dt10us = (uint16_t)min<uint32_t>((now - lastUs) / 10, 65535);
+  t.mV = (uint16_t)constrain(lroundf(labV_meas * 1000.0f), 0L, 65535L);
+  t.i100uA = scaled(labI_meas, 10000.0f);
+  t.vsetmV = (uint16_t)constrain(lroundf(rampedVset * 1000.0f), 0L, 65535L);
+  t.iset100uA = scaled(rampedIset, 10000.0f);
+  t.duty = (uint16_t)constrain(lroundf(DcControl::getPwmDuty() * 100.0f), 0L, 65535L);
+  t.intV = scaled(intV, 100.0f);
+  t.intI = scaled(intI, 100.0f);
+  t.tempC100 = scaled(labTemp_ntc, 100.0f);
+  t.flags = (outputActive ? 0x01 : 0) | (modeAuto ? 0x02 : 0) | (isCC ? 0x04 : 0) | (fresh ? 0x08 : 0);
+  t.profile = inaProfile;
+  lastUs = now;
+  head = (head + 1) % BLACKBOX_DEPTH;
+  if (filled < BLACKBOX_DEPTH) filled++;
+
+  if (capturing) {
+    pending.errorMask |= code;     // Bits rising after the trigger join this record
+    pending.newBits |= rising;
+    if (--postLeft == 0) {
+      pending.count = filled;
+      pending.trigger = filled - 1 - BLACKBOX_POST;
+      capturing = false;
+      frozen = true;
+    }
+  } else if (rising && mounted) {
+    time_t wall = time(nullptr);
+    pending = {MAGIC, VERSION, (uint8_t)sizeof(BlackBoxTick), 0, 0, 0, 0,
+               code, rising, (uint32_t)millis(), wall > 1600000000 ? (uint32_t)wall : 0};
+    postLeft = BLACKBOX_POST;
+    capturing = true;
+  }
+}
+
+// Control ticks the scheduler dropped or ran late so far
+static uint32_t lostTicks() {
+  ControlTask::Stats st;
+  ControlTask::getStats(st);
+  return st.missed + st.overruns;
+}
+
+void update() {
+  if (!frozen) return;
+  // Program and erase turn the flash cache off and hold every task, the control task and its timer
+  // included; a sector erase stops the tick for tens of ms. Wait until nothing is being regulated.
+  if (outputActive && !file) return;
+
+  uint8_t slot = nextSeq % SLOTS;
+  if (!file) {
+    pending.seq = nextSeq;
+    used[slot] = false;
+    file = LittleFS.open(path(slot).c_str(), "w");
+    if (!file) {
+      missed++;
+      filled = head = 0;
+      frozen = false;
+      return;
+    }
+    file.write((const uint8_t*)&pending, sizeof(pending));
+    written = 0;
+    writeStartMs = millis();
+    lostAtStart = lostTicks();
+  }
+
+  // Oldest tick sits count places behind head; write in chunks so loop() keeps running
+  uint16_t start = (head + BLACKBOX_DEPTH - pending.count) % BLACKBOX_DEPTH;
+  uint16_t end = min<uint16_t>(written + WRITE_CHUNK, pending.count);
+  for (; written < end; written++) {
+    file.write((const uint8_t*)&ring[(start + written) % BLACKBOX_DEPTH], sizeof(BlackBoxTick));
+  }
+  if (written < pending.count) return;
+
+  file.close();
+  lastWrite = {(uint32_t)(millis() - writeStartMs), lostTicks() - lostAtStart};
+  records[slot] = {slot, pending.seq, pending.errorMask, pending.newBits, pending.uptimeMs, pending.unixTime, pending.count};
+  used[slot] = true;
+  nextSeq++;
+  filled = head = 0;   // History restarts; the frozen window would leave a gap
+  frozen = false;
+}
+
+uint8_t list(Info* out, uint8_t maxRecords) {
+  uint8_t n = 0;
+  for (uint8_t k = 1; k <= SLOTS && n < maxRecords; k++) {
+    uint8_t s = (nextSeq + SLOTS - k) % SLOTS;
+    if (used[s]) out[n++] = records[s];
+  }
+  return n;
+}
+
+bool isWriting() { return frozen; }
+WriteStats getWriteStats() { return lastWrite; }
+uint32_t getMissed() { return missed; }
+
+} // namespace BlackBox
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Fault record layout: Header, then Ticks oldest first (little-endian, packed)
+struct BlackBoxHeader {
+  uint32_t magic;        // BlackBox::MAGIC
+  uint8_t version;       // BlackBox::VERSION
+  uint8_t tickSize;      // sizeof(BlackBoxTick)
+  uint16_t count;        // Ticks in the record
+  uint16_t trigger;      // Index of the tick the fault rose on
+  uint16_t reserved;
+  uint32_t seq;          // Record number (slot = seq % SLOTS)
+  uint32_t errorMask;    // Error code from the trigger to the end of the record
+  uint32_t newBits;      // Error bits that rose
+  uint32_t uptimeMs;     // millis() at the trigger
+  uint32_t unixTime;     // Wall clock at the trigger (0 = not synced)
+};
+
+// One control tick (20 bytes)
+struct BlackBoxTick {
+  uint16_t dt10us;       // Time since the previous tick (10 us units, saturates)
+  uint16_t mV;           // Measured voltage (mV)
+  int16_t i100uA;        // Measured current (0.1 mA)
+  uint16_t vsetmV;       // Ramped voltage setpoint (mV)
+  int16_t iset100uA;     // Ramped current setpoint (0.1 mA)
+  uint16_t duty;         // PWM duty (0.01 %)
+  int16_t intV;          // Voltage PID integral (x100)
+  int16_t intI;          // Current PID integral (x100)
+  int16_t tempC100;      // NTC temperature (0.01 °C)
+  uint8_t flags;         // Bit 0 output on, 1 auto mode, 2 CC, 3 fresh sample
+  uint8_t profile;       // INA226 profile
+};
+
+// Always-on control tick history, frozen and written to flash when an error bit rises
+namespace BlackBox {
+
+constexpr uint32_t MAGIC = 0x42555350;   // "PSUB"
+constexpr uint8_t VERSION = 1;
+constexpr uint8_t SLOTS = 8;             // Records kept on flash, oldest overwritten
+
+// Stored record summary
+struct Info {
+  uint8_t slot;
+  uint32_t seq;
+  uint32_t errorMask;
+  uint32_t newBits;
+  uint32_t uptimeMs;
+  uint32_t unixTime;
+  uint16_t count;
+};
+
+// Cost of writing one record, measured around the whole write
+struct WriteStats {
+  uint32_t ms;           // Open to close (ms)
+  uint32_t lostTicks;    // Control ticks missed or overrun meanwhile (ControlTask statistics)
+};
+
+void begin(bool fsMounted);    // Index stored records on the file system mounted by setup()
+void tick(bool fresh);         // Control tick: record, freeze on a rising error bit
+void update();                 // Loop task: write a frozen record in chunks once the output is off
+uint8_t list(Info* out, uint8_t maxRecords); // Stored records, newest first
+String path(uint8_t slot);     // Flash file of a slot
+bool isWriting();              // Frozen record not on flash yet
+WriteStats getWriteStats();    // Last completed write
+uint32_t getMissed();          // Faults that rose while a record was being written
+
+} // namespace BlackBox
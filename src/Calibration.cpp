@@ -0,0 +1,170 @@
+#include "Calibration.h"
+
+namespace Calibration {
+
+constexpr float GAIN_MIN = 0.5f;       // Lowest accepted segment gain
+constexpr float GAIN_MAX = 2.0f;       // Highest accepted segment gain
+constexpr float MERGE_FRACTION = 0.02f; // New points this close to an existing one replace it
+
+// Precomputed lookup: bins over the raw range point at the segment covering their start
+struct Lut {
+  uint8_t segments;              // 0 = identity
+  float raw0;                    // First breakpoint
+  float binInv;                  // Bins per raw unit
+  float edge[POINTS];            // Upper raw edge of each segment
+  float gain[POINTS];            // Segment gain
+  float offset[POINTS];          // Segment offset
+  uint8_t binSeg[BINS];          // First segment of each bin
+};
+
+enum class Op : uint8_t { None, Point, Clear };
+
+static Table table = defaultTable();                        // Current table
+static Lut luts[(uint8_t)Channel::Count][2];                // Double buffer per channel
+static Lut* volatile active[(uint8_t)Channel::Count] = {};  // LUTs used by apply()
+
+// Requests from the web task, applied by feedRaw()
+static volatile Op pendingOp = Op::None;
+static volatile uint8_t pendingCh = 0;
+static volatile float pendingRef = 0.0f;
+static float rawSum = 0.0f;
+static uint8_t rawCount = 0;
+static const char* status = "idle";
+
+Table defaultTable() {
+  Table t = {};
+  return t;
+}
+
+// Check one curve: ascending raw points and sane gains
+static bool validCurve(const Curve& c) {
+  if (c.count > POINTS) return false;
+  if (c.count == 1) {
+    if (c.raw[0] == 0.0f) return false;
+    float g = c.ref[0] / c.raw[0];
+    return g >= GAIN_MIN && g <= GAIN_MAX;
+  }
+  for (uint8_t k = 1; k < c.count; k++) {
+    float dx = c.raw[k] - c.raw[k - 1];
+    if (!(dx > 0.0f)) return false;
+    float g = (c.ref[k] - c.ref[k - 1]) / dx;
+    if (!(g >= GAIN_MIN && g <= GAIN_MAX)) return false;
+  }
+  return true;
+}
+
+// Build the lookup of one channel into the buffer apply() is not using, then swap
+static void buildLut(uint8_t ch) {
+  const Curve& c = table.ch[ch];
+  Lut* next = (active[ch] == &luts[ch][0]) ? &luts[ch][1] : &luts[ch][0];
+  *next = {};
+  if (c.count == 1) {
+    next->segments = 1;
+    next->gain[0] = c.ref[0] / c.raw[0];
+    next->edge[0] = INFINITY;
+  } else if (c.count >= 2) {
+    next->segments = c.count - 1;
+    for (uint8_t s = 0; s < next->segments; s++) {
+      next->gain[s] = (c.ref[s + 1] - c.ref[s]) / (c.raw[s + 1] - c.raw[s]);
+      next->offset[s] = c.ref[s] - next->gain[s] * c.raw[s];
+      next->edge[s] = c.raw[s + 1];
+    }
+    next->edge[next->segments - 1] = INFINITY; // End segments extrapolate
+    next->raw0 = c.raw[0];
+    next->binInv = BINS / (c.raw[c.count - 1] - c.raw[0]);
+    uint8_t s = 0;
+    for (uint8_t b = 0; b < BINS; b++) {
+      float start = c.raw[0] + b / next->binInv;
+      while (s + 1 < next->segments && start >= next->edge[s]) s++;
+      next->binSeg[b] = s;
+    }
+  }
+  active[ch] = next;
+}
+
+bool setTable(const Table& t) {
+  for (uint8_t ch = 0; ch < (uint8_t)Channel::Count; ch++) if (!validCurve(t.ch[ch])) return false;
+  table = t;
+  for (uint8_t ch = 0; ch < (uint8_t)Channel::Count; ch++) buildLut(ch);
+  return true;
+}
+
+const Table& getTable() { return table; }
+
+// Bin lookup, then at most a step or two to the segment holding raw
+float apply(Channel ch, float raw) {
+  const Lut* l = active[(uint8_t)ch];
+  if (!l || l->segments == 0 || !isfinite(raw)) return raw;
+  float pos = (raw - l->raw0) * l->binInv;  // Clamp before converting: out-of-range float to int is undefined
+  uint8_t b = pos <= 0.0f ? 0 : pos >= BINS - 1 ? BINS - 1 : (uint8_t)pos;
+  uint8_t s = l->binSeg[b];
+  while (s + 1 < l->segments && raw >= l->edge[s]) s++;
+  return l->gain[s] * raw + l->offset[s];
+}
+
+void requestPoint(Channel ch, float ref) {
+  if (ch >= Channel::Count || pendingOp != Op::None) return;
+  pendingCh = (uint8_t)ch;
+  pendingRef = ref;
+  rawSum = 0.0f;
+  rawCount = 0;
+  status = "measuring";
+  pendingOp = Op::Point;
+}
+
+void requestClear(Channel ch) {
+  if (ch >= Channel::Count || pendingOp != Op::None) return;
+  pendingCh = (uint8_t)ch;
+  pendingOp = Op::Clear;
+}
+
+// Insert (raw, ref) into a curve: replace a close or the nearest point when full
+static void insertPoint(Curve& c, float raw, float ref) {
+  uint8_t nearest = 0;
+  float best = INFINITY;
+  for (uint8_t k = 0; k < c.count; k++) {
+    float d = fabsf(c.raw[k] - raw);
+    if (d < best) {
+      best = d;
+      nearest = k;
+    }
+  }
+  if (c.count > 0 && (best <= MERGE_FRACTION * fabsf(raw) || c.count >= POINTS)) {
+    c.raw[nearest] = raw;
+    c.ref[nearest] = ref;
+  } else {
+    c.raw[c.count] = raw;
+    c.ref[c.count] = ref;
+    c.count++;
+  }
+  // Keep raw ascending
+  for (uint8_t k = 1; k < c.count; k++) {
+    for (uint8_t m = k; m > 0 && c.raw[m] < c.raw[m - 1]; m--) {
+      float r = c.raw[m]; c.raw[m] = c.raw[m - 1]; c.raw[m - 1] = r;
+      float f = c.ref[m]; c.ref[m] = c.ref[m - 1]; c.ref[m - 1] = f;
+    }
+  }
+}
+
+void feedRaw(float vRaw, float iRaw) {
+  Op op = pendingOp;
+  if (op == Op::None) return;
+  Table t = table;
+  Curve& c = t.ch[pendingCh];
+
+  if (op == Op::Clear) {
+    c = {};
+    setTable(t);
+    status = "cleared";
+  } else {
+    rawSum += pendingCh == (uint8_t)Channel::Voltage ? vRaw : iRaw;
+    if (++rawCount < CAPTURE_SAMPLES) return;
+    insertPoint(c, rawSum / rawCount, pendingRef);
+    status = setTable(t) ? "point added" : "rejected (gain out of range)";
+  }
+  pendingOp = Op::None;
+}
+
+const char* getStatus() { return status; }
+
+} // namespace Calibration
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Per-unit multi-point calibration of the INA226 voltage and current readings
+namespace Calibration {
+
+constexpr uint8_t POINTS = 6;          // Calibration points per channel
+constexpr uint8_t BINS = 32;           // Precomputed segment bins per channel
+constexpr uint8_t CAPTURE_SAMPLES = 16; // Raw readings averaged per captured point
+
+enum class Channel : uint8_t { Voltage, Current, Count };
+
+// Points of one channel: raw sensor reading -> reference meter value
+struct Curve {
+  uint8_t count;                 // Points in use (0 = uncalibrated, 1 = gain only)
+  uint8_t reserved[3];           // Keeps the struct free of padding for memcmp
+  float raw[POINTS];             // Raw readings, ascending
+  float ref[POINTS];             // Reference values
+};
+
+// Persisted calibration
+struct Table {
+  Curve ch[(uint8_t)Channel::Count];
+};
+
+Table defaultTable();                        // Uncalibrated (identity)
+bool setTable(const Table& table);           // Validate, store and precompute lookup
+const Table& getTable();                     // Current table
+float apply(Channel ch, float raw);          // Calibrated value (O(1), called per conversion)
+
+void requestPoint(Channel ch, float ref);    // Capture a point against a reference reading
+void requestClear(Channel ch);               // Drop all points of a channel
+void feedRaw(float vRaw, float iRaw);        // Sensor side: raw readings, applies requests
+const char* getStatus();                     // Result of the last request
+
+} // namespace Calibration
@@ -19,11 +19,41 @@
 
 // INA226 configuration
 #define INA226_I2C_ADDRESS    0x40   // INA226 I2C address
-#define SHUNT_RESISTANCE_OHMS 0.0053f // Shunt resistance (ohms)
+#define SHUNT_RESISTANCE_OHMS 0.0053f // Nominal shunt resistance (ohms); per-unit spread is calibrated at runtime
 #define SHUNT_MAX_CURRENT_A   3.2f   // Max measurable current (A)
+#define INA226_ALERT_PIN         4   // INA226 ALERT pin (open-drain, active low), -1 = not wired
+#define INA226_ALERT_TRIP        1   // 1 = ALERT is a hardware overcurrent trip, 0 = conversion ready; otherwise the flag is polled over I2C
+#define INA226_TRIP_MARGIN   1.10f   // ALERT trip level relative to the fuse peak (labI_cut x curve peak, capped at the system limit)
+#define SCOPE_DEPTH_PSRAM     8192   // Scope capture points when PSRAM is present
+#define SCOPE_DEPTH_SRAM      1024   // Scope capture points in internal RAM
+#define SCOPE_ARM_TIMEOUT_MS  60000  // Armed scope capture gives up without a trigger
+#define BLACKBOX_DEPTH         512   // Control ticks of fault history (~18 s at 35 ms, ~2.5 s at 5 ms)
+#define BLACKBOX_POST           32   // Ticks kept after the fault before the record freezes
 
 // NTC thermistor parameters
 #define NTC_NOMINAL_RES      10000.0f // Nominal resistance at 25°C (ohms)
 #define NTC_BETA_COEFF       3470.0f  // Beta coefficient of thermistor
 #define NTC_SERIES_RESISTOR  3300.0f  // Series resistor value (ohms)
-#define NTC_NOMINAL_TEMP_C   25.0f   // Nominal temperature (°C)
\ No newline at end of file
+#define NTC_NOMINAL_TEMP_C   25.0f   // Nominal temperature (°C)
+#define NTC_ADC_CONTINUOUS       1   // 1 = continuous (DMA) ADC averaging, 0 = burst of one-shot reads
+#define NTC_OVERSAMPLE          64   // ADC conversions averaged per NTC reading (continuous mode)
+#define NTC_OVERSAMPLE_BURST     8   // One-shot reads averaged per tick (burst mode / fallback)
+#define NTC_SAMPLE_FREQ_HZ   20000   // Continuous ADC conversion rate (Hz)
+
+// Thermal model (junction estimate above the NTC, which sits by the XL6019E1)
+#define THERMAL_EFFICIENCY    0.88f  // Converter efficiency; loss = Pout (1/eff - 1)
+#define THERMAL_RDS_ON        0.05f  // IRLZ44N on-resistance at 3.3 V gate drive (ohms)
+#define THERMAL_RTH_C_W        5.0f  // Junction-to-NTC thermal resistance (°C/W)
+#define THERMAL_TAU_S          8.0f  // Junction-to-NTC thermal time constant (s)
+#define THERMAL_DERATE_SPAN_C 15.0f  // Derating starts this far below the trip point
+#define THERMAL_DERATE_MIN    0.10f  // Current/power scale at full derating
+
+// Control loop
+#ifndef PID_FIXED_POINT
+#define PID_FIXED_POINT        0     // 1 = Q16.16 fixed-point PID kernel, 0 = float
+#endif
+
+// Display
+#ifndef DISPLAY_DIFF_UPDATE
+#define DISPLAY_DIFF_UPDATE    1     // 1 = redraw on change and send only changed 8x8 tiles, 0 = full frame every redraw (config pages every loop pass)
+#endif
@@ -0,0 +1,195 @@
+#include "ControlTask.h"
+#include "Globals.h"
+#include "DcControl.h"
+#include "OutputControl.h"
+#include "ErrMgr.h"
+#include "Sequencer.h"
+#include "SensorSource.h"
+#include "TraceRecorder.h"
+#include "BlackBox.h"
+#include <esp_timer.h>
+
+namespace ControlTask {
+
+constexpr uint32_t TASK_STACK = 4096;   // Control task stack (bytes)
+constexpr UBaseType_t TASK_PRIORITY = 10; // Above loop() and AsyncTCP, below WiFi
+
+static uint32_t periodUs = DC_CONTROL_UPDATE_INTERVAL * 1000UL; // Tick period (us)
+
+static esp_timer_handle_t timer = nullptr; // Periodic timer
+static TaskHandle_t task = nullptr;        // Control task handle
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+static Stats stats;                  // Timing statistics
+static uint32_t lastStartUs = 0;     // Previous tick start (us)
+static bool haveLastStart = false;   // lastStartUs valid
+static uint32_t lastPollUs = 0;      // Last fallback tick from poll() (us)
+static uint32_t lastSampleSeq = 0;   // Last sensor frame consumed
+static uint32_t statSampleSeq = 0;   // Sequence of the last sample seen by recordSample()
+static uint32_t statSampleUs = 0;    // Its pick-up time (us)
+static bool haveLastSample = false;  // statSample* valid
+
+// Run the control and protection path once
+static void runTick() {
+  uint32_t start = micros();
+
+  // Publish the selected source's latest sample as one consistent set for this tick
+  SensorFrame frame;
+  bool fresh = SensorSource::active().read(frame) && frame.seq != lastSampleSeq;
+  // Trace frames carry recorded timestamps, so their age means nothing on this clock
+  if (!fresh || SensorSource::isHardware()) recordSample(fresh, start, frame.seq, frame.timestampUs);
+  if (fresh) {
+    lastSampleSeq = frame.seq;
+    labV_meas = frame.v;
+    labI_meas = frame.i;
+    labQ_meas = frame.p;
+  }
+  TraceRecorder::record(frame, fresh);
+
+  OutputControl::update(frame, fresh);
+  Sequencer::tick(fresh);
+  DcControl::tick(fresh);
+  ErrMgr::update();
+  BlackBox::tick(fresh);
+  record(start, micros());
+}
+
+// Timer callback: wake the control task
+static void onTimer(void*) {
+  if (task) xTaskNotifyGive(task);
+}
+
+// Control task body
+static void taskMain(void*) {
+  for (;;) {
+    uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (pending > 1) {
+      portENTER_CRITICAL(&statsMux);
+      stats.missed += pending - 1;
+      portEXIT_CRITICAL(&statsMux);
+    }
+    runTick();
+  }
+}
+
+void resetStats() {
+  portENTER_CRITICAL(&statsMux);
+  memset(&stats, 0, sizeof(stats));
+  stats.periodUs = periodUs;
+  stats.jitterMinUs = INT32_MAX;
+  stats.jitterMaxUs = INT32_MIN;
+  stats.sampleAgeMinUs = UINT32_MAX;
+  haveLastStart = false;
+  haveLastSample = false;
+  portEXIT_CRITICAL(&statsMux);
+}
+
+// Start periodic timer and control task
+void begin() {
+  resetStats();
+
+  if (xTaskCreate(taskMain, "control", TASK_STACK, nullptr, TASK_PRIORITY, &task) != pdPASS) {
+    task = nullptr;
+    return; // poll() keeps the loop running from loop()
+  }
+
+  const esp_timer_create_args_t args = {
+    .callback = onTimer,
+    .arg = nullptr,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name = "control",
+    .skip_unhandled_events = true
+  };
+  if (esp_timer_create(&args, &timer) != ESP_OK || esp_timer_start_periodic(timer, periodUs) != ESP_OK) {
+    vTaskDelete(task);
+    task = nullptr;
+  }
+}
+
+// Change the tick period; statistics restart so jitter is measured against the new period
+void setPeriod(uint32_t us) {
+  if (us == periodUs) return;
+  periodUs = us;
+  controlPeriodUs = us;
+  if (timer) {
+    esp_timer_stop(timer);
+    esp_timer_start_periodic(timer, periodUs);
+  }
+  resetStats();
+}
+
+// Fallback scheduling from loop() when the task could not be started
+void poll() {
+  if (task) return;
+  uint32_t now = micros();
+  if (now - lastPollUs < periodUs) return;
+  lastPollUs = now;
+  runTick();
+}
+
+bool isRunning() { return task != nullptr; }
+
+// A replayed trace starts from the state the board booted with, not from whatever ran before it
+void restartControlPath() {
+  lastSampleSeq = 0;
+  OutputControl::reset();
+  DcControl::reset();
+  ErrMgr::begin();
+}
+
+// Record period jitter, execution time and overruns for one tick
+void record(uint32_t startUs, uint32_t endUs) {
+  uint32_t execUs = endUs - startUs;
+  uint8_t bucket = 0;
+  while (bucket < EXEC_HIST_BUCKETS - 1 && execUs >= EXEC_HIST_EDGES_US[bucket]) bucket++;
+
+  portENTER_CRITICAL(&statsMux);
+  if (haveLastStart) {
+    int32_t jitter = (int32_t)(startUs - lastStartUs - periodUs);
+    if (jitter < stats.jitterMinUs) stats.jitterMinUs = jitter;
+    if (jitter > stats.jitterMaxUs) stats.jitterMaxUs = jitter;
+  }
+  lastStartUs = startUs;
+  haveLastStart = true;
+
+  stats.ticks++;
+  stats.execHist[bucket]++;
+  if (execUs > stats.execMaxUs) stats.execMaxUs = execUs;
+  if (execUs > periodUs) stats.overruns++;
+  portEXIT_CRITICAL(&statsMux);
+}
+
+// Count stale ticks and skipped samples, and track sample age at tick start and the pick-up gaps
+void recordSample(bool fresh, uint32_t startUs, uint32_t seq, uint32_t sampleUs) {
+  portENTER_CRITICAL(&statsMux);
+  if (!fresh) {
+    stats.staleTicks++;
+  } else {
+    uint32_t ageUs = startUs - sampleUs;
+    if (ageUs < stats.sampleAgeMinUs) stats.sampleAgeMinUs = ageUs;
+    if (ageUs > stats.sampleAgeMaxUs) stats.sampleAgeMaxUs = ageUs;
+    if (haveLastSample) {
+      // A gap is only known between consecutive samples; later ones replaced the rest unseen
+      if (seq - statSampleSeq == 1) {
+        if (sampleUs - statSampleUs > stats.sampleGapMaxUs) stats.sampleGapMaxUs = sampleUs - statSampleUs;
+      } else {
+        stats.skippedSamples += seq - statSampleSeq - 1;
+      }
+    }
+    statSampleSeq = seq;
+    statSampleUs = sampleUs;
+    haveLastSample = true;
+  }
+  portEXIT_CRITICAL(&statsMux);
+}
+
+void getStats(Stats& out) {
+  portENTER_CRITICAL(&statsMux);
+  out = stats;
+  portEXIT_CRITICAL(&statsMux);
+  if (out.jitterMinUs == INT32_MAX) out.jitterMinUs = 0;
+  if (out.jitterMaxUs == INT32_MIN) out.jitterMaxUs = 0;
+  if (out.sampleAgeMinUs == UINT32_MAX) out.sampleAgeMinUs = 0;
+}
+
+} // namespace ControlTask
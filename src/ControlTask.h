@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Timer-driven control task: runs OutputControl, DcControl and ErrMgr at a fixed period
+namespace ControlTask {
+
+constexpr uint8_t EXEC_HIST_BUCKETS = 8; // Execution-time histogram buckets
+
+// Upper bucket edges for execution time (us); the last bucket is open-ended
+constexpr uint32_t EXEC_HIST_EDGES_US[EXEC_HIST_BUCKETS - 1] = {100, 200, 500, 1000, 2000, 5000, 10000};
+
+// Scheduler timing statistics. INA226 pick-up runs in loop(), not in this task, so a stalled loop()
+// shows up as stale ticks and sample gaps rather than as period jitter.
+struct Stats {
+  uint32_t periodUs;                      // Nominal tick period (us)
+  uint32_t ticks;                         // Completed ticks
+  uint32_t overruns;                      // Ticks whose execution exceeded the period
+  uint32_t missed;                        // Timer events dropped while a tick was pending
+  int32_t jitterMinUs;                    // Min start-to-start deviation from period (us)
+  int32_t jitterMaxUs;                    // Max start-to-start deviation from period (us)
+  uint32_t execMaxUs;                     // Worst-case execution time (us)
+  uint32_t execHist[EXEC_HIST_BUCKETS];   // Execution time histogram
+  uint32_t staleTicks;                    // Ticks that found no new sensor sample
+  uint32_t sampleAgeMinUs;                // Min age of a fresh sample at tick start (us)
+  uint32_t sampleAgeMaxUs;                // Max age of a fresh sample at tick start (us)
+  uint32_t sampleGapMaxUs;                // Longest pick-up interval between consecutive samples (us)
+  uint32_t skippedSamples;                // Samples replaced before any tick consumed them
+};
+
+void begin();                  // Start periodic timer and control task
+void setPeriod(uint32_t us);   // Change the tick period (loop task)
+void poll();                   // Run ticks from loop() while the task is not running
+void restartControlPath();     // Protection, loops and latches back to their boot state (control task context)
+bool isRunning();              // Control task active
+void getStats(Stats& out);     // Copy current statistics
+void resetStats();             // Reset statistics
+
+// Scheduler bookkeeping for one tick; clock-agnostic so any time source can drive it
+void record(uint32_t startUs, uint32_t endUs);
+// Sample freshness for one tick: sequence number and pick-up time of the frame it read
+void recordSample(bool fresh, uint32_t startUs, uint32_t seq, uint32_t sampleUs);
+
+} // namespace ControlTask
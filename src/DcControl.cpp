@@ -2,27 +2,55 @@
 #include "DcControl.h"
 #include "Globals.h"
 #include "Config.h"
+#include "PidController.h"
+#include "GainSchedule.h"
+#include "AutoTune.h"
+#include "FeedForward.h"
+#include "Thermal.h"
+#include "ErrMgr.h"
 
 namespace DcControl {
 
 // Control parameters
-static float stepVset = 0.1f;         // Voltage ramp step
-static float stepIset = 0.01f;        // Current ramp step
 static float pwmDuty = 0.0f;          // PWM duty cycle
-static unsigned long lastUpdate = 0;  // Last update timestamp
 
-// PID CV parameters
-static float integralV = 0.0f;    // voltage integral
-static float prevErrorV = 0.0f;   // previous voltage error
-static float derivativeV = 0.0f;  // voltage derivative
+// Tick period the gains are tuned for (s); the actual period follows the INA226 profile
+static constexpr float dtNomSec = DC_CONTROL_UPDATE_INTERVAL / 1000.0f;
 
-// PID CC parameters
-static float integralI = 0.0f;    // current integral
-static float prevErrorI = 0.0f;   // previous current error
-static float derivativeI = 0.0f;  // current derivative
+// PID loop policies: numeric kernel selected at build time by PID_FIXED_POINT
+struct DcPidTraits {
+#if PID_FIXED_POINT
+  typedef PidQ16Math Math;
+#else
+  typedef PidFloatMath Math;
+#endif
+  static constexpr bool derivativeOnMeasurement = false;
+  static constexpr PidAntiWindup antiWindup = PidAntiWindup::ClampAndUnwind;
+  static constexpr bool clampOutput = false;
+};
+
+static PidController<DcPidTraits> pidV; // CV loop
+static PidController<DcPidTraits> pidI; // CC loop
 
 static float pidOutput = 0.0f;  // PID output (CV/CC)
 
+// Setpoint slew
+struct SlewAxis {
+  float rate = 0.0f;     // Current slew (units/ms)
+  bool active = false;   // Still moving toward target
+};
+static SlewAxis slewV;                    // Voltage setpoint
+static SlewAxis slewI;                    // Current setpoint
+static uint32_t lastSlewUs = 0;           // Last slew update
+constexpr float SLEW_SNAP_V = 0.001f;     // Exponential: finish within this (V)
+constexpr float SLEW_SNAP_I = 0.0001f;    // Exponential: finish within this (A)
+
+// Feed-forward learning
+constexpr uint32_t FF_SETTLE_US = 700000; // Settled time between learning steps (us)
+constexpr float FF_SETTLE_V = 0.01f;      // Max voltage error counted as settled (V)
+static float ffPrev = NAN;                // Feed-forward duty at last tick (NAN = off)
+static uint32_t settledUs = 0;            // Settled time since the last learning step (us)
+
 // PWM configuration
 const uint32_t pwmFreq = 9700;               // PWM frequency (Hz)
 const uint8_t pwmBits = 12;                  // PWM resolution (bits)
@@ -51,15 +79,15 @@ void updateDebugVars() {
 
   if (dbgMode == 2) {                                               // voltage PID debug
     debugVars[0] = pwmDuty;                                         // PID PWM output
-    debugVars[1] = integralV;                                       // voltage integral term
-    debugVars[2] = prevErrorV;                                      // previous voltage error
+    debugVars[1] = pidV.getIntegral();                          // voltage integral term
+    debugVars[2] = pidV.getPrevError();                         // previous voltage error
     debugVars[3] = (rmsCount > 0) ? sqrt(sumV2 / rmsCount) : 0.0f;  // RMS deviation
     debugVars[4] = maxDeltaV;                                       // peak deviation
-    debugVars[5] = derivativeV;                                     // derivative (rate of change)
+    debugVars[5] = pidV.getDerivative();                        // derivative (rate of change)
   } else if (dbgMode == 3) {                                        // current PID debug
     debugVars[0] = pwmDuty;                                         // PID PWM output
-    debugVars[1] = integralI;                                       // current integral term
-    debugVars[2] = prevErrorI;                                      // previous current error
+    debugVars[1] = pidI.getIntegral();                          // current integral term
+    debugVars[2] = pidI.getPrevError();                         // previous current error
     debugVars[3] = (rmsCount > 0) ? sqrt(sumI2 / rmsCount) : 0.0f;  // RMS deviation
     debugVars[4] = maxDeltaI;                                       // peak deviation
     //debugVars[5] = derivativeI;                                     // derivative
@@ -72,18 +100,85 @@ void updateDebugVars() {
   rmsCount = 0;
 }
 
+// Move value toward target by dtMs of the configured profile; maxRate in units/ms
+static void slew(SlewAxis& s, float& value, float target, float maxRate, float snap, float dtMs) {
+  float err = target - value;
+  if (err == 0.0f || maxRate <= 0.0f) {
+    value = target;
+    s.rate = 0.0f;
+    s.active = false;
+    return;
+  }
+  if (!(dtMs > 0.0f)) return;  // No time has passed (or a bad dt): hold value and rate
+
+  float step;
+  switch ((RampProfile)rampProfile) {
+    case RampProfile::SCurve: {
+      // Rate follows the braking curve sqrt(2*a*distance), changing by at most a*dt
+      float accel = maxRate / max(rampAccelMs, 1.0f);
+      float vMax = min(maxRate, sqrtf(2.0f * accel * fabsf(err)));
+      float dv = accel * dtMs;
+      s.rate = constrain(err > 0.0f ? vMax : -vMax, s.rate - dv, s.rate + dv);
+      step = s.rate * dtMs;
+      break;
+    }
+    case RampProfile::Exponential: {
+      float limit = maxRate * dtMs;
+      step = constrain(err * (1.0f - expf(-dtMs / max(rampTauMs, 1.0f))), -limit, limit);
+      if (fabsf(err) < snap) step = err;
+      s.rate = step / dtMs;
+      break;
+    }
+    default: {
+      float limit = maxRate * dtMs;
+      step = constrain(err, -limit, limit);
+      s.rate = step / dtMs;
+      break;
+    }
+  }
+
+  // Land exactly on target instead of overshooting
+  if (fabsf(step) >= fabsf(err) && step * err > 0.0f) {
+    value = target;
+    s.rate = 0.0f;
+    s.active = false;
+  } else {
+    value += step;
+    s.active = true;
+  }
+}
+
+// Write current duty to the feedback PWM pin
+static void writePwm() {
+  uint16_t pwmValue = invertPwmSignal ? pwmMax - (uint16_t)(pwmDuty / 100.0f * pwmMax)
+                                      : (uint16_t)(pwmDuty / 100.0f * pwmMax);
+  ledcWrite(DC_CONTROL_PIN, pwmValue);
+}
+
 void begin() {
   pinMode(DC_CONTROL_PIN, OUTPUT);
   if (!ledcAttach(DC_CONTROL_PIN, pwmFreq, pwmBits)) {
-    errorLedcInitFail = true;
+    ErrMgr::set(ErrMgr::LedcInitFail);
     return;
   }
   ledcOutputInvert(DC_CONTROL_PIN, invertPwmSignal);
+  reset();
+  writePwm();
+}
+
+void reset() {
+  pidV.reset();
+  pidI.reset();
+  pidOutput = 0.0f;
+  slewV = slewI = {};
   rampedVset = labV_set;
+  rampedIset = labI_set;
+  lastSlewUs = micros();
+  ffPrev = NAN;
+  settledUs = 0;
+  isCC = lastCC = false;
   pwmDuty = dutyMin;
-  uint16_t pwmValue = invertPwmSignal ? pwmMax - (uint16_t)(pwmDuty / 100.0f * pwmMax)
-                                      : (uint16_t)(pwmDuty / 100.0f * pwmMax);
-  ledcWrite(DC_CONTROL_PIN, pwmValue);
+  ErrMgr::assign((1UL << ErrMgr::PidDivergence) | (1UL << ErrMgr::PidCurrentDivergence), 0);
 }
 
 // void update() {
@@ -203,35 +298,32 @@ void begin() {
 //     ledcWrite(DC_CONTROL_PIN, pwmValue);
 // }
 
-void update() {
-  unsigned long now = millis();
-  if (now - lastUpdate < DC_CONTROL_UPDATE_INTERVAL) return;
-  lastUpdate = now;
-
-  // Smooth voltage setpoint adjustment
-  if (rampedVset < labV_set) {
-    rampedVset += stepVset;
-    if (rampedVset > labV_set) rampedVset = labV_set;
-  } else if (rampedVset > labV_set) {
-    rampedVset -= stepVset;
-    if (rampedVset < labV_set) rampedVset = labV_set;
-  }
-  
-  // Smooth current setpoint adjustment
-  if (rampedIset < labI_set) {
-    rampedIset += stepIset;
-    if (rampedIset > labI_set) rampedIset = labI_set;
-  } else if (rampedIset > labI_set) {
-    rampedIset -= stepIset;
-    if (rampedIset < labI_set) rampedIset = labI_set;
-  }
+// One control step (driven by ControlTask); all plant I/O goes through labV_meas/labI_meas and writePwm()
+void tick(bool freshSample) {
+  // Slew setpoints by real elapsed time (capped so a stall cannot jump the setpoint)
+  uint32_t nowUs = micros();
+  float dtMs = min((nowUs - lastSlewUs) / 1000.0f, 4.0f * DC_CONTROL_UPDATE_INTERVAL);
+  lastSlewUs = nowUs;
+  slew(slewV, rampedVset, labV_set, rampRateV, SLEW_SNAP_V, dtMs);
+  slew(slewI, rampedIset, Thermal::limitCurrent(labI_set), rampRateI, SLEW_SNAP_I, dtMs); // Thermal derating caps the limit
 
-  // Manual mode
-  if (!modeAuto) {
+  // Learned steady-state duty for the ramped setpoint
+  float ff = feedForwardEnabled ? FeedForward::lookup(rampedVset) : NAN;
+
+  if (AutoTune::isActive() && AutoTune::tick(pwmDuty, freshSample)) {
+    // Relay autotune owns the duty; loops restart from clean state afterwards
+    pwmDuty = constrain(pwmDuty, dutyMin, dutyMax);
+    pidV.reset();
+    pidI.reset();
+  } else if (!modeAuto) {
+    // Manual mode
     pwmDuty = dutyMax;
-    integralV = integralI = 0.0f;
-    errorPidDivergence = false;
-    errorPidCurrentDivergence = false;
+    pidV.resetIntegral();
+    pidI.resetIntegral();
+    ErrMgr::assign((1UL << ErrMgr::PidDivergence) | (1UL << ErrMgr::PidCurrentDivergence), 0);
+  } else if (!freshSample) {
+    // No new INA226 conversion since the last tick: hold the duty, keep following the feed-forward
+    if (!isCC && !isnan(ff) && !isnan(ffPrev)) pwmDuty = constrain(pwmDuty + ff - ffPrev, dutyMin, dutyMax);
   } else {
     // Calculate errors with deadband
     float errorV = rampedVset - labV_meas;
@@ -243,84 +335,80 @@ void update() {
     const float switchHyst = (labI_set < 0.1f) ? 0.002f : 0.02f * max(labI_set, 0.25f);
 
 
+    // Pick up gain changes from settings and the gain schedule (one multiplier per loop and gain)
+    GainSchedule::Scales gs = {{{1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}}};
+    if (gainScheduleEnabled) {
+      float loadOhms = (labI_meas > 0.005f) ? labV_meas / labI_meas : 1e6f;
+      GainSchedule::lookup(rampedVset, loadOhms, gs);
+      for (auto& loop : gs.k)
+        for (float& g : loop) g = roundf(g * 64.0f) / 64.0f; // quantized: gains rebuild only on a step
+    }
+    const float* gv = gs.k[GainSchedule::CV];
+    const float* gi = gs.k[GainSchedule::CC];
+
+    // The output is added to the duty every tick, so faster ticks scale gains and integral
+    // limit by dt/nominal to keep the per-second response. Slower ticks keep the per-tick
+    // gains: scaling up would push the sampled loop past its stability margin.
+    float dt = controlPeriodUs * 1e-6f;
+    float r = min(dt / dtNomSec, 1.0f);
+    pidV.configure(Kp * gv[GainSchedule::KP] * r, Ki * gv[GainSchedule::KI] * r, Kd * gv[GainSchedule::KD] * r,
+                   integralLimit * r, dt);
+    pidI.configure(Kp_I * gi[GainSchedule::KP] * r, Ki_I * gi[GainSchedule::KI] * r, Kd_I * gi[GainSchedule::KD] * r,
+                   integralLimit_I * r, dt);
+
     // Select mode (CV priority)
     if (labI_meas > rampedIset + switchHyst) {
       // CC mode
-      float proportionalI = Kp_I * errorI;
-      integralI += Ki_I * errorI * (DC_CONTROL_UPDATE_INTERVAL / 1000.0f);
-      integralI = constrain(integralI, -integralLimit_I, integralLimit_I);
-      derivativeI = Kd_I * (errorI - prevErrorI) / (DC_CONTROL_UPDATE_INTERVAL / 1000.0f);
-      prevErrorI = errorI;
-      pidOutput = proportionalI + integralI + derivativeI;
+      pidOutput = pidI.update(errorI);
       isCC = true;
-      integralV = 0.0f;  // Reset CV integral
+      pidV.resetIntegral();  // Reset CV integral
     } else if (labI_meas < rampedIset - switchHyst || labI_meas < 0.005f || labV_meas >= labV_set + 0.5f) {
       // CV mode (based on current or voltage)
-      float proportionalV = Kp * errorV;
-      integralV += Ki * errorV * (DC_CONTROL_UPDATE_INTERVAL / 1000.0f);
-      integralV = constrain(integralV, -integralLimit, integralLimit);
-      derivativeV = Kd * (errorV - prevErrorV) / (DC_CONTROL_UPDATE_INTERVAL / 1000.0f);
-      prevErrorV = errorV;
-      pidOutput = proportionalV + integralV + derivativeV;
+      pidOutput = pidV.update(errorV);
       isCC = false;
-      integralI = 0.0f;  // Reset CC integral
+      pidI.resetIntegral();  // Reset CC integral
     } else {
       // Hysteresis range: maintain current mode
-      if (isCC) {
-        float proportionalI = Kp_I * errorI;
-        integralI += Ki_I * errorI * (DC_CONTROL_UPDATE_INTERVAL / 1000.0f);
-        integralI = constrain(integralI, -integralLimit_I, integralLimit_I);
-        derivativeI = Kd_I * (errorI - prevErrorI) / (DC_CONTROL_UPDATE_INTERVAL / 1000.0f);
-        prevErrorI = errorI;
-        pidOutput = proportionalI + integralI + derivativeI;
-      } else {
-        float proportionalV = Kp * errorV;
-        integralV += Ki * errorV * (DC_CONTROL_UPDATE_INTERVAL / 1000.0f);
-        integralV = constrain(integralV, -integralLimit, integralLimit);
-        derivativeV = Kd * (errorV - prevErrorV) / (DC_CONTROL_UPDATE_INTERVAL / 1000.0f);
-        prevErrorV = errorV;
-        pidOutput = proportionalV + integralV + derivativeV;
-      }
+      pidOutput = isCC ? pidI.update(errorI) : pidV.update(errorV);
     }
 
     // Limit CC mode at high voltage
     if (isCC && labV_meas > labV_set * 1.05f) {
       pwmDuty = constrain(pwmDuty, dutyMin, (labV_set / systemVoutMax) * 100.0f);
-      integralI = 0.0f;
+      pidI.resetIntegral();
     }
 
     // Check PID divergence
-    errorPidDivergence = fabs(pidOutput) > 1.5f * dutyMax && !isCC;
-    errorPidCurrentDivergence = fabs(pidOutput) > 1.5f * dutyMax && isCC;
-    if (errorPidDivergence || errorPidCurrentDivergence) {
+    bool diverged = fabs(pidOutput) > 1.5f * dutyMax;
+    ErrMgr::assign(ErrMgr::PidDivergence, diverged && !isCC);
+    ErrMgr::assign(ErrMgr::PidCurrentDivergence, diverged && isCC);
+    if (diverged) {
       if (isCC) {
-        integralI *= 0.5f;
+        pidI.halveIntegral();
       } else {
-        integralV *= 0.5f;
+        pidV.halveIntegral();
       }
     }
 
-    // Incremental PWM adjustment
+    // Incremental PWM adjustment; in CV the feed-forward carries setpoint moves
+    if (!isCC && !isnan(ff) && !isnan(ffPrev)) pwmDuty += ff - ffPrev;
     pwmDuty += pidOutput;
     pwmDuty = constrain(pwmDuty, dutyMin, dutyMax);
 
-    // Anti-windup for CV and CC modes
-    if (isCC) {
-      // CC mode: Prevent integral windup for current control
-      if (pwmDuty >= dutyMax && errorI > 0) {
-        integralI = max(integralI - Ki_I * errorI * (DC_CONTROL_UPDATE_INTERVAL / 1000.0f), -integralLimit_I);
-      }
-      if (pwmDuty <= dutyMin && errorI < 0) {
-        integralI = min(integralI - Ki_I * errorI * (DC_CONTROL_UPDATE_INTERVAL / 1000.0f), integralLimit_I);
+    // Anti-windup for the active loop
+    if (isCC) pidI.unwind(pwmDuty >= dutyMax, pwmDuty <= dutyMin);
+    else pidV.unwind(pwmDuty >= dutyMax, pwmDuty <= dutyMin);
+
+    // Refine feed-forward while the voltage loop holds a steady setpoint
+    if (feedForwardEnabled && !isCC && outputActive && rampedVset == labV_set &&
+        fabs(errorV) < FF_SETTLE_V && pwmDuty > dutyMin && pwmDuty < dutyMax) {
+      settledUs += controlPeriodUs;
+      if (settledUs >= FF_SETTLE_US) {
+        FeedForward::learn(rampedVset, pwmDuty);
+        settledUs = 0;
       }
     } else {
-      // CV mode: Prevent integral windup for voltage control
-      if (pwmDuty >= dutyMax && errorV > 0) {
-        integralV = max(integralV - Ki * errorV * (DC_CONTROL_UPDATE_INTERVAL / 1000.0f), -integralLimit);
-      }
-      if (pwmDuty <= dutyMin && errorV < 0) {
-        integralV = min(integralV - Ki * errorV * (DC_CONTROL_UPDATE_INTERVAL / 1000.0f), integralLimit);
-      }
+      settledUs = 0;
     }
 
     // Peak and RMS analysis
@@ -336,10 +424,23 @@ void update() {
     if (dbgMode == 2 || dbgMode == 3) updateDebugVars();
   }
 
+  ffPrev = ff;
+
   // Update PWM output
-  uint16_t pwmValue = invertPwmSignal ? pwmMax - (uint16_t)(pwmDuty / 100.0f * pwmMax)
-                                      : (uint16_t)(pwmDuty / 100.0f * pwmMax);
-  ledcWrite(DC_CONTROL_PIN, pwmValue);
+  writePwm();
+}
+
+// Get current PWM duty (%)
+float getPwmDuty() { return pwmDuty; }
+
+void getIntegrals(float& v, float& i) {
+  v = pidV.getIntegral();
+  i = pidI.getIntegral();
+}
+
+// Get setpoint slew state
+RampState getRampState() {
+  return {rampedVset, rampedIset, slewV.rate, slewI.rate, slewV.active, slewI.active};
 }
 
 }  // namespace DcControl
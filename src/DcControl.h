@@ -1,9 +1,32 @@
 #pragma once
 
+#include <stdint.h>
+
 // DC control module for voltage and current regulation
 namespace DcControl {
 
+  // Setpoint slew profiles (rampProfile)
+  enum class RampProfile : uint8_t {
+    Linear,       // Constant rate
+    SCurve,       // Acceleration-limited start and stop
+    Exponential   // First-order approach, capped at the rate
+  };
+
+  // Setpoint slew state
+  struct RampState {
+    float vset;     // Ramped voltage setpoint (V)
+    float iset;     // Ramped current setpoint (A)
+    float vRate;    // Current voltage slew (V/ms)
+    float iRate;    // Current current slew (A/ms)
+    bool vActive;   // Voltage still ramping
+    bool iActive;   // Current still ramping
+  };
+
   void begin();  // Initialize DC control
-  void update(); // Update DC control loop
+  void reset();  // Loops, slew and feed-forward tracking back to their boot state (control task)
+  void tick(bool freshSample = true); // Run one control step (called by ControlTask every tick); PID only runs on a new sample
+  float getPwmDuty(); // Current PWM duty (%)
+  void getIntegrals(float& v, float& i); // PID integral terms (CV, CC)
+  RampState getRampState(); // Setpoint slew state
 
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "Globals.h"
 #include "EncoderManager.h"
 #include "ErrMgr.h"
+#include "Ina226Manager.h"
+#include "Energy.h"
 
 namespace DisplayManager {
 
@@ -16,6 +18,22 @@ float smoothI = labI_meas; // Smoothed current
 float smoothP = labQ_meas; // Smoothed power
 const float alphaDisplay = 0.4f; // Smoothing factor
 
+// Retained-mode transfer: the panel keeps what was last sent, only changed 8x8 tiles go over I2C
+constexpr int FRAME_BYTES = 128 * 64 / 8;
+constexpr uint32_t TILE_BYTES = 8;     // One tile column of one page
+constexpr uint32_t AREA_OVERHEAD = 5;  // I2C address, control byte, column/page commands per transfer
+constexpr uint32_t FULL_REFRESH_MS = 60000; // Resend the whole frame now and then in case the panel lost its RAM
+static uint32_t lastFullMs = 0;
+static uint8_t shown[FRAME_BYTES];     // Panel contents after the last transfer
+static bool shownValid = false;        // Panel contents unknown until the first full frame
+static bool dirty = true;              // Redraw requested by an event
+
+// Transfer counters, folded into per-second stats by update()
+static uint32_t bytesAcc = 0, fullBytesAcc = 0, busUsAcc = 0;
+static uint16_t framesAcc = 0, transfersAcc = 0;
+static uint32_t statsStart = 0;
+static Stats stats = {};
+
 // Format unit for display (V, mV, A, mA, W, mW)
 const char* formatUnit(float val, const char* type, bool forceFullUnit = false) {
   if (forceFullUnit) {
@@ -39,40 +57,57 @@ struct ErrorEntry {
 };
 
 static const ErrorEntry errorTable[] = {
-  { 1UL << 0, "Overheat" },           // tempFaultActive
-  { 1UL << 1, "Overcurrent" },        // errorOverCurrent
-  { 1UL << 2, "Fuse Blown" },         // errorFuseBlown
-  { 1UL << 3, "Sensor Fail" },        // errorSensorFail
-  { 1UL << 4, "INA226 Init Fail" },   // errorInaInitFail
-  { 1UL << 5, "WiFi Init Fail" },     // errorWifiInitFail
-  { 1UL << 6, "SSD1306 Init Fail" },  // errorSsd1306InitFail
-  { 1UL << 7, "PWM Init Fail" },      // errorPwmInitFail
-  { 1UL << 8, "Vout Over Limit" },    // errorVoutOverLimit
-  { 1UL << 9, "Over Power" },         // errorOverPower
-  { 1UL << 10, "Voltage Deviation" }, // errorVoltageDev
-  { 1UL << 11, "Current Deviation" },// errorCurrentOverLimit
-  { 1UL << 12, "Power Over Limit" },  // errorPowerOverLimit
-  { 1UL << 13, "LEDC Init Fail" },    // errorLedcInitFail
-  { 1UL << 14, "PID Divergence" },    // errorPidDivergence
-  { 1UL << 15, "Low Memory" },        // errorLowMemory
-  { 1UL << 16, "High CPU Temp" },     // errorHighCpuTemp
-  { 1UL << 17, "Current PID Div" }    // errorPidCurrentDivergence
+  { 1UL << ErrMgr::Overheat, "Overheat" },
+  { 1UL << ErrMgr::OverCurrent, "Overcurrent" },
+  { 1UL << ErrMgr::FuseBlown, "Fuse Blown" },
+  { 1UL << ErrMgr::SensorFail, "Sensor Fail" },
+  { 1UL << ErrMgr::InaInitFail, "INA226 Init Fail" },
+  { 1UL << ErrMgr::WifiInitFail, "WiFi Init Fail" },
+  { 1UL << ErrMgr::Ssd1306InitFail, "SSD1306 Init Fail" },
+  { 1UL << ErrMgr::PwmInitFail, "PWM Init Fail" },
+  { 1UL << ErrMgr::VoutOverLimit, "Vout Over Limit" },
+  { 1UL << ErrMgr::OverPower, "Over Power" },
+  { 1UL << ErrMgr::VoltageDev, "Voltage Deviation" },
+  { 1UL << ErrMgr::CurrentDev, "Current Deviation" },
+  { 1UL << ErrMgr::PowerOverLimit, "Power Over Limit" },
+  { 1UL << ErrMgr::LedcInitFail, "LEDC Init Fail" },
+  { 1UL << ErrMgr::PidDivergence, "PID Divergence" },
+  { 1UL << ErrMgr::LowMemory, "Low Memory" },
+  { 1UL << ErrMgr::HighCpuTemp, "High CPU Temp" },
+  { 1UL << ErrMgr::PidCurrentDivergence, "Current PID Div" },
+  { 1UL << ErrMgr::HwOverCurrent, "HW Overcurrent" },
+  { 1UL << ErrMgr::ShortCircuit, "Short Circuit" }
 };
 
 const int errorCount = sizeof(errorTable) / sizeof(errorTable[0]);
+static_assert(errorCount == ErrMgr::BIT_COUNT, "One text per error bit");
+
+static ErrMgr::Cursor errorCursor;  // Display's place in the error event stream
+static int activeErrors[errorCount]; // errorTable indices of latched errors
+static int activeCount = 0;
+static ErrMgr::Cursor redrawCursor; // Error events that trigger a redraw
+
+// Rebuild the latched error list when error events arrive
+static void refreshErrors() {
+  ErrMgr::Event ev;
+  bool changed = false;
+  while (ErrMgr::poll(errorCursor, ev)) changed = true;
+  if (!changed) return;
+
+  uint32_t code = ErrMgr::code();
+  activeCount = 0;
+  for (int i = 0; i < errorCount; i++) {
+    if (code & errorTable[i].mask) {
+      activeErrors[activeCount++] = i;
+    }
+  }
+}
 
 // Get cycling active error string
 String getActiveErrorString() {
   static uint32_t lastUpdate = 0;
   static int currentIndex = 0;
-  int activeErrors[errorCount];
-  int activeCount = 0;
-
-  for (int i = 0; i < errorCount; i++) {
-    if (errorCode & errorTable[i].mask) {
-      activeErrors[activeCount++] = i;
-    }
-  }
+  refreshErrors();
 
   if (activeCount == 0) {
     currentIndex = 0;
@@ -82,18 +117,65 @@ String getActiveErrorString() {
 
   if (millis() - lastUpdate >= 2000) {
     lastUpdate = millis();
-    currentIndex = (currentIndex + 1) % activeCount;
+    currentIndex = currentIndex + 1;
   }
+  currentIndex %= activeCount;
 
   return String(errorTable[activeErrors[currentIndex]].text);
 }
 
+// Send the frame buffer: each run of changed tiles in a page is one updateDisplayArea() call
+static void present() {
+  uint8_t* buf = display.getBufferPtr();
+  const uint8_t tw = display.getBufferTileWidth();
+  const uint8_t th = display.getBufferTileHeight();
+  const uint32_t fullBytes = tw * th * TILE_BYTES + th * AREA_OVERHEAD;
+  uint32_t bytes = 0;
+  uint32_t start = micros();
+
+  if (!DISPLAY_DIFF_UPDATE || !shownValid || millis() - lastFullMs >= FULL_REFRESH_MS) {
+    display.sendBuffer();
+    bytes = fullBytes;
+    shownValid = true;
+    lastFullMs = millis();
+  } else {
+    for (uint8_t ty = 0; ty < th; ty++) {
+      const uint8_t* row = buf + ty * tw * TILE_BYTES;
+      const uint8_t* old = shown + ty * tw * TILE_BYTES;
+      uint8_t tx = 0;
+      while (tx < tw) {
+        if (memcmp(row + tx * TILE_BYTES, old + tx * TILE_BYTES, TILE_BYTES) == 0) {
+          tx++;
+          continue;
+        }
+        uint8_t first = tx;
+        while (tx < tw && memcmp(row + tx * TILE_BYTES, old + tx * TILE_BYTES, TILE_BYTES) != 0) tx++;
+        display.updateDisplayArea(first, ty, tx - first, 1);
+        bytes += (tx - first) * TILE_BYTES + AREA_OVERHEAD;
+      }
+    }
+  }
+  memcpy(shown, buf, FRAME_BYTES);
+
+  framesAcc++;
+  fullBytesAcc += fullBytes;
+  if (bytes) {
+    transfersAcc++;
+    bytesAcc += bytes;
+    busUsAcc += micros() - start;
+  }
+}
+
+void invalidate() { dirty = true; }
+
+void getStats(Stats& out) { out = stats; }
+
 void begin() {
   display.begin();
   display.clearBuffer();
   display.setFont(u8g2_font_6x12_tf);
   display.drawStr(0, 12, "Booting...");
-  display.sendBuffer();
+  present();
   delay(1000);
 }
 
@@ -102,7 +184,7 @@ void debugPrint(const char* message, int line = 1) {
   display.clearBuffer();
   display.setFont(u8g2_font_6x12_tf);
   display.drawStr(0, 12 * line, message);
-  display.sendBuffer();
+  present();
   delay(2000); // Allow time to read
 }
 
@@ -131,7 +213,7 @@ void drawHeader() {
   x += paramWidth + 12;
 
   // Error status
-  if (errorCode != 0 && (millis() / 500) % 2) {
+  if (ErrMgr::code() != 0 && (millis() / 500) % 2) {
     display.drawStr(x, y, "ERROR");
     x += display.getStrWidth("ERROR") + 10;
   } else {
@@ -237,7 +319,28 @@ void updateMainScreen() {
     drawFooterStandard(labV_set, labI_set, labI_cut);
   }
 
-  display.sendBuffer();
+  present();
+}
+
+// Charge/energy screen: totals, run time and averages since the last reset
+void updateEnergyScreen() {
+  Energy::Totals t;
+  Energy::get(t);
+  display.clearBuffer();
+  drawHeader();
+  display.setFont(u8g2_font_6x12_tf);
+
+  char buf[24];
+  uint32_t s = (uint32_t)t.runtimeS;
+  snprintf(buf, sizeof(buf), "%9.4f Ah", t.chargeAh);
+  display.drawStr(2, 28, buf);
+  snprintf(buf, sizeof(buf), "%9.3f Wh", t.energyWh);
+  display.drawStr(2, 40, buf);
+  snprintf(buf, sizeof(buf), "T %lu:%02lu:%02lu", (unsigned long)(s / 3600), (unsigned long)(s / 60 % 60), (unsigned long)(s % 60));
+  display.drawStr(2, 52, buf);
+  snprintf(buf, sizeof(buf), "avg %.3fA %.2fW", t.iAvg, t.pAvg);
+  display.drawStr(2, 64, buf);
+  present();
 }
 
 // Draw button with inversion and cursor
@@ -271,11 +374,8 @@ void drawButton(int x, int y, int w, int h, const char* text,
 
 // Count active errors
 int activeErrorCount() {
-  int count = 0;
-  for (int i = 0; i < errorCount; i++) {
-    if (errorFlags[i]) count++;
-  }
-  return count;
+  refreshErrors();
+  return activeCount;
 }
 
 // Draw menu page
@@ -317,26 +417,62 @@ void drawMenuPage(int CurrentMenuIndex) {
     drawButton(halfWidth + 2, yBtn, halfWidth - 4, 12, page.label2, activeRight, (draftIndex == 1), editing);
   }
 
-  display.sendBuffer();
+  present();
+}
+
+// Fold the transfer counters into per-second stats
+static void updateStats(unsigned long now) {
+  uint32_t elapsed = now - statsStart;
+  if (elapsed < 1000) return;
+  float k = 1000.0f / elapsed;
+  stats.bytesPerSec = bytesAcc * k;
+  stats.fullBytesPerSec = fullBytesAcc * k;
+  stats.framesPerSec = framesAcc * k;
+  stats.transfersPerSec = transfersAcc * k;
+  stats.busMsPerSec = busUsAcc * k / 1000.0f;
+  bytesAcc = fullBytesAcc = busUsAcc = 0;
+  framesAcc = transfersAcc = 0;
+  statsStart = now;
 }
 
-// Display update handler
+// Display update handler: redraw on events and at the refresh interval for live values
 void update() {
+  if (Ina226Manager::captureBusy()) return; // Scope capture owns the I2C bus
+  static EncoderManager::ScreenState lastState = EncoderManager::ScreenState::MainIdle;
+  static int lastMenuIndex = -1;
   unsigned long now = millis();
   auto state = EncoderManager::getScreenState();
+  int menuIndex = EncoderManager::getCurrentMenuIndex();
+  updateStats(now);
 
+  ErrMgr::Event ev;
+  if (ErrMgr::poll(redrawCursor, ev)) {
+    while (ErrMgr::poll(redrawCursor, ev)) {}
+    dirty = true;
+  }
+  if (state != lastState || menuIndex != lastMenuIndex) dirty = true;
+  lastState = state;
+  lastMenuIndex = menuIndex;
+
+  bool due = now - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL;
   switch (state) {
     case EncoderManager::ScreenState::MainIdle:
     case EncoderManager::ScreenState::MainEditing:
-      if (now - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
+      if (due || (dirty && DISPLAY_DIFF_UPDATE)) {
         lastDisplayUpdate = now;
+        dirty = false;
         updateDisplaySmoothing();
-        updateMainScreen();
+        if (::energyScreen && state == EncoderManager::ScreenState::MainIdle) updateEnergyScreen();
+        else updateMainScreen();
       }
       break;
     case EncoderManager::ScreenState::ConfigIdle:
     case EncoderManager::ScreenState::ConfigEditing:
-      drawMenuPage(EncoderManager::getCurrentMenuIndex());
+      if (due || dirty || !DISPLAY_DIFF_UPDATE) {
+        lastDisplayUpdate = now;
+        dirty = false;
+        drawMenuPage(menuIndex);
+      }
       break;
   }
 }
@@ -11,6 +11,15 @@ namespace DisplayManager {
 // Display object
 extern U8G2_SSD1306_128X64_NONAME_F_HW_I2C display;
 
+// I2C transfer stats over the last second
+struct Stats {
+  uint32_t bytesPerSec;      // Bytes sent (tile data + addressing)
+  uint32_t fullBytesPerSec;  // Same redraws sent as full frames
+  uint16_t framesPerSec;     // Frames drawn
+  uint16_t transfersPerSec;  // Frames that changed at least one tile
+  float busMsPerSec;         // Time spent in transfers (ms per second)
+};
+
 // Smoothed display values
 extern float smoothV;         // Smoothed voltage
 extern float smoothI;         // Smoothed current
@@ -61,6 +70,7 @@ constexpr int FOOT_VAL_WIDTH_CELL2 = 3;    // Second cell value width (steps, cu
 void begin();                      // Initialize display
 void debugPrint(const char* message, int line);
 void updateMainScreen();           // Update main screen
+void updateEnergyScreen();         // Charge/energy counters screen
 void drawHeader();                 // Draw header with status
 void drawValueWithUnit(float val, int xVal, int yVal, int h, int w,
                        const char* type, int xUnit, int yUnit, int width,
@@ -72,6 +82,8 @@ inline void drawFooterActiveParam(float val, const char* name, const char* type)
   drawFooterActiveParam(val, name, 0, type); // Simplified footer for boolean params
 }
 void update();                     // Main display update
+void invalidate();                 // Redraw on the next update()
+void getStats(Stats& out);         // I2C transfer stats
 String getActiveErrorString();     // Get cycling active error string
 String decodeErrorString();        // Decode error string for display
 
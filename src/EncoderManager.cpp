@@ -3,6 +3,8 @@
 #include "Config.h"
 #include "ErrMgr.h"
 #include "DisplayManager.h"
+#include "AutoTune.h"
+#include "Energy.h"
 #include <RotaryEncoder.h>
 
 namespace EncoderManager {
@@ -101,7 +103,21 @@ MenuItem menuItems[] = {
    []() { return String("on Home screen"); },
    []() { return mainScreenVoltage; },
    [](bool val) { mainScreenVoltage = val; },
-   "Voltage", "Current"}
+   "Voltage", "Current"},
+  {"Energy Screen",
+   []() { Energy::Totals t; Energy::get(t); return String(t.chargeAh, 4) + " Ah " + String(t.energyWh, 3) + " Wh"; },
+   []() { Energy::Totals t; Energy::get(t); return String("Run ") + String(t.runtimeS / 3600.0f, 2) + " h"; },
+   []() { return energyScreen; },
+   [](bool val) { energyScreen = val; },
+   "ON", "OFF"},
+  {"PID Autotune",
+   []() { return String("Status: ") + AutoTune::getStatus(); },
+   []() { return AutoTune::getState() == AutoTune::State::Done
+                   ? String("Ku ") + String(AutoTune::getKu(), 1) + " Tu " + String(AutoTune::getTu(), 3) + "s"
+                   : String("Output ON, load set"); },
+   []() { return AutoTune::getLoop() == AutoTune::Loop::Voltage; },
+   [](bool val) { AutoTune::start(val ? AutoTune::Loop::Voltage : AutoTune::Loop::Current); },
+   "CV", "CC"}
 };
 const int menuCount = sizeof(menuItems) / sizeof(menuItems[0]);
 static int currentMenuIndex = 0;
@@ -221,6 +237,7 @@ void update() {
   int delta = encoder.getPosition() - encLastPos;
   encLastPos = encoder.getPosition();
   ButtonEvent btnEvt = pollButton();
+  if (delta != 0 || btnEvt != ButtonEvent::None) DisplayManager::invalidate();
 
   // Config menu handling
   if (currentState == ScreenState::ConfigIdle || currentState == ScreenState::ConfigEditing) {
@@ -233,7 +250,6 @@ void update() {
         if (page.boolValue) handleDraftRotation(delta > 0 ? 1 : -1);
         else handleConfigEncoder(delta);
       }
-      DisplayManager::drawMenuPage(currentMenuIndex);
       lastActivityTime = now;
     }
 
@@ -245,19 +261,16 @@ void update() {
           editingValue = true;
           if (page.boolValue) syncDraftWithPage();
         }
-        DisplayManager::drawMenuPage(currentMenuIndex);
       } else if (currentState == ScreenState::ConfigEditing) {
         if (page.setFunc && page.boolValue) confirmDraft();
         else confirmConfig();
         editingValue = false;
         currentState = ScreenState::ConfigIdle;
-        DisplayManager::drawMenuPage(currentMenuIndex);
       }
       lastActivityTime = now;
     } else if (btnEvt == ButtonEvent::Long) {
       editingValue = false;
       currentState = ScreenState::MainIdle;
-      DisplayManager::drawMenuPage(currentMenuIndex);
     }
 
     if (currentState == ScreenState::ConfigEditing && now - lastActivityTime > IDLE_TIMEOUT_MS) {
@@ -266,7 +279,6 @@ void update() {
       else confirmConfig();
       editingValue = false;
       currentState = ScreenState::ConfigIdle;
-      DisplayManager::drawMenuPage(currentMenuIndex);
     }
     return;
   }
@@ -305,7 +317,6 @@ void update() {
     } else if (currentState == ScreenState::MainIdle) {
       cancelEdit();
       currentState = ScreenState::ConfigIdle;
-      DisplayManager::drawMenuPage(currentMenuIndex);
     }
     lastActivityTime = now;
   }
@@ -0,0 +1,98 @@
+#include "Energy.h"
+
+namespace Energy {
+
+constexpr uint32_t MAX_GAP_US = 1000000; // Longer sample gaps (sensor stall) are not integrated
+
+// Kahan-compensated float sum: keeps long runs of tiny increments from being rounded away
+// (relies on strict float ordering; do not build with -ffast-math)
+struct KahanSum {
+  float sum;
+  float comp;
+  void add(float x) {
+    float y = x - comp;
+    float t = sum + y;
+    comp = (t - sum) - y;
+    sum = t;
+  }
+};
+
+// Accumulator state (sensor side)
+struct State {
+  KahanSum charge;    // Integral of I (A*s)
+  KahanSum energy;    // Integral of P (W*s)
+  KahanSum vTime;     // Integral of V (V*s)
+  KahanSum time;      // Integrated time (s)
+  float vMin, vMax, iMin, iMax, pMin, pMax;
+  float vPrev, iPrev, pPrev;
+  uint32_t prevUs;
+  uint32_t samples;
+};
+
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+static State state = {};
+static volatile bool resetPending = false;
+
+void add(uint32_t timestampUs, float v, float i, float p) {
+  if (resetPending) {
+    resetPending = false;
+    portENTER_CRITICAL(&mux);
+    state = {};
+    portEXIT_CRITICAL(&mux);
+  }
+
+  portENTER_CRITICAL(&mux);
+  if (state.samples == 0) {
+    state.vMin = state.vMax = v;
+    state.iMin = state.iMax = i;
+    state.pMin = state.pMax = p;
+  } else {
+    // Trapezoidal step between consecutive conversions
+    uint32_t dtUs = timestampUs - state.prevUs;
+    if (dtUs <= MAX_GAP_US) {
+      float dt = dtUs * 1e-6f;
+      state.charge.add(0.5f * (i + state.iPrev) * dt);
+      state.energy.add(0.5f * (p + state.pPrev) * dt);
+      state.vTime.add(0.5f * (v + state.vPrev) * dt);
+      state.time.add(dt);
+    }
+    state.vMin = min(state.vMin, v);
+    state.vMax = max(state.vMax, v);
+    state.iMin = min(state.iMin, i);
+    state.iMax = max(state.iMax, i);
+    state.pMin = min(state.pMin, p);
+    state.pMax = max(state.pMax, p);
+  }
+  state.vPrev = v;
+  state.iPrev = i;
+  state.pPrev = p;
+  state.prevUs = timestampUs;
+  state.samples++;
+  portEXIT_CRITICAL(&mux);
+}
+
+void reset() { resetPending = true; }
+
+void get(Totals& out) {
+  portENTER_CRITICAL(&mux);
+  State s = state;
+  portEXIT_CRITICAL(&mux);
+
+  if (resetPending) s = {};
+  float t = s.time.sum;
+  out.chargeAh = s.charge.sum / 3600.0f;
+  out.energyWh = s.energy.sum / 3600.0f;
+  out.runtimeS = t;
+  out.vMin = s.vMin;
+  out.vMax = s.vMax;
+  out.iMin = s.iMin;
+  out.iMax = s.iMax;
+  out.pMin = s.pMin;
+  out.pMax = s.pMax;
+  out.vAvg = t > 0.0f ? s.vTime.sum / t : s.vPrev;
+  out.iAvg = t > 0.0f ? s.charge.sum / t : s.iPrev;
+  out.pAvg = t > 0.0f ? s.energy.sum / t : s.pPrev;
+  out.samples = s.samples;
+}
+
+} // namespace Energy
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Charge and energy accumulators fed by every INA226 conversion
+namespace Energy {
+
+// Totals since the last reset
+struct Totals {
+  float chargeAh;     // Accumulated charge (Ah)
+  float energyWh;     // Accumulated energy (Wh)
+  float runtimeS;     // Integrated time (s)
+  float vMin, vAvg, vMax; // Voltage (V), time-weighted average
+  float iMin, iAvg, iMax; // Current (A)
+  float pMin, pAvg, pMax; // Power (W)
+  uint32_t samples;   // Conversions accumulated
+};
+
+void add(uint32_t timestampUs, float v, float i, float p); // One conversion (sensor side)
+void reset();              // Clear totals; applied with the next conversion
+void get(Totals& out);     // Consistent copy of the totals
+
+} // namespace Energy
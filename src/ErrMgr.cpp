@@ -1,40 +1,115 @@
 #include "ErrMgr.h"
 #include "Globals.h"
-#include <Arduino.h>
+#include <atomic>
 
 namespace ErrMgr {
 
-static unsigned long lastUpdate = 0;
-uint32_t code = 0;
+static_assert(BIT_COUNT <= 32, "Error bits fit one word");
+static_assert((EVENT_DEPTH & (EVENT_DEPTH - 1)) == 0, "Event ring indexes by mask");
 
-// Initialize error manager
-void begin() {
-  lastUpdate = millis();
+// Event ring slot; seq holds the event's sequence + 1 once published, 0 while it is written. The event
+// fields are atomics too, so a reader racing a writer reads torn values (caught by the seq check), never
+// undefined behaviour.
+struct Slot {
+  std::atomic<uint32_t> seq;
+  std::atomic<uint32_t> tUs, active, code;
+  std::atomic<uint8_t> bit;
+  std::atomic<bool> rising;
+};
+
+static std::atomic<uint32_t> activeBits{0};  // Raised bits
+static std::atomic<uint32_t> latchedBits{0}; // Raised since the last manual enable
+static std::atomic<uint32_t> head{0};        // Sequence of the next event
+static Slot ring[EVENT_DEPTH];
+
+// Publish one event; any task may call this, readers never block it
+static void push(uint8_t bit, bool rising, uint32_t activeAfter) {
+  uint32_t seq = head.fetch_add(1, std::memory_order_relaxed);
+  Slot& s = ring[seq & (EVENT_DEPTH - 1)];
+  s.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  s.tUs.store((uint32_t)micros(), std::memory_order_relaxed);
+  s.active.store(activeAfter, std::memory_order_relaxed);
+  s.code.store(latchedBits.load(std::memory_order_relaxed) | activeAfter, std::memory_order_relaxed);
+  s.bit.store(bit, std::memory_order_relaxed);
+  s.rising.store(rising, std::memory_order_relaxed);
+  s.seq.store(seq + 1, std::memory_order_release);
 }
 
-void clear() {
-  code = 0;       
-  errorCode = 0;  
+void begin() {
+  latchedBits.store(activeBits.load());
 }
 
-// Update error flags and code
+// Clear the latch on the manual enable rising edge (called by ControlTask every tick)
 void update() {
-  unsigned long now = millis();
-  if (now - lastUpdate < DC_CONTROL_UPDATE_INTERVAL) return;
-  lastUpdate = now;
-
   static bool lastManualEnable = false;
   if (manualOutputEnable && !lastManualEnable) {
-    clear();
+    latchedBits.store(activeBits.load());
+    push(LATCH_CLEAR, false, activeBits.load(std::memory_order_relaxed));
   }
   lastManualEnable = manualOutputEnable;
+}
+
+void assign(uint32_t mask, uint32_t bits) {
+  bits &= mask;
+  uint32_t prev = activeBits.load(std::memory_order_relaxed);
+  uint32_t next;
+  do {
+    next = (prev & ~mask) | bits;
+    if (next == prev) return;  // Nothing changes: no store, no events
+  } while (!activeBits.compare_exchange_weak(prev, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+  latchedBits.fetch_or(bits, std::memory_order_relaxed);
+  for (uint32_t m = prev ^ next; m; m &= m - 1) {
+    uint8_t b = __builtin_ctz(m);
+    push(b, (next >> b) & 1, next);
+  }
+}
+
+void set(Bit bit) { assign(1UL << bit, 1UL << bit); }
+void clear(Bit bit) { assign(1UL << bit, 0); }
+void assign(Bit bit, bool on) { assign(1UL << bit, on ? 1UL << bit : 0); }
+bool isActive(Bit bit) { return (activeBits.load(std::memory_order_relaxed) >> bit) & 1; }
+uint32_t active() { return activeBits.load(std::memory_order_relaxed); }
+uint32_t code() { return latchedBits.load(std::memory_order_relaxed) | activeBits.load(std::memory_order_relaxed); }
+
+Cursor subscribe() {
+  Cursor c;
+  c.next = head.load(std::memory_order_acquire);
+  return c;
+}
 
-  for (uint8_t i = 0; i < MAX_ERRORS; i++) {
-    if (errorFlags[i] && *errorFlags[i]) {
-      code |= (1UL << i);
+bool poll(Cursor& c, Event& out) {
+  for (;;) {
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (c.next == h) return false;
+    if (h - c.next > EVENT_DEPTH) {  // Reader fell behind: skip to the oldest event still held
+      c.lost += h - c.next - EVENT_DEPTH;
+      c.next = h - EVENT_DEPTH;
     }
+    Slot& s = ring[c.next & (EVENT_DEPTH - 1)];
+    uint32_t seq = s.seq.load(std::memory_order_acquire);
+    if (seq != c.next + 1) {
+      if (seq == 0 || (int32_t)(seq - (c.next + 1)) < 0) return false;  // Still being written
+      continue;                                                         // Overwritten
+    }
+    Event ev = {s.tUs.load(std::memory_order_relaxed), s.active.load(std::memory_order_relaxed),
+                s.code.load(std::memory_order_relaxed), s.bit.load(std::memory_order_relaxed),
+                s.rising.load(std::memory_order_relaxed)};
+    std::atomic_thread_fence(std::memory_order_acquire);  // Copy above completes before the re-check below
+    if (s.seq.load(std::memory_order_relaxed) != seq) continue;          // Overwritten during the copy
+    out = ev;
+    c.next++;
+    return true;
+  }
+}
+
+uint32_t pollRising(Cursor& c) {
+  uint32_t rose = 0;
+  Event ev;
+  while (poll(c, ev)) {
+    if (ev.rising) rose |= 1UL << ev.bit;
   }
-  errorCode = code;
+  return rose;
 }
 
-}  // namespace ErrMgr
+} // namespace ErrMgr
@@ -1,8 +1,64 @@
 #pragma once
 
+#include <Arduino.h>
+
+// Error state: one atomic word of raised bits, a latched copy, and an event stream of the edges
 namespace ErrMgr {
 
-void begin(); // Initialize error manager
-void update(); // Update error flags and code
+// Error bits (bit number in the error code)
+enum Bit : uint8_t {
+  Overheat,             // Junction estimate over the limit
+  OverCurrent,          // Current over the system limit
+  FuseBlown,            // I²t fuse
+  SensorFail,           // NTC reading implausible
+  InaInitFail,          // INA226 initialization failure
+  WifiInitFail,         // WiFi initialization failure
+  Ssd1306InitFail,      // SSD1306 initialization failure
+  PwmInitFail,          // PWM initialization failure
+  VoutOverLimit,        // Output voltage out of range
+  OverPower,            // Output power over the limit
+  VoltageDev,           // Voltage deviation
+  CurrentDev,           // Current deviation
+  PowerOverLimit,       // Power over limit
+  LedcInitFail,         // LEDC initialization failure
+  PidDivergence,        // Voltage PID divergence
+  LowMemory,            // Low memory
+  HighCpuTemp,          // High CPU temperature
+  PidCurrentDivergence, // Current PID divergence
+  HwOverCurrent,        // INA226 ALERT overcurrent trip
+  ShortCircuit,         // dI/dt short-circuit predictor trip
+  BIT_COUNT
+};
+
+constexpr uint8_t LATCH_CLEAR = 0xFF;  // Event bit: latch cleared by a manual enable
+constexpr uint8_t EVENT_DEPTH = 32;    // Events kept for readers (power of two)
+
+// One edge of one error bit
+struct Event {
+  uint32_t tUs;          // micros() at the change
+  uint32_t active;       // Raised bits after the change
+  uint32_t code;         // Latched bits after the change
+  uint8_t bit;           // Bit that changed, or LATCH_CLEAR
+  bool rising;           // Raised (true) or cleared
+};
+
+// Read position of one consumer; every consumer sees every event
+struct Cursor {
+  uint32_t next = 0;     // Sequence of the next event to read
+  uint32_t lost = 0;     // Events overwritten before this reader got to them
+};
+
+void begin();                        // Latch only what is raised now
+void update();                       // Control tick: clear the latch on a manual enable
+void set(Bit bit);                   // Raise a bit (rising event if it was clear)
+void clear(Bit bit);                 // Clear a bit (falling event if it was set)
+void assign(Bit bit, bool on);       // set() or clear()
+void assign(uint32_t mask, uint32_t bits); // Write the bits in mask at once
+bool isActive(Bit bit);
+uint32_t active();                   // Bits raised now
+uint32_t code();                     // Bits raised since the last manual enable (includes active())
+Cursor subscribe();                  // Cursor that starts after the newest event
+bool poll(Cursor& c, Event& out);    // Next event for this reader; false when caught up
+uint32_t pollRising(Cursor& c);      // Drain the reader; bits that rose meanwhile
 
-} // namespace ErrMgr
\ No newline at end of file
+} // namespace ErrMgr
@@ -0,0 +1,77 @@
+#include "FeedForward.h"
+#include "Globals.h"
+
+namespace FeedForward {
+
+constexpr float BIN_INV = (V_POINTS - 1) / V_SPAN; // Breakpoints per volt
+constexpr uint16_t DUTY_MAX = 10000;               // 100 % in table units
+constexpr float LEARN_RATE = 0.125f;               // Fraction of the residual learned per call
+
+static Table table = defaultTable();               // Current table
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED; // Guards table and edits
+static uint32_t edits = 0;                         // setTable() calls
+
+Table defaultTable() {
+  Table t;
+  for (uint8_t i = 0; i < V_POINTS; i++) {
+    float duty = (i * V_SPAN / (V_POINTS - 1)) / systemVoutMax * 100.0f;
+    t.duty[i] = (uint16_t)(constrain(duty, 0.0f, 100.0f) * 100.0f + 0.5f);
+  }
+  return t;
+}
+
+bool setTable(const Table& t) {
+  for (uint8_t i = 0; i < V_POINTS; i++) if (t.duty[i] > DUTY_MAX) return false;
+  portENTER_CRITICAL(&mux);
+  table = t;
+  edits++;
+  portEXIT_CRITICAL(&mux);
+  return true;
+}
+
+void getTable(Table& out) {
+  portENTER_CRITICAL(&mux);
+  out = table;
+  portEXIT_CRITICAL(&mux);
+}
+
+uint32_t getEdits() {
+  portENTER_CRITICAL(&mux);
+  uint32_t n = edits;
+  portEXIT_CRITICAL(&mux);
+  return n;
+}
+
+// Breakpoint index and fraction for vset
+static uint8_t locate(float vset, float& frac) {
+  float x = vset * BIN_INV;
+  if (x <= 0.0f) { frac = 0.0f; return 0; }
+  if (x >= V_POINTS - 1) { frac = 1.0f; return V_POINTS - 2; }
+  uint8_t i = (uint8_t)x;
+  frac = x - i;
+  return i;
+}
+
+float lookup(float vset) {
+  float f;
+  uint8_t i = locate(vset, f);
+  portENTER_CRITICAL(&mux);
+  float lo = table.duty[i], hi = table.duty[i + 1];
+  portEXIT_CRITICAL(&mux);
+  return (lo + (hi - lo) * f) * 0.01f;
+}
+
+// Split the residual between the two breakpoints by their interpolation weight.
+// Table entries are whole 0.01 % steps, so learning stops once converged.
+void learn(float vset, float duty) {
+  float f;
+  uint8_t i = locate(vset, f);
+  portENTER_CRITICAL(&mux);
+  float lo = table.duty[i], hi = table.duty[i + 1];
+  float residual = (duty - (lo + (hi - lo) * f) * 0.01f) * 100.0f * LEARN_RATE;
+  table.duty[i] = (uint16_t)constrain(lroundf(lo + residual * (1.0f - f)), 0L, (long)DUTY_MAX);
+  table.duty[i + 1] = (uint16_t)constrain(lroundf(hi + residual * f), 0L, (long)DUTY_MAX);
+  portEXIT_CRITICAL(&mux);
+}
+
+} // namespace FeedForward
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Learned feed-forward map from voltage setpoint to steady-state PWM duty
+namespace FeedForward {
+
+constexpr uint8_t V_POINTS = 33;   // Breakpoints from 0 V to V_SPAN
+constexpr float V_SPAN = 40.0f;    // Voltage covered by the table (V)
+
+// Persisted table
+struct Table {
+  uint16_t duty[V_POINTS];         // Steady-state duty at each breakpoint (0.01 %)
+};
+
+// The control task learns into the table while the web and loop tasks replace or save it, so every
+// access goes through one spinlock; readers get a copy
+Table defaultTable();              // Seeded from the ideal ratio Vset / Vout max
+bool setTable(const Table& table); // Validate and store
+void getTable(Table& out);         // Copy of the current table
+uint32_t getEdits();               // setTable() calls so far (learning does not count)
+float lookup(float vset);          // Interpolated duty (%)
+void learn(float vset, float duty); // Move the breakpoints around vset toward a settled duty
+
+} // namespace FeedForward
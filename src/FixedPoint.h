@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+// Q16.16 fixed-point helpers for the control loop (ESP32-S2 has no FPU)
+typedef int32_t q16_t;
+
+constexpr int Q16_SHIFT = 16;                 // Fractional bits
+constexpr q16_t Q16_ONE = (q16_t)1 << Q16_SHIFT; // 1.0 in Q16.16
+constexpr q16_t Q16_MAX = INT32_MAX;          // Largest representable value
+constexpr q16_t Q16_MIN = INT32_MIN;          // Smallest representable value
+
+// Saturate a wide intermediate to Q16.16 range
+inline q16_t q16Sat(int64_t v) {
+  if (v > Q16_MAX) return Q16_MAX;
+  if (v < Q16_MIN) return Q16_MIN;
+  return (q16_t)v;
+}
+
+// Convert float to Q16.16 (rounded, saturated)
+inline q16_t toQ16(float v) {
+  float scaled = v * (float)Q16_ONE;
+  if (scaled >= 2147483647.0f) return Q16_MAX;
+  if (scaled <= -2147483648.0f) return Q16_MIN;
+  return (q16_t)(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+}
+
+// Convert Q16.16 to float
+inline float fromQ16(q16_t v) { return (float)v * (1.0f / (float)Q16_ONE); }
+
+// Saturating Q16.16 add
+inline q16_t q16Add(q16_t a, q16_t b) { return q16Sat((int64_t)a + b); }
+
+// Saturating Q16.16 negate (-Q16_MIN is not representable)
+inline q16_t q16Neg(q16_t v) { return v == Q16_MIN ? Q16_MAX : -v; }
+
+// Saturating Q16.16 multiply, rounded to nearest (truncation biases integrals downward)
+inline q16_t q16Mul(q16_t a, q16_t b) { return q16Sat(((int64_t)a * b + (1 << (Q16_SHIFT - 1))) >> Q16_SHIFT); }
+
+// Clamp Q16.16 value to [lo, hi]
+inline q16_t q16Clamp(q16_t v, q16_t lo, q16_t hi) { return v < lo ? lo : (v > hi ? hi : v); }
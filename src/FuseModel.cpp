@@ -0,0 +1,49 @@
+#include "FuseModel.h"
+#include <math.h>
+
+namespace FuseModel {
+
+static constexpr CurveParams PRESETS[] = {
+  {0.05f, 3.0f},   // Fast: 2x opens in ~14 ms, 1.1x in ~90 ms
+  {1.0f, 10.0f},   // Slow: 5x inrush passes for ~40 ms, 2x opens in ~290 ms
+};
+
+CurveParams params(Curve curve, float customTauS, float customPeak) {
+  if (curve < Curve::Custom) return PRESETS[(uint8_t)curve];
+  CurveParams c;
+  c.tauS = customTauS < 0.005f ? 0.005f : (customTauS > 60.0f ? 60.0f : customTauS);
+  c.peak = customPeak < 1.5f ? 1.5f : (customPeak > 20.0f ? 20.0f : customPeak);
+  return c;
+}
+
+float tripTime(float k, const CurveParams& c) {
+  if (k >= c.peak) return 0.0f;
+  float k2 = k * k;
+  if (k2 <= 1.0f) return -1.0f;
+  return c.tauS * logf(k2 / (k2 - 1.0f));
+}
+
+void Fuse::reset() {
+  heat = 0.0f;
+  blown = false;
+}
+
+bool Fuse::step(float current, float rated, float dtS, const CurveParams& c) {
+  if (rated <= 0.0f || isnan(current)) return blown;
+  float k = fabsf(current) / rated;
+  if (k >= c.peak) {
+    heat = 1.0f;
+    blown = true;
+    return true;
+  }
+  // Exact decay factor 1 - e^-x replaced by its (1,1) Padé form: no exp per sample, stable for any dt
+  float x = dtS / c.tauS;
+  float alpha = x / (1.0f + 0.5f * x);
+  if (alpha > 1.0f) alpha = 1.0f;
+  heat += (k * k - heat) * alpha;
+  if (heat >= 1.0f) blown = true;
+  else if (blown && heat < RESET_HEAT) blown = false;
+  return blown;
+}
+
+} // namespace FuseModel
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+
+// I²t electronic fuse: first-order heating by (I / Irated)^2, opens when the heat reaches 1.
+// Plain C++ with no Arduino dependencies, so it builds on the host for curve tests.
+namespace FuseModel {
+
+enum class Curve : uint8_t { Fast, Slow, Custom, Count };
+
+constexpr float RESET_HEAT = 0.5f;   // A blown fuse closes again once cooled below this
+
+// Blow curve; below the peak multiple k = I / Irated opens after tau * ln(k^2 / (k^2 - 1))
+struct CurveParams {
+  float tauS;    // Thermal time constant (s)
+  float peak;    // Current multiple that opens the fuse at once
+};
+
+// Parameters of a curve; Custom takes the given values, clamped to a sane range
+CurveParams params(Curve curve, float customTauS, float customPeak);
+
+// Analytic time to open from cold at a constant multiple (s); 0 at or above peak, negative = never
+float tripTime(float k, const CurveParams& c);
+
+// One fuse; a single float of state, stepped once per sample in constant time
+class Fuse {
+public:
+  void reset();
+  // Integrate one sample: current (A), rating (A), time since the previous sample (s)
+  bool step(float current, float rated, float dtS, const CurveParams& c);
+  float getHeat() const { return heat; }   // 0 cold, 1 opens
+  bool isBlown() const { return blown; }
+
+private:
+  float heat = 0.0f;
+  bool blown = false;
+};
+
+} // namespace FuseModel
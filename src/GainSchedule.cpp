@@ -0,0 +1,109 @@
+#include "GainSchedule.h"
+
+namespace GainSchedule {
+
+constexpr float SCALE_MIN = 0.05f; // Lowest allowed multiplier
+constexpr float SCALE_MAX = 10.0f; // Highest allowed multiplier
+
+// Precomputed lookup: table interpolated along V into uniform bins; each bin holds all six
+// multipliers together so a tick reads two adjacent blocks
+struct Lut {
+  float v0;                          // First voltage breakpoint (V)
+  float vBinInv;                     // Bins per volt
+  float r[R_POINTS];                 // Resistance breakpoints (ohm)
+  float rSpanInv[R_POINTS - 1];      // 1 / (r[j+1] - r[j])
+  Scales bins[R_POINTS][V_BINS];     // Multipliers per resistance breakpoint and voltage bin
+};
+
+static Table table = defaultTable();       // Current table
+static Lut luts[2];                        // Double buffer, swapped on setTable()
+static Lut* volatile active = nullptr;     // LUT used by lookup()
+static uint8_t rSegment = 0;               // Cached resistance segment
+
+Table defaultTable() {
+  Table t = {
+    {1.5f, 5.0f, 12.0f, 36.0f},
+    {1.0f, 10.0f, 100.0f},
+    {}
+  };
+  for (uint8_t l = 0; l < LOOPS; l++)
+    for (uint8_t g = 0; g < GAINS; g++)
+      for (uint8_t j = 0; j < R_POINTS; j++)
+        for (uint8_t i = 0; i < V_POINTS; i++) t.scale[l][g][j][i] = 1.0f;
+  return t;
+}
+
+// Linear interpolation of one grid row at voltage v
+static float interpolateRow(const Table& t, const float* row, float v) {
+  if (v <= t.vPoints[0]) return row[0];
+  for (uint8_t i = 1; i < V_POINTS; i++) {
+    if (v <= t.vPoints[i]) {
+      float f = (v - t.vPoints[i - 1]) / (t.vPoints[i] - t.vPoints[i - 1]);
+      return row[i - 1] + (row[i] - row[i - 1]) * f;
+    }
+  }
+  return row[V_POINTS - 1];
+}
+
+// Validate, store and precompute lookup
+bool setTable(const Table& t) {
+  for (uint8_t i = 1; i < V_POINTS; i++) if (!(t.vPoints[i] > t.vPoints[i - 1])) return false;
+  for (uint8_t j = 1; j < R_POINTS; j++) if (!(t.rPoints[j] > t.rPoints[j - 1])) return false;
+  if (!(t.rPoints[0] > 0.0f)) return false;
+
+  table = t;
+  for (uint8_t l = 0; l < LOOPS; l++)
+    for (uint8_t g = 0; g < GAINS; g++)
+      for (uint8_t j = 0; j < R_POINTS; j++)
+        for (uint8_t i = 0; i < V_POINTS; i++)
+          table.scale[l][g][j][i] = constrain(table.scale[l][g][j][i], SCALE_MIN, SCALE_MAX);
+
+  // Build into the buffer lookup() is not using, then swap
+  Lut* next = (active == &luts[0]) ? &luts[1] : &luts[0];
+  float span = table.vPoints[V_POINTS - 1] - table.vPoints[0];
+  next->v0 = table.vPoints[0];
+  next->vBinInv = (V_BINS - 1) / span;
+  for (uint8_t j = 0; j < R_POINTS; j++) {
+    next->r[j] = table.rPoints[j];
+    if (j < R_POINTS - 1) next->rSpanInv[j] = 1.0f / (table.rPoints[j + 1] - table.rPoints[j]);
+    for (uint8_t b = 0; b < V_BINS; b++) {
+      float v = next->v0 + b * span / (V_BINS - 1);
+      for (uint8_t l = 0; l < LOOPS; l++)
+        for (uint8_t g = 0; g < GAINS; g++) next->bins[j][b].k[l][g] = interpolateRow(table, table.scale[l][g][j], v);
+    }
+  }
+  active = next;
+  return true;
+}
+
+const Table& getTable() { return table; }
+
+// Gain multipliers for the given setpoint and load (bin lookup + one lerp per gain)
+void lookup(float vset, float loadOhms, Scales& out) {
+  const Lut* l = active;
+  if (!l) {
+    for (uint8_t n = 0; n < LOOPS; n++)
+      for (uint8_t g = 0; g < GAINS; g++) out.k[n][g] = 1.0f;
+    return;
+  }
+
+  int b = (int)((vset - l->v0) * l->vBinInv + 0.5f);
+  if (b < 0) b = 0;
+  else if (b >= V_BINS) b = V_BINS - 1;
+
+  // Load changes slowly: walk from the cached segment instead of searching
+  uint8_t j = rSegment;
+  while (j > 0 && loadOhms < l->r[j]) j--;
+  while (j < R_POINTS - 2 && loadOhms >= l->r[j + 1]) j++;
+  rSegment = j;
+
+  float t = (loadOhms - l->r[j]) * l->rSpanInv[j];
+  if (t < 0.0f) t = 0.0f;
+  else if (t > 1.0f) t = 1.0f;
+  const Scales& lo = l->bins[j][b];
+  const Scales& hi = l->bins[j + 1][b];
+  for (uint8_t n = 0; n < LOOPS; n++)
+    for (uint8_t g = 0; g < GAINS; g++) out.k[n][g] = lo.k[n][g] + (hi.k[n][g] - lo.k[n][g]) * t;
+}
+
+} // namespace GainSchedule
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduino.h>
+
+// PID gain scheduling by voltage setpoint and estimated load resistance
+namespace GainSchedule {
+
+constexpr uint8_t V_POINTS = 4;  // Setpoint breakpoints
+constexpr uint8_t R_POINTS = 3;  // Load resistance breakpoints
+constexpr uint8_t V_BINS = 64;   // Precomputed voltage bins per resistance breakpoint
+
+enum Loop : uint8_t { CV, CC, LOOPS };       // Control loop
+enum Gain : uint8_t { KP, KI, KD, GAINS };   // PID gain
+
+// Persisted gain table: one multiplier grid per loop and gain, on shared breakpoints
+struct Table {
+  float vPoints[V_POINTS];          // Setpoint breakpoints (V), ascending
+  float rPoints[R_POINTS];          // Load resistance breakpoints (ohm), ascending
+  float scale[LOOPS][GAINS][R_POINTS][V_POINTS]; // Gain multiplier at each grid point
+};
+
+// Multipliers for one operating point
+struct Scales {
+  float k[LOOPS][GAINS];
+};
+
+Table defaultTable();               // Neutral table (all multipliers 1.0)
+bool setTable(const Table& table);  // Validate, store and precompute lookup
+const Table& getTable();            // Current table
+void lookup(float vset, float loadOhms, Scales& out); // Gain multipliers (O(1), called per tick)
+
+} // namespace GainSchedule
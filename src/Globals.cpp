@@ -5,6 +5,8 @@ float labV_meas = 0.0f;        // Measured voltage (V)
 float labI_meas = 0.0f;        // Measured current (A)
 float labQ_meas = 0.0f;        // Measured power (W)
 float labTemp_ntc = 25.0f;     // NTC temperature (°C)
+uint8_t inaProfile = 1;        // INA226 acquisition profile (balanced)
+volatile uint32_t controlPeriodUs = DC_CONTROL_UPDATE_INTERVAL * 1000UL; // Control tick period (us)
 
 // Setpoints and limits
 float labV_set = 5.0f;         // Voltage setpoint (V)
@@ -13,6 +15,22 @@ float labI_cut = 2.0f;        // Fuse current limit (A)
 float rampedVset = labV_set;   // Ramped voltage setpoint
 float rampedIset = labI_set;   // Ramped voltage setpoint
 
+// Setpoint slew
+uint8_t rampProfile = 0;       // Slew profile (0 linear, 1 S-curve, 2 exponential)
+float rampRateV = 0.003f;      // Voltage slew rate (V/ms), 0 = step
+float rampRateI = 0.0003f;     // Current slew rate (A/ms), 0 = step
+float rampAccelMs = 100.0f;    // S-curve: time to reach full rate (ms)
+float rampTauMs = 100.0f;      // Exponential: time constant (ms)
+
+// I²t fuse
+uint8_t fuseCurve = 0;         // Blow curve (0 fast, 1 slow, 2 custom)
+float fuseTauS = 0.3f;         // Custom curve: thermal time constant (s)
+float fusePeak = 5.0f;         // Custom curve: instant-open current multiple
+
+// Short-circuit predictor
+float shortSlopeAms = 0.05f;   // Minimum dI/dt (A/ms), 0 = off
+float shortCollapse = 0.2f;    // Minimum voltage collapse (fraction)
+
 // PID parameters (CV)
 float Kp = 3.0f;               // Proportional gain
 float Ki = 1.0f;               // Integral gain
@@ -30,56 +48,14 @@ float Kd_I = 0.1f;             // Derivative gain for current
 float integralLimit_I = 50.0f; // Integral limit for current
 float prevIError = 0.0f;       // Previous current error
 float deltaVMax = 0.05f;       // Max voltage change per step (V)
+bool gainScheduleEnabled = false; // Gain scheduling by setpoint and load
+bool feedForwardEnabled = false; // Learned duty feed-forward on setpoint changes
 
 // Protection settings
 float tempLimitC = 70.0f;      // Overheat threshold (°C)
 float tempDiffC = 5.0f;        // Temperature hysteresis (°C)
 float VdevLimit = 1.0f;        // Voltage deviation limit (V)
 float IdevLimit = 0.05f;       // Current deviation limit (5%)
-bool tempFaultActive = false;  // Overheat protection
-bool errorOverCurrent = false; // Overcurrent error
-bool errorFuseBlown = false;   // Fuse blown error
-bool errorSensorFail = false;  // Sensor failure
-bool errorInaInitFail = false; // INA226 initialization failure
-bool errorWifiInitFail = false; // WiFi initialization failure
-bool errorSsd1306InitFail = false; // SSD1306 initialization failure
-bool errorPwmInitFail = false; // PWM initialization failure
-bool errorVoutOverLimit = false; // Output voltage over limit
-bool errorOverPower = false;   // Over power error
-bool errorVoltageDev = false;  // Voltage deviation error
-bool errorCurrentDev  = false; // Current deviation error
-bool errorPowerOverLimit = false; // Power over limit
-bool errorLedcInitFail = false; // LEDC initialization failure
-bool errorPidDivergence = false; // Voltage PID divergence error
-bool errorLowMemory = false;    // Low memory error
-bool errorHighCpuTemp = false; // High CPU temperature error
-bool errorPidCurrentDivergence = false; // Current PID divergence error
-
-// Error flags for ErrMgr
-bool* errorFlags[MAX_ERRORS] = {
-  &tempFaultActive,          // Bit 0: Overheat
-  &errorOverCurrent,         // Bit 1: Overcurrent
-  &errorFuseBlown,           // Bit 2: Fuse blown
-  &errorSensorFail,          // Bit 3: Sensor failure
-  &errorInaInitFail,         // Bit 4: INA226 init failure
-  &errorWifiInitFail,        // Bit 5: WiFi init failure
-  &errorSsd1306InitFail,     // Bit 6: SSD1306 init failure
-  &errorPwmInitFail,         // Bit 7: PWM init failure
-  &errorVoutOverLimit,       // Bit 8: Voltage out of limits
-  &errorOverPower,           // Bit 9: Over power
-  &errorVoltageDev,          // Bit 10: Voltage deviation
-  &errorCurrentDev,          // Bit 11: Current over limit
-  &errorPowerOverLimit,      // Bit 12: Power over limit
-  &errorLedcInitFail,        // Bit 13: LEDC init failure
-  &errorPidDivergence,       // Bit 14: Voltage PID divergence
-  &errorLowMemory,           // Bit 15: Low memory
-  &errorHighCpuTemp,         // Bit 16: High CPU temperature
-  &errorPidCurrentDivergence // Bit 17: Current PID divergence
-  // Remaining elements are nullptr
-};
-
-// Combined error code
-uint32_t errorCode = 0;
 
 // Operating modes and control
 bool modeAuto = true;          // Automatic mode
@@ -89,6 +65,7 @@ bool isCC = false;             // Current control mode flag
 
 // Display settings
 bool mainScreenVoltage = true; // Show voltage on main screen
+bool energyScreen = false;     // Show charge/energy counters instead of the main screen
 bool editingValue = false;     // Editing mode
 volatile bool configMenuRequested = false; // Config menu request
 volatile bool miniMenuRequested = false;   // Mini menu request
@@ -113,7 +90,7 @@ bool isSaving = false;         // Saving in progress
 unsigned long lastSaveTime = 0; // Last save timestamp
 unsigned long saveIndicatorTimeout = 0; // Save indicator timeout
 bool settingsLoaded = false;   // Settings loaded
-uint8_t settingsVersion = 1;   // Settings version
+uint8_t settingsVersion = 9;   // Settings version
 
 // Communication status
 bool wsConnected = false;      // WebSocket connection status
@@ -9,6 +9,8 @@ extern float labV_meas;     // Measured voltage (V)
 extern float labI_meas;     // Measured current (A)
 extern float labQ_meas;     // Measured power (W)
 extern float labTemp_ntc;   // NTC temperature (°C)
+extern uint8_t inaProfile;  // INA226 acquisition profile (Ina226Manager::Profile)
+extern volatile uint32_t controlPeriodUs; // Control tick period (us), follows the INA226 profile
 
 // Setpoints and limits
 extern float labV_set;      // Voltage setpoint (V)
@@ -17,6 +19,22 @@ extern float labI_cut;     // Fuse current limit (A)
 extern float rampedVset;   // Ramped voltage setpoint
 extern float rampedIset;   // Ramped current setpoint
 
+// Setpoint slew
+extern uint8_t rampProfile;  // Slew profile (DcControl::RampProfile)
+extern float rampRateV;      // Voltage slew rate (V/ms), 0 = step
+extern float rampRateI;      // Current slew rate (A/ms), 0 = step
+extern float rampAccelMs;    // S-curve: time to reach full rate (ms)
+extern float rampTauMs;      // Exponential: time constant (ms)
+
+// I²t fuse
+extern uint8_t fuseCurve;    // Blow curve (FuseModel::Curve)
+extern float fuseTauS;       // Custom curve: thermal time constant (s)
+extern float fusePeak;       // Custom curve: instant-open current multiple
+
+// Short-circuit predictor
+extern float shortSlopeAms;  // Minimum dI/dt (A/ms), 0 = off
+extern float shortCollapse;  // Minimum voltage collapse (fraction)
+
 // PID parameters (CV)
 extern float Kp;            // Proportional gain
 extern float Ki;            // Integral gain
@@ -33,35 +51,14 @@ extern float Kd_I;          // Derivative gain for current
 extern float integralLimit_I; // Integral limit for current
 extern float prevIError;    // Previous current error
 extern float deltaVMax;     // Max voltage change per step
+extern bool gainScheduleEnabled; // Gain scheduling by setpoint and load
+extern bool feedForwardEnabled; // Learned duty feed-forward on setpoint changes
 
 // Protection settings
 extern float tempLimitC;    // Temperature limit (°C)
 extern float tempDiffC;     // Temperature difference threshold (°C)
 extern float VdevLimit;     // Voltage deviation limit (V)
 extern float IdevLimit;     // Voltage deviation limit (%)
-extern bool tempFaultActive; // Overheat fault
-extern bool errorOverCurrent; // Overcurrent error
-extern bool errorFuseBlown;  // Fuse blown error
-extern bool errorSensorFail; // Sensor failure
-extern bool errorInaInitFail; // INA226 initialization failure
-extern bool errorWifiInitFail; // WiFi initialization failure
-extern bool errorSsd1306InitFail; // SSD1306 initialization failure
-extern bool errorPwmInitFail; // PWM initialization failure
-extern bool errorVoutOverLimit; // Output voltage over limit
-extern bool errorOverPower;  // Over power error
-extern bool errorVoltageDev; // Voltage deviation error
-extern bool errorCurrentDev; // Current over limit
-extern bool errorPowerOverLimit; // Power over limit
-extern bool errorLedcInitFail; // LEDC initialization failure
-extern bool errorPidDivergence; // PID divergence error
-extern bool errorLowMemory;  // Low memory error
-extern bool errorHighCpuTemp; // High CPU temperature error
-extern bool errorPidCurrentDivergence; // Current PID divergence error
-
-// Error flags for ErrMgr
-#define MAX_ERRORS 32
-extern bool* errorFlags[MAX_ERRORS]; // Array of error flag pointers
-extern uint32_t errorCode;          // Combined error code
 
 // Operating modes and control
 extern bool modeAuto;               // Automatic mode
@@ -71,6 +68,7 @@ extern bool isCC;                   // Current control mode flag
 
 // Display settings
 extern bool mainScreenVoltage;      // Show voltage on main screen
+extern bool energyScreen;           // Show charge/energy counters instead of the main screen
 extern bool editingValue;           // Editing mode active
 extern volatile bool configMenuRequested; // Config menu request
 extern volatile bool miniMenuRequested;  // Mini menu request
@@ -3,39 +3,386 @@
 #include "Config.h"
 #include <Wire.h>
 #include <INA226_WE.h>
+#include "ControlTask.h"
+#include "Energy.h"
+#include "Calibration.h"
+#include "OutputControl.h"
+#include "FuseModel.h"
+#include "ErrMgr.h"
+
+#define ALERT_CONV_READY (INA226_ALERT_PIN >= 0 && !INA226_ALERT_TRIP) // ALERT paces sample pick-up
+#define ALERT_OC_TRIP (INA226_ALERT_PIN >= 0 && INA226_ALERT_TRIP)     // ALERT is the overcurrent trip
 
 namespace Ina226Manager {
 
 static INA226_WE ina226(INA226_I2C_ADDRESS); // INA226 instance
 static bool inaReady = false;                // Sensor readiness flag
 
+// Acquisition profile settings
+struct ProfileConfig {
+  const char* name;
+  INA226_AVERAGES average;     // Averaging
+  INA226_CONV_TIME convTime;   // Bus and shunt conversion time
+  uint32_t convPeriodUs;       // Time per result: averages x (bus + shunt conversion)
+  uint32_t controlPeriodUs;    // Control tick for this profile
+};
+
+static const ProfileConfig profiles[(uint8_t)Profile::Count] = {
+  {"fast",     INA226_AVERAGE_1,  INA226_CONV_TIME_140,  1UL * (140UL + 140UL),    5000UL},
+  {"balanced", INA226_AVERAGE_16, INA226_CONV_TIME_1100, 16UL * (1100UL + 1100UL), DC_CONTROL_UPDATE_INTERVAL * 1000UL},
+  {"precise",  INA226_AVERAGE_64, INA226_CONV_TIME_1100, 64UL * (1100UL + 1100UL), 140000UL},
+};
+
+static uint8_t activeProfile = 0xFF;         // Profile written to the INA226
+static uint32_t convPeriodUs = profiles[1].convPeriodUs; // Time per result of the active profile
+static bool discardNext = false;             // First result after a switch mixes settings
+
+static portMUX_TYPE sampleMux = portMUX_INITIALIZER_UNLOCKED;
+static Sample latest = {};                   // Last published sample
+static uint32_t lastSampleUs = 0;            // Pick-up time of the last sample
+static volatile bool alertPending = false;   // ALERT pin fired (conversion ready mode)
+static float tripLimitA = -1.0f;             // Current limit programmed into the ALERT comparator (A)
+
+// Scope capture: armed from the web task, handed to the capture task by update()
+constexpr uint32_t CAPTURE_STACK = 3072;           // Capture task stack (bytes)
+constexpr UBaseType_t CAPTURE_PRIORITY = 2;        // Above loop(); the task blocks between reads, so loop() keeps running
+constexpr uint32_t CAPTURE_CONV_US = 1UL * (140UL + 140UL); // Time per result at the capture setting
+constexpr uint32_t CAPTURE_STALL_US = 100000;      // No result for this long: sensor lost, capture ends
+constexpr uint32_t CAPTURE_YIELD_US = 20000;       // After the trigger, sleep one RTOS tick at least this often
+
+static CapturePoint* capBuf = nullptr;             // Ring buffer (PSRAM when available)
+static uint16_t capDepth = 0;                      // Ring buffer size (points)
+static TaskHandle_t capTask = nullptr;             // Capture task handle
+static CaptureConfig capCfg = {};                  // Setup of the pending/running capture
+static volatile CaptureState capState = CaptureState::Idle;
+static volatile bool capArmReq = false;            // Armed, waiting for update() to hand over the sensor
+static volatile bool capActive = false;            // Capture task owns the sensor
+static volatile bool capStopReq = false;           // Abort requested
+static volatile uint16_t capCount = 0;             // Points stored since arming
+static uint16_t capHead = 0;                       // Next write position
+static uint16_t capStart = 0;                      // First point of the finished capture
+static uint16_t capLength = 0;                     // Points in the finished capture
+static uint16_t capPre = 0;                        // Points before the trigger in the finished capture
+
+#if ALERT_CONV_READY
+// ALERT pin: conversion ready; also wakes the capture task while it owns the sensor
+static void IRAM_ATTR onAlert() {
+  alertPending = true;
+  if (!capActive) return;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(capTask, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+#elif ALERT_OC_TRIP
+// ALERT pin: averaged current above the trip limit
+static void IRAM_ATTR onAlert() { OutputControl::hardwareTrip(); }
+
+// Follow the fuse's instant-open point, capped at the system limit; compared against the raw, uncalibrated current
+static void updateTripLimit() {
+  float peak = FuseModel::params((FuseModel::Curve)fuseCurve, fuseTauS, fusePeak).peak;
+  float limit = (labI_cut > 0.0f ? min(labI_cut * peak, systemIlimitMax) : systemIlimitMax) * INA226_TRIP_MARGIN;
+  if (fabsf(limit - tripLimitA) < 0.001f) return;
+  ina226.setAlertType(CURRENT_OVER, limit * 1000.0f); // mA
+  tripLimitA = limit;
+}
+#endif
+
+// Write a profile's averaging and conversion time; the chip keeps running, so no re-init
+static void applyProfile(uint8_t p) {
+  const ProfileConfig& cfg = profiles[p];
+  ina226.setAverage(cfg.average);
+  ina226.setConversionTime(cfg.convTime, cfg.convTime);
+  ina226.readAndClearFlags();
+  activeProfile = p;
+  convPeriodUs = cfg.convPeriodUs;
+  discardNext = true;
+  lastSampleUs = micros();
+  ControlTask::setPeriod(cfg.controlPeriodUs);
+}
+
+// Read bus voltage and current of the last conversion, calibrated
+static void readConversion(float& v, float& i) {
+  float vRaw = ina226.getBusVoltage_V();
+  float iRaw = ina226.getCurrent_mA() / 1000.0f;
+  Calibration::feedRaw(vRaw, iRaw);
+  v = Calibration::apply(Calibration::Channel::Voltage, vRaw);
+  i = Calibration::apply(Calibration::Channel::Current, iRaw);
+}
+
+// Publish a conversion as the latest sample
+static void publish(uint32_t now, float v, float i) {
+  // Clamp small negative values to zero
+  if (v > -0.01f && v < 0.0f) v = 0.0f;
+  if (i > -0.01f && i < 0.0f) i = 0.0f;
+  float p = v * i;
+  if (p > -0.01f && p < 0.01f) p = 0.0f;
+
+  portENTER_CRITICAL(&sampleMux);
+  latest.seq++;
+  if (latest.seq == 0) latest.seq = 1; // 0 is reserved for "no sample"
+  latest.timestampUs = now;
+  latest.v = v;
+  latest.i = i;
+  latest.p = p;
+  portEXIT_CRITICAL(&sampleMux);
+
+  Energy::add(now, v, i, p); // Every conversion, including scope captures
+}
+
+// Check the armed trigger against the newest point
+static bool triggerHit(float i, float prevI, float dtMs, bool prevOut, bool faultRose) {
+  switch (capCfg.trigger) {
+    case Trigger::Current:    return fabsf(i) >= capCfg.level && fabsf(prevI) < capCfg.level;
+    case Trigger::Slope:      return fabsf(i - prevI) >= capCfg.level * dtMs;
+    case Trigger::OutputEdge: return outputActive != prevOut;
+    case Trigger::Fault:      return faultRose;
+    default:                  return false;
+  }
+}
+
+// Stream conversions at the fastest rate into the ring buffer until the post-trigger depth is filled
+static void runCapture() {
+  ina226.setAverage(INA226_AVERAGE_1);
+  ina226.setConversionTime(INA226_CONV_TIME_140, INA226_CONV_TIME_140);
+  ina226.readAndClearFlags();
+
+  bool first = true;           // First result mixes the old settings
+  bool havePrev = false;       // prevI valid
+  float prevI = 0.0f;
+  bool prevOut = outputActive;
+  ErrMgr::Cursor errors = ErrMgr::subscribe();
+  uint32_t lastUs = micros();
+  uint32_t armedUs = lastUs;   // Start of the wait for a trigger
+  uint16_t postLeft = 0;
+  capHead = 0;
+  capCount = 0;
+#if !ALERT_CONV_READY
+  uint32_t sleptUs = lastUs;   // Last RTOS tick given away
+#endif
+
+  while (!capStopReq) {
+#if ALERT_CONV_READY
+    // Block until the conversion-ready edge; a missed edge costs one RTOS tick, then the flag is polled
+    ulTaskNotifyTake(pdTRUE, 1);
+    uint32_t now = micros();
+#else
+    // No ready edge to wait on. Armed, the wait can last SCOPE_ARM_TIMEOUT_MS, so read once per RTOS
+    // tick and leave loop() the CPU; once triggered, poll for the post-trigger points and only sleep
+    // now and then. The spacing shows up in dtUs.
+    uint32_t now = micros();
+    if (capState == CaptureState::Armed || now - sleptUs >= CAPTURE_YIELD_US) {
+      vTaskDelay(1);
+      sleptUs = now = micros();
+    } else if (now - lastUs < CAPTURE_CONV_US * 3 / 4) {
+      taskYIELD();  // Same priority only; the post-trigger stretch is short
+      continue;
+    }
+#endif
+    if ((capState == CaptureState::Armed && now - armedUs >= SCOPE_ARM_TIMEOUT_MS * 1000UL) ||
+        now - lastUs >= CAPTURE_STALL_US) {
+      capState = CaptureState::TimedOut;
+      break;
+    }
+    ina226.readAndClearFlags();
+    if (!ina226.convAlert) continue;
+    now = micros();
+    if (first) {
+      first = false;
+      lastUs = now;
+      continue;
+    }
+
+    float v, i;
+    readConversion(v, i);
+    publish(now, v, i); // Control keeps running on the fast samples
+    bool faultRose = ErrMgr::pollRising(errors) != 0;
+
+    uint16_t index = capHead;
+    CapturePoint& pt = capBuf[index];
+    pt.mV = (uint16_t)constrain(lroundf(v * 1000.0f), 0L, 65535L);
+    pt.i100uA = (int16_t)constrain(lroundf(i * 10000.0f), -32768L, 32767L);
+    pt.dtUs = (uint16_t)min<uint32_t>(now - lastUs, 65535);
+    float dtMs = (now - lastUs) * 1e-3f;
+    lastUs = now;
+    capHead = (capHead + 1) % capDepth;
+    if (capCount < capDepth) capCount = capCount + 1;
+
+    if (capState == CaptureState::Armed) {
+      if (havePrev && triggerHit(i, prevI, dtMs, prevOut, faultRose)) {
+        capPre = min<uint16_t>(capCfg.pre, capCount - 1); // Early triggers keep what was recorded
+        capStart = (index + capDepth - capPre) % capDepth;
+        postLeft = capCfg.post;
+        capState = CaptureState::Triggered;
+      }
+    } else if (postLeft > 0) {
+      postLeft--;
+    }
+    if (capState == CaptureState::Triggered && postLeft == 0) {
+      capLength = capPre + 1 + capCfg.post;
+      capState = CaptureState::Ready;
+      break;
+    }
+
+    havePrev = true;
+    prevI = i;
+    prevOut = outputActive;
+  }
+
+  // Give the sensor back with the active profile
+  const ProfileConfig& cfg = profiles[activeProfile];
+  ina226.setAverage(cfg.average);
+  ina226.setConversionTime(cfg.convTime, cfg.convTime);
+  ina226.readAndClearFlags();
+  discardNext = true;
+  lastSampleUs = micros();
+  if (capState != CaptureState::Ready && capState != CaptureState::TimedOut) capState = CaptureState::Idle;
+  capStopReq = false;
+  capActive = false;
+}
+
+// Capture task body
+static void captureMain(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (capActive) runCapture();  // Not a conversion-ready wake-up left over from the last capture
+  }
+}
+
+// Allocate the capture ring buffer and start the capture task
+static void beginCapture() {
+  uint16_t depth = psramFound() ? SCOPE_DEPTH_PSRAM : SCOPE_DEPTH_SRAM;
+  capBuf = (CapturePoint*)(psramFound() ? ps_malloc(depth * sizeof(CapturePoint))
+                                        : malloc(depth * sizeof(CapturePoint)));
+  if (!capBuf) return;
+  if (xTaskCreate(captureMain, "scope", CAPTURE_STACK, nullptr, CAPTURE_PRIORITY, &capTask) != pdPASS) {
+    free(capBuf);
+    capBuf = nullptr;
+    capTask = nullptr;
+    return;
+  }
+  capDepth = depth;
+}
+
 // Initialize INA226 sensor
 void begin() {
   inaReady = ina226.init();
   if (!inaReady) {
-    errorInaInitFail = true; // Set error flag on initialization failure
+    ErrMgr::set(ErrMgr::InaInitFail); // Set error flag on initialization failure
     return;
   }
-  errorInaInitFail = false;
+  ErrMgr::clear(ErrMgr::InaInitFail);
 
-  ina226.setAverage(INA226_AVERAGE_16); // Set measurement averaging
-  ina226.setConversionTime(INA226_CONV_TIME_1100, INA226_CONV_TIME_1100); // Set conversion time
   ina226.setMeasureMode(INA226_CONTINUOUS); // Set continuous measurement mode
   ina226.setResistorRange(SHUNT_RESISTANCE_OHMS, SHUNT_MAX_CURRENT_A); // Set shunt range
+
+#if ALERT_CONV_READY
+  pinMode(INA226_ALERT_PIN, INPUT_PULLUP);     // ALERT is open-drain, active low
+  ina226.enableConvReadyAlert();               // Drive ALERT on conversion ready
+  attachInterrupt(digitalPinToInterrupt(INA226_ALERT_PIN), onAlert, FALLING);
+#elif ALERT_OC_TRIP
+  pinMode(INA226_ALERT_PIN, INPUT_PULLUP);
+  ina226.enableAlertLatch();                   // Held until the flags are read; update() reads them every conversion,
+  updateTripLimit();                           // so a persisting overcurrent gives a fresh edge each conversion
+  attachInterrupt(digitalPinToInterrupt(INA226_ALERT_PIN), onAlert, FALLING);
+#endif
+  applyProfile(inaProfile < (uint8_t)Profile::Count ? inaProfile : (uint8_t)Profile::Balanced);
+  beginCapture();
 }
 
-// Update sensor measurements
+// Read a new conversion when one is ready: one flag read, then bus voltage and current
 void update() {
   if (!inaReady) return;
 
-  labV_meas = ina226.getBusVoltage_V();     // Update voltage (V)
-  labI_meas = ina226.getCurrent_mA() / 1000.0f; // Update current (A)
-  labQ_meas = ina226.getBusPower() / 1000.0f;   // Update power (W)
+  // Hand the sensor to the capture task; it is only touched there until the capture ends
+  if (capArmReq) {
+    capArmReq = false;
+    capActive = true;
+    capState = CaptureState::Armed;
+    xTaskNotifyGive(capTask);
+  }
+  if (capActive) return;
+
+  // Profile switches requested from the web UI or the sequencer
+  if (inaProfile != activeProfile && inaProfile < (uint8_t)Profile::Count) applyProfile(inaProfile);
+#if ALERT_OC_TRIP
+  updateTripLimit();
+#endif
 
-  // Clamp small negative values to zero
-  if (labV_meas > -0.01f && labV_meas < 0.0f) labV_meas = 0.0f;
-  if (labI_meas > -0.01f && labI_meas < 0.0f) labI_meas = 0.0f;
-  if (labQ_meas > -0.01f && labQ_meas < 0.01f) labQ_meas = 0.0f;
+  uint32_t now = micros();
+#if ALERT_CONV_READY
+  // Fall back to polling if an edge was missed and ALERT is stuck low
+  if (!alertPending && now - lastSampleUs < 2 * convPeriodUs) return;
+  alertPending = false;
+#else
+  // Start polling the flag shortly before the next conversion is due
+  if (now - lastSampleUs < convPeriodUs * 9 / 10) return;
+#endif
+
+  ina226.readAndClearFlags(); // Clears CVRF and releases ALERT
+  if (!ina226.convAlert) return;
+  lastSampleUs = now;
+  if (discardNext) {
+    discardNext = false;
+    return;
+  }
+
+  float v, i;
+  readConversion(v, i);
+  publish(now, v, i);
+}
+
+// Copy the latest sample
+bool getSample(Sample& out) {
+  portENTER_CRITICAL(&sampleMux);
+  out = latest;
+  portEXIT_CRITICAL(&sampleMux);
+  return out.seq != 0;
+}
+
+void setProfile(Profile profile) {
+  if (profile < Profile::Count) inaProfile = (uint8_t)profile;
+}
+
+Profile getProfile() { return (Profile)activeProfile; }
+
+uint32_t getConversionPeriodUs() { return convPeriodUs; }
+
+float getTripLimit() { return tripLimitA; }
+
+const char* getProfileName(Profile profile) {
+  return profile < Profile::Count ? profiles[(uint8_t)profile].name : "?";
+}
+
+bool armCapture(const CaptureConfig& cfg) {
+  if (!inaReady || !capDepth || capArmReq || capActive || cfg.trigger >= Trigger::Count) return false;
+  capCfg = cfg;
+  capCfg.pre = min<uint16_t>(cfg.pre, capDepth - 1);
+  capCfg.post = min<uint16_t>(cfg.post, capDepth - 1 - capCfg.pre); // Post points must not overwrite pre points
+  capCount = 0;
+  capArmReq = true;
+  return true;
+}
+
+void stopCapture() {
+  capArmReq = false;
+  if (capActive) capStopReq = true;
+  else if (capState != CaptureState::Ready) capState = CaptureState::Idle;
+}
+
+CaptureState getCaptureState() { return capArmReq ? CaptureState::Armed : capState; }
+bool captureBusy() { return capArmReq || capActive; }
+uint16_t getCaptureDepth() { return capDepth; }
+uint16_t getCaptureCount() { return capCount; }
+uint16_t getCaptureLength() { return !capActive && capState == CaptureState::Ready ? capLength : 0; }
+const CaptureConfig& getCaptureConfig() { return capCfg; }
+
+uint16_t readCapture(CapturePoint* out, uint16_t maxPoints, uint16_t& triggerIndex) {
+  triggerIndex = 0;
+  if (capActive || capState != CaptureState::Ready) return 0;
+  uint16_t n = min(capLength, maxPoints);
+  for (uint16_t k = 0; k < n; k++) out[k] = capBuf[(capStart + k) % capDepth];
+  triggerIndex = capPre;
+  return n;
 }
 
 // Get voltage (V)
@@ -47,4 +394,4 @@ float getCurrent() { return labI_meas; }
 // Get power (W)
 float getPower() { return labQ_meas; }
 
-} // namespace Ina226Manager
\ No newline at end of file
+} // namespace Ina226Manager
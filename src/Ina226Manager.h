@@ -5,11 +5,72 @@
 // INA226 sensor manager for voltage, current, and power measurements
 namespace Ina226Manager {
 
+  // Acquisition profiles (inaProfile)
+  enum class Profile : uint8_t {
+    Fast,      // No averaging, 140 us conversions; 5 ms control tick
+    Balanced,  // 16 averages, 1.1 ms conversions; 35 ms control tick
+    Precise,   // 64 averages, 1.1 ms conversions; 140 ms control tick
+    Count
+  };
+
+  // One completed INA226 conversion
+  struct Sample {
+    uint32_t seq;          // Sequence number (0 = no sample yet)
+    uint32_t timestampUs;  // Time the conversion was picked up (us)
+    float v;               // Bus voltage (V)
+    float i;               // Current (A)
+    float p;               // Power (W), derived from v * i
+  };
+
+  // Scope capture trigger sources
+  enum class Trigger : uint8_t {
+    Current,     // |I| rises through the level (A)
+    Slope,       // |dI/dt| reaches the level (A/ms)
+    OutputEdge,  // Output switched on or off
+    Fault,       // A new error bit is set
+    Count
+  };
+
+  enum class CaptureState : uint8_t { Idle, Armed, Triggered, Ready, TimedOut }; // TimedOut: no trigger or no conversions
+
+  // Scope capture setup
+  struct CaptureConfig {
+    Trigger trigger;     // Trigger source
+    float level;         // Threshold for Current / Slope triggers
+    uint16_t pre;        // Points kept before the trigger
+    uint16_t post;       // Points taken after the trigger
+  };
+
+  // One captured conversion (6 bytes, sent as-is in the binary frame)
+  struct CapturePoint {
+    uint16_t mV;         // Bus voltage (mV)
+    int16_t i100uA;      // Current (0.1 mA)
+    uint16_t dtUs;       // Time since the previous point (us)
+  };
+
   void begin();       // Initialize INA226 sensor
-  void update();      // Update sensor measurements
+  void update();      // Read a new conversion when one is ready
+
+  bool getSample(Sample& out); // Copy the latest sample (false before the first conversion)
+  void setProfile(Profile profile); // Request a profile; applied by update() without re-init
+  Profile getProfile();       // Profile currently applied
+  const char* getProfileName(Profile profile); // Short profile name
+  uint32_t getConversionPeriodUs();  // Time per result of the active profile (us)
+  float getTripLimit();              // ALERT overcurrent trip level (A, negative = not armed)
+
+  bool armCapture(const CaptureConfig& cfg); // Arm a capture at the fastest conversion rate
+  void stopCapture();                        // Abort a pending or running capture
+  CaptureState getCaptureState();            // Capture progress
+  bool captureBusy();                        // Capture owns the sensor and the I2C bus
+  uint16_t getCaptureDepth();                // Ring buffer size (points, 0 = no buffer)
+  uint16_t getCaptureCount();                // Points stored since arming
+  uint16_t getCaptureLength();               // Points in the finished capture (0 until ready)
+  const CaptureConfig& getCaptureConfig();   // Setup of the last armed capture
+  // Copy a finished capture in time order; returns points copied and the trigger position
+  uint16_t readCapture(CapturePoint* out, uint16_t maxPoints, uint16_t& triggerIndex);
 
   float getVoltage(); // Get voltage (V)
   float getCurrent(); // Get current (A)
   float getPower();   // Get power (W)
 
-} // namespace Ina226Manager
\ No newline at end of file
+} // namespace Ina226Manager
@@ -0,0 +1,62 @@
+#include "NtcSensor.h"
+
+namespace NtcSensor {
+
+static constexpr Lut lut;                          // Built by the compiler
+constexpr float SEGMENTS_PER_VOLT = LUT_SEGMENTS / VREF;
+
+static bool continuous = false;                    // Continuous ADC running
+static float lastVolts = VREF / 2;                 // Last oversampled reading
+static float filtered = VREF / 2;                  // Smoothed divider voltage
+static float variance = 0.0f;                      // Smoothed squared deviation (V^2)
+
+void begin() {
+#if NTC_ADC_CONTINUOUS
+  const uint8_t pins[] = {NTC_ADC_PIN};
+  continuous = analogContinuous(pins, 1, NTC_OVERSAMPLE, NTC_SAMPLE_FREQ_HZ, nullptr) && analogContinuousStart();
+#endif
+}
+
+void reset() {
+  filtered = VREF / 2;
+  variance = 0.0f;
+}
+
+float readVolts() {
+  if (continuous) {
+    // The driver averages NTC_OVERSAMPLE conversions per frame; keep the last one if none is new
+    adc_continuous_data_t* result = nullptr;
+    if (analogContinuousRead(&result, 0) && result) lastVolts = result[0].avg_read_mvolts / 1000.0f;
+  } else {
+    uint32_t sum = 0;
+    for (uint8_t k = 0; k < NTC_OVERSAMPLE_BURST; k++) sum += analogReadMilliVolts(NTC_ADC_PIN);
+    lastVolts = sum / (NTC_OVERSAMPLE_BURST * 1000.0f);
+  }
+  return lastVolts;
+}
+
+float filter(float volts, float alpha) {
+  float dev = volts - filtered;
+  filtered += alpha * dev;
+  variance += alpha * (dev * dev - variance);
+  return filtered;
+}
+
+float toCelsius(float volts) {
+  float x = volts * SEGMENTS_PER_VOLT;
+  if (x <= 0.0f) return lut.celsius[0];
+  if (x >= LUT_SEGMENTS) return lut.celsius[LUT_SEGMENTS];
+  int k = (int)x;
+  return lut.celsius[k] + (lut.celsius[k + 1] - lut.celsius[k]) * (x - k);
+}
+
+float getNoiseMv() { return sqrtf(variance) * 1000.0f; }
+
+// Noise through the local slope of the LUT
+float getNoiseC() {
+  int k = constrain((int)(filtered * SEGMENTS_PER_VOLT), 0, LUT_SEGMENTS - 1);
+  float slope = (lut.celsius[k + 1] - lut.celsius[k]) * SEGMENTS_PER_VOLT; // °C per V
+  return sqrtf(variance) * fabsf(slope);
+}
+
+} // namespace NtcSensor
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Config.h"
+
+// NTC temperature pipeline: oversampled ADC, noise tracking and a compile-time Beta LUT
+namespace NtcSensor {
+
+constexpr float VREF = 3.3f;            // Divider supply (V)
+constexpr uint8_t LUT_SEGMENTS = 128;   // Interpolation segments over 0..VREF
+
+// Natural log usable in constant expressions: halve/double into [0.75, 1.5), then atanh series
+constexpr double ctLog(double x) {
+  if (x <= 0.0) return -1e300;
+  int k = 0;
+  while (x >= 1.5) { x /= 2.0; k++; }
+  while (x < 0.75) { x *= 2.0; k--; }
+  double y = (x - 1.0) / (x + 1.0);
+  double y2 = y * y;
+  double term = y;
+  double sum = 0.0;
+  for (int n = 1; n < 40; n += 2) {
+    sum += term / n;
+    term *= y2;
+  }
+  return 2.0 * sum + k * 0.69314718055994530942;
+}
+
+// Beta-equation temperature (°C) at a divider voltage; clamped to a sane range at the rails
+constexpr float betaCelsius(double volts) {
+  if (volts <= 0.001) volts = 0.001;
+  if (volts >= VREF - 0.001) volts = VREF - 0.001;
+  double r = NTC_SERIES_RESISTOR * (VREF / volts - 1.0);
+  double invT = ctLog(r / NTC_NOMINAL_RES) / NTC_BETA_COEFF + 1.0 / (NTC_NOMINAL_TEMP_C + 273.15);
+  double t = 1.0 / invT - 273.15;
+  return t < -55.0 ? -55.0f : (t > 200.0 ? 200.0f : (float)t);
+}
+
+// Temperature at each segment edge, built at compile time
+struct Lut {
+  float celsius[LUT_SEGMENTS + 1];
+  constexpr Lut() : celsius() {
+    for (int k = 0; k <= LUT_SEGMENTS; k++) celsius[k] = betaCelsius((double)VREF * k / LUT_SEGMENTS);
+  }
+};
+
+void begin();                    // Start oversampled acquisition
+void reset();                    // Restart the filter and noise tracking
+float readVolts();               // Latest oversampled divider voltage (V), hardware side
+float filter(float volts, float alpha); // Smooth one reading and track its noise; returns filtered volts
+float toCelsius(float volts);    // LUT lookup with linear interpolation
+float getNoiseMv();              // RMS deviation of readings from the filtered value (mV)
+float getNoiseC();               // Same, in °C at the present temperature
+
+} // namespace NtcSensor
@@ -1,157 +1,202 @@
 #include <Arduino.h>
 #include "OutputControl.h"
 #include <math.h>
+#include "SensorSource.h"
+#include "NtcSensor.h"
+#include "FuseModel.h"
+#include "Protection.h"
+#include "Thermal.h"
+#include "ErrMgr.h"
+#include "Ina226Manager.h"
+#include <soc/gpio_struct.h>
 
 namespace OutputControl {
 // Constants
-static float voltageFiltered = 3.3f / 2;          // Initial NTC voltage filter
-static constexpr float NTC_ALPHA = 0.05f;         // NTC smoothing factor
-static constexpr uint8_t INA_CYCLES = 2;          // Cycles for fuse check (~70 ms)
-static constexpr uint8_t NTC_CYCLES = 3;          // Cycles for temp fault (~105 ms)
-static constexpr uint8_t VDEV_CYCLES = 3;         // Cycles for voltage deviation (~105 ms)
-static constexpr uint8_t CDEV_CYCLES = 3;         // Cycles for current deviation (~105 ms)
-static constexpr uint8_t START_CYCLES = 100;      // Startup delay (~1 s)
+static constexpr float NTC_TAU_MS = 150.0f;       // NTC smoothing time constant (ms); readings are already oversampled
+static constexpr uint32_t START_MS = 3500;        // Startup delay (ms)
+
+// Tick-based constants, rebuilt when the control period changes
+static uint32_t appliedPeriodUs = 0; // Period the constants below were built for
+static float ntcAlpha = 0.05f;       // NTC smoothing factor per tick
+static uint16_t startCycles = 100;  // Ticks for startup delay
 
 // Variables
-static uint8_t fuseCount = 0;        // Fuse check counter
-static uint8_t tempCount = 0;        // Temperature fault counter
-static uint8_t vdevCount = 0;        // Voltage deviation counter
-static uint8_t cdevCount = 0;        // Current deviation counter
-static uint8_t startCount = 0;       // Startup counter
+static FuseModel::Fuse fuse;         // I²t fuse state
+static ShortDetector::Detector shortDet; // dI/dt short-circuit predictor
+static portMUX_TYPE shortMux = portMUX_INITIALIZER_UNLOCKED; // Event log, read by the web task
+static bool fuseOver = false;        // Current above labI_cut on the previous tick
+static uint16_t startCount = 0;      // Startup counter
 static bool isStarting = false;      // Startup flag
+static uint32_t tripBits = 0;        // Error bits that cut the output, from Protection::evaluate()
+
+// Overcurrent trip paths
+static_assert(PROTECTION_MOSFET_PIN < 32, "hardwareTrip() writes the low GPIO bank");
+static volatile bool hwTripLatched = false;  // Set by the ALERT ISR, cleared on the next manual enable
+static volatile uint32_t hwTrips = 0;        // ALERT trips since boot
+static volatile uint32_t hwTripUs = 0;       // micros() in the ISR, right after the pin write
+static uint32_t hwTripsSeen = 0;             // ALERT trips already measured
+static uint32_t inRangeUs = 0;               // Timestamp of the last conversion under the ALERT level
+static bool haveInRange = false;             // inRangeUs valid
+static uint32_t hwLastUs = 0;                // Last in-range conversion to MOSFET off, last trip (us)
+static uint32_t hwMaxUs = 0;                 // Same, worst case
+static bool lastManualEnable = false;        // Manual enable on the previous tick
+static bool enableEdge = false;              // Manual enable went on this tick
+static uint32_t fuseOverStartUs = 0;         // Start of the current stretch above labI_cut
+static bool fuseTiming = false;              // Software trip pending latency record
+static uint32_t swTrips = 0;                 // Software fuse trips since boot
+static uint32_t swLastUs = 0;                // First over-limit tick to MOSFET off, last trip
+static uint32_t swMaxUs = 0;                 // Same, worst case
 
 // Initialize MOSFET and reset variables
 void begin() {
     pinMode(PROTECTION_MOSFET_PIN, OUTPUT);
     digitalWrite(PROTECTION_MOSFET_PIN, LOW);
     outputActive = false;
-    voltageFiltered = 3.3f / 2;
-    fuseCount = tempCount = vdevCount = cdevCount = startCount = 0;
+    NtcSensor::begin();
+    reset();
+}
+
+// Everything the protection path has accumulated, back to its boot state
+void reset() {
+    NtcSensor::reset();
+    Thermal::reset();
+    Protection::reset();
+    fuse.reset();
+    portENTER_CRITICAL(&shortMux);
+    shortDet.reset();
+    portEXIT_CRITICAL(&shortMux);
+    fuseOver = false;
+    fuseTiming = false;
+    startCount = 0;
     isStarting = true;
+    tripBits = 0;
+    hwTripLatched = false;
+    lastManualEnable = false;
+    enableEdge = false;
+    outputActive = false;
 }
 
-// Update system state periodically
-void update() {
-    unsigned long now = millis();
-    static unsigned long lastUpdate = 0;
-    if (now - lastUpdate < DC_CONTROL_UPDATE_INTERVAL) return;
-    lastUpdate = now;
+// Rebuild tick-based constants for the current control period
+static void adaptToPeriod() {
+    uint32_t period = controlPeriodUs;
+    if (period == appliedPeriodUs) return;
+    appliedPeriodUs = period;
+    ntcAlpha = 1.0f - expf(-(period / 1000.0f) / NTC_TAU_MS);
+    uint32_t n = (START_MS * 1000UL + period / 2) / period;
+    startCycles = n ? (uint16_t)min(n, (uint32_t)UINT16_MAX) : 1;
+    Protection::setPeriod(period);
+    Thermal::setPeriod(period);
+}
+
+// Feed a new conversion to the short-circuit predictor; true when it fires
+static bool checkShort(const SensorFrame& frame) {
+    float threshold = labI_cut > 0.0f ? min(labI_cut, systemIlimitMax) : systemIlimitMax;
+    ShortDetector::Config cfg = {shortSlopeAms, shortCollapse};
+    portENTER_CRITICAL(&shortMux);
+    bool hit = shortDet.step(frame.timestampUs, frame.v, frame.i, threshold, rampedIset, cfg, millis());
+    portEXIT_CRITICAL(&shortMux);
+    return hit;
+}
+
+// Update system state (called by ControlTask every tick with the tick's sensor frame)
+void update(const SensorFrame& frame, bool fresh) {
+    adaptToPeriod();
 
     // Handle startup delay
     if (isStarting) {
         startCount++;
-        if (startCount >= START_CYCLES) {
+        if (startCount >= startCycles) {
             isStarting = false;
-            startCount = START_CYCLES;
+            startCount = startCycles;
         }
     }
 
-    // Read sensors and check errors
-    readNTCTemperature();
-    checkTemperature();
-    checkFuse();
-    checkSystemLimits();
-    checkVoltageDeviation();
-    checkCurrentDeviation();
-    checkCriticalErrors();
+    // Produce the protection signals, then run the rule table
+    readNTCTemperature(frame.ntcV);
+    Thermal::update();
+    stepFuse();
+    checkHardwareTrip();
+    trackInRange(frame, fresh);
+    bool shortTrip = fresh && checkShort(frame);
+
+    bool wasBlown = ErrMgr::isActive(ErrMgr::FuseBlown);
+    Protection::Inputs in;
+    in.starting = isStarting;
+    in.enableEdge = enableEdge;
+    in.junctionC = Thermal::getJunctionC();
+    in.fuseHeat = labI_cut > 0.0f ? fuse.getHeat() : 0.0f;
+    in.hwTrip = hwTripLatched;
+    in.shortTrip = shortTrip;
+    tripBits = Protection::evaluate(in);
+    if (ErrMgr::isActive(ErrMgr::FuseBlown) && !wasBlown && outputActive) fuseTiming = true;
 
     // Handle MOSFET enable/disable
     handleManualMOSFET();
-
 }
 
-// Read NTC temperature
-void readNTCTemperature() {
-    float voltage = analogReadMilliVolts(NTC_ADC_PIN) / 1000.0f;
+// Convert the NTC divider voltage to temperature
+void readNTCTemperature(float voltage) {
     if (voltage < 0.01f || voltage > 3.3f) voltage = 3.3f / 2; // Protect against invalid ADC readings
-    voltageFiltered = voltageFiltered * (1.0f - NTC_ALPHA) + voltage * NTC_ALPHA;
-    float resistance = NTC_SERIES_RESISTOR * (3.3f / voltageFiltered - 1.0f);
-    float steinhart = resistance / NTC_NOMINAL_RES;
-    steinhart = log(steinhart) / NTC_BETA_COEFF + 1.0f / (NTC_NOMINAL_TEMP_C + 273.15f);
-    labTemp_ntc = 1.0f / steinhart - 273.15f;
-    errorSensorFail = (labTemp_ntc < 0.0f || labTemp_ntc > 100.0f);
+    labTemp_ntc = NtcSensor::toCelsius(NtcSensor::filter(voltage, ntcAlpha));
 }
 
-// Check temperature errors
-void checkTemperature() {
-    if (labTemp_ntc >= tempLimitC) {
-        tempCount++;
-        if (tempCount >= NTC_CYCLES) {
-            tempFaultActive = true;
-            tempCount = NTC_CYCLES;
-        }
-    } else {
-        tempCount = 0;
-        tempFaultActive = false;
+// I²t fuse: integrate the tick's current, rated at labI_cut, along the selected blow curve
+void stepFuse() {
+    if (labI_cut <= 0.0f) {
+        fuse.reset();
+        return;
     }
-}
-
-// Check fuse overcurrent
-void checkFuse() {
-    if (labI_cut <= 0.0f) return;
-    if (labI_meas < 0.0f || isnan(labI_meas)) return;
+    if (isnan(labI_meas)) return;
 
-    if (labI_meas > labI_cut) {
-        fuseCount++;
-        if (fuseCount >= INA_CYCLES) {
-            errorFuseBlown = true;
-            fuseCount = INA_CYCLES;
-        }
-    } else {
-        fuseCount = 0;
-        errorFuseBlown = false;
-    }
-}
+    bool over = fabsf(labI_meas) > labI_cut;
+    if (over && !fuseOver) fuseOverStartUs = micros();
+    fuseOver = over;
 
-// Check system limits
-void checkSystemLimits() {
-    if (!isStarting) {
-        errorOverCurrent = (labI_meas > systemIlimitMax && !isnan(labI_meas));
-        errorOverPower   = (labQ_meas > systemPowerMax && !isnan(labQ_meas));
-    } else {
-        errorOverCurrent = false;
-        errorOverPower   = false;
-    }
-    // Always check voltage
-    errorVoutOverLimit = (!isStarting && (labV_meas > systemVoutMax || labV_meas < systemVoutMin) && !isnan(labV_meas));
+    FuseModel::CurveParams curve = FuseModel::params((FuseModel::Curve)fuseCurve, fuseTauS, fusePeak);
+    fuse.step(labI_meas, labI_cut, appliedPeriodUs * 1e-6f, curve);
 }
 
-// Check voltage deviation in auto mode
-void checkVoltageDeviation() {
-    if (!modeAuto || isStarting || isCC) {
-        vdevCount = 0;
-        errorVoltageDev = false;
-        return;
-    }
+float getFuseHeat() { return fuse.getHeat(); }
 
-    if (fabs(labV_meas - rampedVset) > VdevLimit) {
-        vdevCount++;
-        if (vdevCount >= VDEV_CYCLES) errorVoltageDev = true;
-    } else {
-        vdevCount = 0;
-        errorVoltageDev = false;
-    }
+uint8_t getShortEvents(ShortDetector::Event* out, uint8_t maxEvents, uint32_t& total) {
+    portENTER_CRITICAL(&shortMux);
+    uint8_t n = min(maxEvents, shortDet.getEventCount());
+    for (uint8_t k = 0; k < n; k++) out[k] = shortDet.getEvent(k);
+    total = shortDet.getTotal();
+    portEXIT_CRITICAL(&shortMux);
+    return n;
 }
 
-// Check current deviation in auto mode
-void checkCurrentDeviation() {
-    if (!modeAuto) return;
-    if (isnan(labI_meas) || isnan(labI_set)) return;
+// Remember the newest conversion under the ALERT level; a trip is timed from it. Samples picked up
+// after the trip are not taken, so a trip landing mid-tick is timed from an earlier one (longer, never shorter).
+void trackInRange(const SensorFrame& frame, bool fresh) {
+    float level = Ina226Manager::getTripLimit();
+    if (!fresh || level < 0.0f || hwTripLatched || !(fabsf(frame.i) < level)) return;
+    inRangeUs = frame.timestampUs;
+    haveInRange = true;
+}
 
-    if (labI_meas > rampedIset * (1.0f + IdevLimit)) {
-        cdevCount++;
-        if (cdevCount >= CDEV_CYCLES) errorCurrentDev = true;
-    } else {
-        cdevCount = 0;
-        errorCurrentDev = false;
+// Time new ALERT trips; track manual enable edges, which clear the ALERT latch once ALERT has released
+void checkHardwareTrip() {
+    // Measured from the last in-range conversion to the ISR's pin write. With averaging the onset can
+    // fall inside that conversion, so the real onset-to-off time may be up to one conversion longer.
+    uint32_t trips = hwTrips;
+    if (trips != hwTripsSeen) {
+        hwTripsSeen = trips;
+        if (haveInRange) {
+            hwLastUs = hwTripUs - inRangeUs;
+            hwMaxUs = max(hwMaxUs, hwLastUs);
+        }
     }
-}
 
-// Check critical errors
-void checkCriticalErrors() {
-    bool criticalError = errorInaInitFail || errorLedcInitFail || errorSensorFail;
-    if (criticalError) {
-        // MOSFET disabled in handleManualMOSFET
+    enableEdge = manualOutputEnable && !lastManualEnable;
+    lastManualEnable = manualOutputEnable;
+    if (enableEdge && hwTripLatched) {
+#if INA226_ALERT_PIN >= 0
+        if (digitalRead(INA226_ALERT_PIN) == HIGH) hwTripLatched = false;
+#else
+        hwTripLatched = false;
+#endif
     }
 }
 
@@ -162,23 +207,48 @@ void handleManualMOSFET() {
         return;
     }
 
-    bool hasError = tempFaultActive || errorFuseBlown || errorOverCurrent ||
-                    errorOverPower || errorVoutOverLimit || errorVoltageDev ||
-                    errorCurrentDev || errorSensorFail ||
-                    errorInaInitFail || errorLedcInitFail;
-
-    if (!hasError) {
+    if (!tripBits) {
         setProtectionMosfet(true);
     } else {
         setProtectionMosfet(false);
         manualOutputEnable = false;
+        if (fuseTiming) {
+            fuseTiming = false;
+            swLastUs = micros() - fuseOverStartUs;
+            swMaxUs = max(swMaxUs, swLastUs);
+            swTrips++;
+        }
     }
 }
 
-// Control MOSFET state
+// Control MOSFET state; mock and trace sources run the logic with the output held off
 void setProtectionMosfet(bool enabled) {
+    enabled = enabled && !hwTripLatched;
     outputActive = enabled;
-    digitalWrite(PROTECTION_MOSFET_PIN, enabled ? HIGH : LOW);
+    digitalWrite(PROTECTION_MOSFET_PIN, enabled && SensorSource::isHardware() ? HIGH : LOW);
+    // An ALERT landing between the check and the write must win
+    if (enabled && hwTripLatched) {
+        outputActive = false;
+        digitalWrite(PROTECTION_MOSFET_PIN, LOW);
+    }
+}
+
+// ALERT ISR: output off with one register write, then latch for the control task
+void IRAM_ATTR hardwareTrip() {
+    GPIO.out_w1tc = 1UL << PROTECTION_MOSFET_PIN;
+    hwTripUs = micros();
+    hwTripLatched = true;
+    outputActive = false;
+    hwTrips = hwTrips + 1;
+}
+
+void getTripStats(TripStats& out) {
+    out.hwTrips = hwTrips;
+    out.hwLastUs = hwLastUs;
+    out.hwMaxUs = hwMaxUs;
+    out.swTrips = swTrips;
+    out.swLastUs = swLastUs;
+    out.swMaxUs = swMaxUs;
 }
 
 } // namespace OutputControl
@@ -2,24 +2,37 @@
 
 #include "Globals.h"
 #include "Config.h"
+#include "SensorSource.h"
+#include "ShortDetector.h"
 
 namespace OutputControl {
+  // Overcurrent trip latency statistics
+  struct TripStats {
+    uint32_t hwTrips;     // INA226 ALERT trips since boot
+    uint32_t hwLastUs;    // Last conversion under the ALERT level to MOSFET off, last trip (us)
+    uint32_t hwMaxUs;     // Same, worst case since boot (us)
+    uint32_t swTrips;     // Software fuse trips since boot
+    uint32_t swLastUs;    // Start of the over-limit stretch to MOSFET off, last trip (us)
+    uint32_t swMaxUs;     // Same, worst case (us)
+  };
+
   void begin();
-  void update();
-  void readNTCTemperature();
-  void checkTemperature();
-  void checkFuse();
-  void checkSystemLimits();
-  void checkVoltageDeviation();
-  void checkCurrentDeviation();
-  void checkCriticalErrors();
-  void checkManualEnable();
-  void checkManualDisable();
+  void reset();                   // Startup delay, fuse, short predictor, NTC, thermal and protection state (control task)
+  void update(const SensorFrame& frame, bool fresh); // Control tick; fresh = new conversion in frame
+  void readNTCTemperature(float voltage);
+  void stepFuse();                // Advance the I²t fuse model
+  void checkHardwareTrip();       // ALERT trip timing, manual enable edges and the ALERT latch
+  void trackInRange(const SensorFrame& frame, bool fresh); // Last conversion under the ALERT level, for trip timing
   void setProtectionMosfet(bool enabled);
   bool isProtectionMosfetOn();
   void handleError(const char* errorMsg);
   void resetErrors();
   void resetTempFault();
+  void hardwareTrip();            // ALERT ISR: drop the MOSFET pin and latch the trip (IRAM)
+  void getTripStats(TripStats& out);
+  float getFuseHeat();            // I²t fuse heat (0 cold, 1 opens)
+  // Copy logged short-circuit events, newest first; returns the count, total = events since boot
+  uint8_t getShortEvents(ShortDetector::Event* out, uint8_t maxEvents, uint32_t& total);
 
   // Новая функция для ручного MOSFET
   void handleManualMOSFET();
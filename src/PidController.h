@@ -0,0 +1,137 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include "FixedPoint.h"
+
+// Generic PID controller with compile-time policies.
+//
+// Traits must provide:
+//   typedef <Math> Math;                         numeric policy (PidFloatMath, PidQ16Math)
+//   static constexpr bool derivativeOnMeasurement; D acts on -measurement instead of error
+//   static constexpr PidAntiWindup antiWindup;      integral windup strategy
+//   static constexpr bool clampOutput;              clamp output to setOutputLimits()
+//
+// Features a variant does not enable are removed at compile time.
+
+// Float numeric policy
+struct PidFloatMath {
+  typedef float value_type;
+  static value_type from(float v) { return v; }
+  static float to(value_type v) { return v; }
+  static value_type add(value_type a, value_type b) { return a + b; }
+  static value_type neg(value_type a) { return -a; }
+  static value_type mul(value_type a, value_type b) { return a * b; }
+};
+
+// Q16.16 fixed-point numeric policy
+struct PidQ16Math {
+  typedef q16_t value_type;
+  static value_type from(float v) { return toQ16(v); }
+  static float to(value_type v) { return fromQ16(v); }
+  static value_type add(value_type a, value_type b) { return q16Add(a, b); }
+  static value_type neg(value_type a) { return q16Neg(a); }
+  static value_type mul(value_type a, value_type b) { return q16Mul(a, b); }
+};
+
+// Integral windup strategies
+enum class PidAntiWindup : uint8_t {
+  None,            // Integral is unbounded
+  Clamp,           // Integral clamped to +/- integral limit
+  ClampAndUnwind   // Clamp, plus unwind() backs out the last step while the actuator saturates
+};
+
+template <typename Traits>
+class PidController {
+public:
+  typedef typename Traits::Math Math;
+  typedef typename Math::value_type value_type;
+
+  // Set gains; dt-scaled gains are rebuilt only when an argument changed
+  void configure(float kp, float ki, float kd, float integralLimit, float dt) {
+    if (kp == appliedKp && ki == appliedKi && kd == appliedKd &&
+        integralLimit == appliedLimit && dt == appliedDt) return;
+    appliedKp = kp;
+    appliedKi = ki;
+    appliedKd = kd;
+    appliedLimit = integralLimit;
+    appliedDt = dt;
+    gainP = Math::from(kp);
+    gainIDt = Math::from(ki * dt);
+    gainDDivDt = Math::from(kd / dt);
+    intLimit = Math::from(integralLimit);
+  }
+
+  // Output limits (used when Traits::clampOutput)
+  void setOutputLimits(float lo, float hi) {
+    outMin = Math::from(lo);
+    outMax = Math::from(hi);
+  }
+
+  // One PID step; measurement is only used for derivative-on-measurement
+  float update(float error, float measurement = 0.0f) {
+    value_type e = Math::from(error);
+    value_type p = Math::mul(gainP, e);
+
+    integral = Math::add(integral, Math::mul(gainIDt, e));
+    if constexpr (Traits::antiWindup != PidAntiWindup::None) {
+      if (integral > intLimit) integral = intLimit;
+      else if (integral < -intLimit) integral = -intLimit;
+    }
+
+    if constexpr (Traits::derivativeOnMeasurement) {
+      value_type m = Math::from(measurement);
+      derivative = Math::mul(gainDDivDt, Math::add(prevMeasurement, Math::neg(m)));
+      prevMeasurement = m;
+    } else {
+      derivative = Math::mul(gainDDivDt, Math::add(e, Math::neg(prevError)));
+    }
+    prevError = e;
+
+    value_type out = Math::add(Math::add(p, integral), derivative);
+    if constexpr (Traits::clampOutput) {
+      if (out > outMax) out = outMax;
+      else if (out < outMin) out = outMin;
+    }
+    return Math::to(out);
+  }
+
+  // Undo the last integral step while the actuator is saturated in the error direction
+  void unwind(bool atMax, bool atMin) {
+    static_assert(Traits::antiWindup == PidAntiWindup::ClampAndUnwind, "unwind() needs ClampAndUnwind");
+    value_type step = Math::mul(gainIDt, prevError);
+    if (atMax && prevError > 0) {
+      integral = Math::add(integral, Math::neg(step));
+      if (integral < -intLimit) integral = -intLimit;
+    }
+    if (atMin && prevError < 0) {
+      integral = Math::add(integral, Math::neg(step));
+      if (integral > intLimit) integral = intLimit;
+    }
+  }
+
+  void resetIntegral() { integral = 0; }          // Clear integral term
+  void halveIntegral() { integral /= 2; }         // Halve integral term
+  void reset() { integral = prevError = prevMeasurement = derivative = 0; } // Clear all state
+
+  float getIntegral() const { return Math::to(integral); }     // Integral term
+  float getPrevError() const { return Math::to(prevError); }   // Last error
+  float getDerivative() const { return Math::to(derivative); } // Derivative term
+
+private:
+  float appliedKp = NAN;      // Settings the gains were built from
+  float appliedKi = NAN;
+  float appliedKd = NAN;
+  float appliedLimit = NAN;
+  float appliedDt = NAN;
+  value_type gainP = 0;       // Kp
+  value_type gainIDt = 0;     // Ki * dt
+  value_type gainDDivDt = 0;  // Kd / dt
+  value_type intLimit = 0;    // Integral limit
+  value_type outMin = 0;      // Output limits (clampOutput)
+  value_type outMax = 0;
+  value_type integral = 0;        // Integral term
+  value_type prevError = 0;       // Previous error
+  value_type prevMeasurement = 0; // Previous measurement (derivativeOnMeasurement)
+  value_type derivative = 0;      // Derivative term
+};
@@ -1,13 +1,20 @@
 #include "PreferencesManager.h"
 #include "Globals.h"
+#include "Calibration.h"
+#include "FeedForward.h"
 #include <Preferences.h>
 
 namespace PreferencesManager {
 
 Preferences prefs;                // NVS instance
 static LabSettings lastSavedSettings; // Last saved settings
+static Calibration::Table lastSavedCal;  // Last saved calibration
+static FeedForward::Table lastSavedFf;   // Last saved feed-forward table
+static uint32_t lastFfEdits = 0;         // FeedForward::getEdits() at the last check
 static unsigned long lastChangeTime = 0; // Last change timestamp
+static unsigned long lastFfSaveTime = 0; // Last feed-forward save
 constexpr unsigned long SAVE_DELAY_MS = 3000; // Save delay (ms)
+constexpr unsigned long FF_SAVE_INTERVAL_MS = 600000; // Learned feed-forward save interval (ms)
 
 // NVS namespace
 #define PREFS_NAMESPACE "lab_psu"
@@ -34,7 +41,21 @@ void initDefaults() {
   strncpy(lastSavedSettings.wifiPass, "RememberToChange!7", sizeof(lastSavedSettings.wifiPass) - 1);
   lastSavedSettings.wifiPass[sizeof(lastSavedSettings.wifiPass) - 1] = '\0';
   lastSavedSettings.otaEnabled = true;
-  lastSavedSettings.settingsVersion = 1;
+  lastSavedSettings.gainSchedEnabled = false;
+  lastSavedSettings.gainTable = GainSchedule::defaultTable();
+  lastSavedSettings.feedForwardEnabled = false;
+  lastSavedSettings.rampProfile = 0;
+  lastSavedSettings.rampRateV = 0.003f;
+  lastSavedSettings.rampRateI = 0.0003f;
+  lastSavedSettings.rampAccelMs = 100.0f;
+  lastSavedSettings.rampTauMs = 100.0f;
+  lastSavedSettings.inaProfile = 1;
+  lastSavedSettings.fuseCurve = 0;
+  lastSavedSettings.fuseTauS = 0.3f;
+  lastSavedSettings.fusePeak = 5.0f;
+  lastSavedSettings.shortSlopeAms = 0.05f;
+  lastSavedSettings.shortCollapse = 0.2f;
+  lastSavedSettings.settingsVersion = 9;
 
   apply(lastSavedSettings);
 }
@@ -61,6 +82,20 @@ void apply(const LabSettings& settings) {
   strncpy(wifiPass, settings.wifiPass, sizeof(wifiPass) - 1);
   wifiPass[sizeof(wifiPass) - 1] = '\0';
   otaEnabled = settings.otaEnabled;
+  gainScheduleEnabled = settings.gainSchedEnabled;
+  if (!GainSchedule::setTable(settings.gainTable)) GainSchedule::setTable(GainSchedule::defaultTable());
+  feedForwardEnabled = settings.feedForwardEnabled;
+  rampProfile = settings.rampProfile;
+  rampRateV = settings.rampRateV;
+  rampRateI = settings.rampRateI;
+  rampAccelMs = settings.rampAccelMs;
+  rampTauMs = settings.rampTauMs;
+  inaProfile = settings.inaProfile;
+  fuseCurve = settings.fuseCurve;
+  fuseTauS = settings.fuseTauS;
+  fusePeak = settings.fusePeak;
+  shortSlopeAms = settings.shortSlopeAms;
+  shortCollapse = settings.shortCollapse;
   settingsVersion = settings.settingsVersion; // Sync settings version
 }
 
@@ -73,11 +108,30 @@ void begin() {
     prefs.putBytes("settings", &lastSavedSettings, sizeof(LabSettings));
   }
   apply(lastSavedSettings);
+
+  // Calibration lives under its own key so settings version resets keep it
+  len = prefs.getBytes("cal", &lastSavedCal, sizeof(lastSavedCal));
+  if (len != sizeof(lastSavedCal) || !Calibration::setTable(lastSavedCal)) {
+    lastSavedCal = Calibration::defaultTable();
+    Calibration::setTable(lastSavedCal);
+  }
+
+  // So does the learned feed-forward table, which also changes too often for the settings debounce
+  len = prefs.getBytes("ff", &lastSavedFf, sizeof(lastSavedFf));
+  if (len != sizeof(lastSavedFf) || !FeedForward::setTable(lastSavedFf)) {
+    lastSavedFf = FeedForward::defaultTable();
+    FeedForward::setTable(lastSavedFf);
+  }
+  lastFfEdits = FeedForward::getEdits();
+  lastFfSaveTime = millis();
 }
 
 // Save settings to NVS
 void save() {
   prefs.putBytes("settings", &lastSavedSettings, sizeof(LabSettings));
+  prefs.putBytes("cal", &lastSavedCal, sizeof(lastSavedCal));
+  prefs.putBytes("ff", &lastSavedFf, sizeof(lastSavedFf));
+  lastFfSaveTime = millis();
   needSave = false; // Use global needSave
 }
 
@@ -106,14 +160,48 @@ void update() {
   strncpy(current.wifiPass, wifiPass, sizeof(current.wifiPass) - 1);
   current.wifiPass[sizeof(current.wifiPass) - 1] = '\0';
   current.otaEnabled = otaEnabled;
+  current.gainSchedEnabled = gainScheduleEnabled;
+  current.gainTable = GainSchedule::getTable();
+  current.feedForwardEnabled = feedForwardEnabled;
+  current.rampProfile = rampProfile;
+  current.rampRateV = rampRateV;
+  current.rampRateI = rampRateI;
+  current.rampAccelMs = rampAccelMs;
+  current.rampTauMs = rampTauMs;
+  current.inaProfile = inaProfile;
+  current.fuseCurve = fuseCurve;
+  current.fuseTauS = fuseTauS;
+  current.fusePeak = fusePeak;
+  current.shortSlopeAms = shortSlopeAms;
+  current.shortCollapse = shortCollapse;
   current.settingsVersion = settingsVersion;
 
-  if (memcmp(&current, &lastSavedSettings, sizeof(LabSettings)) != 0) {
+  const Calibration::Table& cal = Calibration::getTable();
+  if (memcmp(&current, &lastSavedSettings, sizeof(LabSettings)) != 0 ||
+      memcmp(&cal, &lastSavedCal, sizeof(lastSavedCal)) != 0) {
     lastSavedSettings = current;
+    lastSavedCal = cal;
     lastChangeTime = millis();
     needSave = true; // Use global needSave
   }
 
+  // Feed-forward: a replaced table saves with the settings, learned drift at most every FF_SAVE_INTERVAL_MS
+  FeedForward::Table ff;
+  FeedForward::getTable(ff);
+  uint32_t ffEdits = FeedForward::getEdits();
+  if (ffEdits != lastFfEdits) {
+    lastFfEdits = ffEdits;
+    lastSavedFf = ff;
+    lastChangeTime = millis();
+    needSave = true;
+  } else if (millis() - lastFfSaveTime >= FF_SAVE_INTERVAL_MS) {
+    if (memcmp(&ff, &lastSavedFf, sizeof(lastSavedFf)) != 0) {
+      lastSavedFf = ff;
+      prefs.putBytes("ff", &lastSavedFf, sizeof(lastSavedFf));
+    }
+    lastFfSaveTime = millis();
+  }
+
   if (needSave && (millis() - lastChangeTime >= SAVE_DELAY_MS)) {
     save();
   }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "GainSchedule.h"
 
 // Preferences manager for saving and loading system settings to NVS
 struct LabSettings {
@@ -22,6 +23,20 @@ struct LabSettings {
   char wifiSSID[32];       // WiFi SSID
   char wifiPass[32];       // WiFi password
   bool otaEnabled;         // OTA enabled
+  bool gainSchedEnabled;   // Gain scheduling enabled
+  GainSchedule::Table gainTable; // Gain schedule table
+  bool feedForwardEnabled; // Duty feed-forward enabled
+  uint8_t rampProfile;     // Setpoint slew profile
+  float rampRateV;         // Voltage slew rate (V/ms)
+  float rampRateI;         // Current slew rate (A/ms)
+  float rampAccelMs;       // S-curve acceleration time (ms)
+  float rampTauMs;         // Exponential time constant (ms)
+  uint8_t inaProfile;      // INA226 acquisition profile
+  uint8_t fuseCurve;       // I²t blow curve
+  float fuseTauS;          // Custom curve time constant (s)
+  float fusePeak;          // Custom curve instant-open multiple
+  float shortSlopeAms;     // Short predictor dI/dt threshold (A/ms)
+  float shortCollapse;     // Short predictor voltage collapse (fraction)
   uint8_t settingsVersion; // Settings version
 };
 
@@ -0,0 +1,105 @@
+#include "Profiler.h"
+
+namespace Profiler {
+
+constexpr uint32_t WINDOW_MS = 1000;   // Statistics window
+constexpr uint8_t SUB_BITS = 2;        // Histogram bins per octave = 1 << SUB_BITS
+constexpr uint8_t OCTAVES = 22;        // Covers up to ~4 s per call
+constexpr uint8_t BINS = OCTAVES << SUB_BITS;
+
+// Accumulators for the running window
+struct Accum {
+  uint32_t calls;
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t sumUs;
+  uint16_t hist[BINS];  // Log-linear histogram of call time (us)
+};
+
+static Accum accum[SLOT_COUNT];        // Running window
+static Snapshot snapshot;              // Last completed window
+static uint32_t windowStartMs = 0;     // Running window start
+static uint32_t loops = 0;             // loop() iterations in window
+static uint32_t loopMaxUs = 0;         // Longest iteration in window
+static uint32_t lastLoopCycles = 0;    // Cycle count at last beginLoop()
+static bool started = false;           // lastLoopCycles valid
+
+// Log-linear bin: octave of the value plus SUB_BITS of mantissa
+static uint8_t binOf(uint32_t us) {
+  if (us < (1u << SUB_BITS)) return us;
+  uint8_t msb = 31 - __builtin_clz(us);
+  uint32_t bin = ((msb - SUB_BITS + 1) << SUB_BITS) | ((us >> (msb - SUB_BITS)) & ((1u << SUB_BITS) - 1));
+  return bin < BINS ? bin : BINS - 1;
+}
+
+// Upper edge of a bin (us)
+static uint32_t binUpperUs(uint8_t bin) {
+  if (bin < (1u << SUB_BITS)) return bin;
+  uint8_t octave = (bin >> SUB_BITS) + SUB_BITS - 1;
+  uint32_t mantissa = (bin & ((1u << SUB_BITS) - 1)) + (1u << SUB_BITS) + 1;
+  return (mantissa << (octave - SUB_BITS)) - 1;
+}
+
+// Close the window into the snapshot and start a new one
+static void rollWindow(uint32_t now) {
+  uint32_t elapsed = now - windowStartMs;
+  snapshot.loopHz = elapsed ? loops * 1000.0f / elapsed : 0.0f;
+  snapshot.loopMaxUs = loopMaxUs;
+
+  for (uint8_t s = 0; s < SLOT_COUNT; s++) {
+    Accum& a = accum[s];
+    ModuleStats& m = snapshot.module[s];
+    m.calls = a.calls;
+    m.minUs = a.calls ? a.minUs : 0;
+    m.maxUs = a.maxUs;
+    m.avgUs = a.calls ? (uint32_t)(a.sumUs / a.calls) : 0;
+    m.p99Us = 0;
+    uint32_t rank = a.calls - a.calls / 100;  // Calls at or below p99
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < BINS && a.calls; b++) {
+      seen += a.hist[b];
+      if (seen >= rank) {
+        m.p99Us = min(binUpperUs(b), a.maxUs);
+        break;
+      }
+    }
+    a = {};
+    a.minUs = UINT32_MAX;
+  }
+
+  windowStartMs = now;
+  loops = 0;
+  loopMaxUs = 0;
+}
+
+void beginLoop() {
+  uint32_t cycles = ESP.getCycleCount();
+  uint32_t now = millis();
+  if (!started) {
+    started = true;
+    windowStartMs = now;
+    for (Accum& a : accum) a.minUs = UINT32_MAX;
+  } else {
+    uint32_t us = (cycles - lastLoopCycles) / ESP.getCpuFreqMHz();
+    if (us > loopMaxUs) loopMaxUs = us;
+    loops++;
+  }
+  lastLoopCycles = cycles;
+  if (now - windowStartMs >= WINDOW_MS) rollWindow(now);
+}
+
+void record(Slot slot, uint32_t cycles) {
+  if (slot >= SLOT_COUNT) return;
+  uint32_t us = cycles / ESP.getCpuFreqMHz();
+  Accum& a = accum[slot];
+  a.calls++;
+  a.sumUs += us;
+  if (us < a.minUs) a.minUs = us;
+  if (us > a.maxUs) a.maxUs = us;
+  uint16_t& h = a.hist[binOf(us)];
+  if (h < UINT16_MAX) h++;
+}
+
+const Snapshot& getSnapshot() { return snapshot; }
+
+} // namespace Profiler
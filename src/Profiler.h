@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Per-module loop() profiler: cycle-counter timing with 1 s statistics windows
+namespace Profiler {
+
+// Profiled loop() modules
+enum Slot : uint8_t {
+  SLOT_ENCODER,
+  SLOT_INA226,
+  SLOT_CONTROL_POLL,
+  SLOT_TOUCH,
+  SLOT_WIFI_OTA,
+  SLOT_WEB,
+  SLOT_DISPLAY,
+  SLOT_PREFS,
+  SLOT_TRACE,
+  SLOT_BLACKBOX,
+  SLOT_COUNT
+};
+
+// Timing of one module over the last window (us)
+struct ModuleStats {
+  uint32_t calls;   // Calls in window
+  uint32_t minUs;   // Fastest call
+  uint32_t avgUs;   // Mean call
+  uint32_t maxUs;   // Slowest call
+  uint32_t p99Us;   // 99th percentile (upper edge of its histogram bin, <= 25% high)
+};
+
+// Last completed window
+struct Snapshot {
+  float loopHz;                   // loop() iterations per second
+  uint32_t loopMaxUs;             // Longest loop() iteration
+  ModuleStats module[SLOT_COUNT]; // Per-module timing
+};
+
+void beginLoop();                          // Mark the start of a loop() iteration
+void record(Slot slot, uint32_t cycles);   // Add one timed call
+const Snapshot& getSnapshot();             // Last completed window (loop task only)
+
+// Time one call of fn
+template <typename Fn>
+inline void run(Slot slot, Fn fn) {
+  uint32_t start = ESP.getCycleCount();
+  fn();
+  record(slot, ESP.getCycleCount() - start);
+}
+
+} // namespace Profiler
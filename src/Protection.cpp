@@ -0,0 +1,129 @@
+#include "Protection.h"
+#include "Globals.h"
+#include "FuseModel.h"
+#include "ErrMgr.h"
+#include <esp_cpu.h>
+
+namespace Protection {
+
+// Constant limits referenced by rules
+static const float ONE = 1.0f;
+static const float SENSOR_MIN_C = 0.0f;    // Plausible NTC range
+static const float SENSOR_MAX_C = 100.0f;
+static const float FUSE_HYST = 1.0f - FuseModel::RESET_HEAT;
+
+// Protection rules; adding a protection is one row (plus a Signal if it needs a new input)
+static constexpr Rule RULES[] = {
+  // signal            cmp           limit            high           hyst        ms   gate           latch               bit
+  {Signal::Junction, Cmp::AtLeast, &tempLimitC,     nullptr,       &tempDiffC,  105, Gate::Always,  Latch::None,         ErrMgr::Overheat},
+  {Signal::Current,  Cmp::Above,   &systemIlimitMax, nullptr,      nullptr,       0, Gate::Running, Latch::None,         ErrMgr::OverCurrent},
+  {Signal::FuseHeat, Cmp::AtLeast, &ONE,            nullptr,       &FUSE_HYST,    0, Gate::Always,  Latch::None,         ErrMgr::FuseBlown},
+  {Signal::Temp,     Cmp::Outside, &SENSOR_MIN_C,   &SENSOR_MAX_C, nullptr,       0, Gate::Always,  Latch::None,         ErrMgr::SensorFail},
+  {Signal::Voltage,  Cmp::Outside, &systemVoutMin,  &systemVoutMax, nullptr,      0, Gate::Running, Latch::None,         ErrMgr::VoutOverLimit},
+  {Signal::Power,    Cmp::Above,   &systemPowerMax, nullptr,       nullptr,       0, Gate::Running, Latch::None,         ErrMgr::OverPower},
+  {Signal::VDev,     Cmp::Above,   &VdevLimit,      nullptr,       nullptr,     105, Gate::AutoCV,  Latch::None,         ErrMgr::VoltageDev},
+  {Signal::IDevRel,  Cmp::Above,   &IdevLimit,      nullptr,       nullptr,     105, Gate::Auto,    Latch::None,         ErrMgr::CurrentDev},
+  {Signal::HwTrip,   Cmp::AtLeast, &ONE,            nullptr,       nullptr,       0, Gate::Always,  Latch::UntilEnable,  ErrMgr::HwOverCurrent},
+  {Signal::ShortTrip, Cmp::AtLeast, &ONE,           nullptr,       nullptr,       0, Gate::Always,  Latch::UntilEnable,  ErrMgr::ShortCircuit},
+};
+static constexpr uint8_t RULE_COUNT = sizeof(RULES) / sizeof(RULES[0]);
+
+// Error bits owned by the table, and bits set elsewhere that also cut the output
+static constexpr uint32_t ownedBits() {
+  uint32_t m = 0;
+  for (const Rule& r : RULES) m |= 1UL << r.bit;
+  return m;
+}
+static constexpr uint32_t OWNED = ownedBits();
+static constexpr uint32_t EXTERNAL_TRIP = (1UL << ErrMgr::InaInitFail) | (1UL << ErrMgr::LedcInitFail);
+
+static_assert(RULE_COUNT <= 32, "One error bit per rule at most");
+static_assert((OWNED & EXTERNAL_TRIP) == 0, "External trip bits are not written by the table");
+
+struct RuleState {
+  uint16_t count;        // Consecutive ticks in violation
+  bool active;           // Rule tripped
+};
+
+static RuleState state[RULE_COUNT];
+static uint16_t debounceTicks[RULE_COUNT];   // Ticks per rule for the current period
+static uint32_t lastCycles = 0;              // evaluate() run time (CPU cycles)
+static uint32_t maxCycles = 0;
+
+void setPeriod(uint32_t periodUs) {
+  for (uint8_t n = 0; n < RULE_COUNT; n++) {
+    uint32_t ticks = (RULES[n].debounceMs * 1000UL + periodUs / 2) / periodUs;
+    debounceTicks[n] = ticks ? (uint16_t)min(ticks, (uint32_t)UINT16_MAX) : 1;
+  }
+}
+
+void reset() {
+  for (RuleState& st : state) st = {};
+  ErrMgr::assign(OWNED, 0);
+}
+
+// Limit check; a tripped rule holds until the signal clears the limit by its hysteresis. NaN never violates.
+static bool violates(const Rule& r, float s, bool active) {
+  float h = active && r.hyst ? *r.hyst : 0.0f;
+  switch (r.cmp) {
+    case Cmp::Above:   return s > *r.limit - h;
+    case Cmp::AtLeast: return s >= *r.limit - h;
+    case Cmp::Outside: return s < *r.limit + h || s > *r.high - h;
+  }
+  return false;
+}
+
+uint32_t evaluate(const Inputs& in) {
+  uint32_t start = esp_cpu_get_cycle_count();
+
+  float sig[(uint8_t)Signal::Count];
+  sig[(uint8_t)Signal::Temp] = labTemp_ntc;
+  sig[(uint8_t)Signal::Junction] = in.junctionC;
+  sig[(uint8_t)Signal::Voltage] = labV_meas;
+  sig[(uint8_t)Signal::Current] = labI_meas;
+  sig[(uint8_t)Signal::Power] = labQ_meas;
+  sig[(uint8_t)Signal::VDev] = fabsf(labV_meas - rampedVset);
+  sig[(uint8_t)Signal::IDevRel] = labI_meas / rampedIset - 1.0f; // Iset 0: any current is a deviation
+  sig[(uint8_t)Signal::FuseHeat] = in.fuseHeat;
+  sig[(uint8_t)Signal::HwTrip] = in.hwTrip ? 1.0f : 0.0f;
+  sig[(uint8_t)Signal::ShortTrip] = in.shortTrip ? 1.0f : 0.0f;
+
+  bool gate[(uint8_t)Gate::Count];
+  gate[(uint8_t)Gate::Always] = true;
+  gate[(uint8_t)Gate::Running] = !in.starting;
+  gate[(uint8_t)Gate::Auto] = modeAuto;
+  gate[(uint8_t)Gate::AutoCV] = modeAuto && !in.starting && !isCC;
+
+  uint32_t bits = 0;
+  for (uint8_t n = 0; n < RULE_COUNT; n++) {
+    const Rule& r = RULES[n];
+    RuleState& st = state[n];
+    bool open = gate[(uint8_t)r.gate];
+    if (open && violates(r, sig[(uint8_t)r.signal], st.active)) {
+      if (st.count < debounceTicks[n]) st.count++;
+      if (st.count >= debounceTicks[n]) st.active = true;
+    } else {
+      st.count = 0;
+      if (!open || r.latch == Latch::None || in.enableEdge) st.active = false;
+    }
+    if (st.active) bits |= 1UL << r.bit;
+  }
+
+  ErrMgr::assign(OWNED, bits);
+  bits |= ErrMgr::active() & EXTERNAL_TRIP;
+
+  uint32_t cycles = esp_cpu_get_cycle_count() - start;
+  lastCycles = cycles;
+  if (cycles > maxCycles) maxCycles = cycles;
+  return bits;
+}
+
+uint8_t getRuleCount() { return RULE_COUNT; }
+
+void getTiming(float& lastUs, float& maxUs) {
+  float mhz = ESP.getCpuFreqMHz();
+  lastUs = lastCycles / mhz;
+  maxUs = maxCycles / mhz;
+}
+
+} // namespace Protection
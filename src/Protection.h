@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Table-driven protection: each rule compares one signal against a limit and drives one ErrMgr bit
+namespace Protection {
+
+// Values sampled once per tick; rules index into them
+enum class Signal : uint8_t {
+  Temp,        // NTC temperature (°C)
+  Junction,    // Estimated junction temperature (°C)
+  Voltage,     // Measured voltage (V)
+  Current,     // Measured current (A)
+  Power,       // Measured power (W)
+  VDev,        // |V - ramped Vset| (V)
+  IDevRel,     // I / ramped Iset - 1
+  FuseHeat,    // I²t fuse heat (1 = open)
+  HwTrip,      // INA226 ALERT trip latched (0/1)
+  ShortTrip,   // Short-circuit predictor fired this tick (0/1)
+  Count
+};
+
+enum class Cmp : uint8_t {
+  Above,       // signal > limit
+  AtLeast,     // signal >= limit
+  Outside      // signal < limit or signal > high
+};
+
+// When a rule is evaluated; outside its gate the rule is idle and clears
+enum class Gate : uint8_t {
+  Always,
+  Running,     // After the startup delay
+  Auto,        // Automatic mode
+  AutoCV,      // Automatic mode, regulating voltage, after the startup delay
+  Count
+};
+
+enum class Latch : uint8_t {
+  None,        // Clears once the signal is back inside the limit (less hysteresis)
+  UntilEnable  // Also waits for the next manual output enable
+};
+
+// One protection rule
+struct Rule {
+  Signal signal;
+  Cmp cmp;
+  const float* limit;    // Limit (low limit for Outside)
+  const float* high;     // High limit for Outside, else nullptr
+  const float* hyst;     // Band the signal must clear by once tripped, or nullptr
+  uint16_t debounceMs;   // Time the condition must hold (rounded to ticks, at least one)
+  Gate gate;
+  Latch latch;
+  uint8_t bit;           // ErrMgr::Bit the rule drives
+};
+
+// Per-tick state from OutputControl
+struct Inputs {
+  bool starting;         // Startup delay still running
+  bool enableEdge;       // Manual output enable went on this tick
+  float junctionC;       // Estimated junction temperature (°C)
+  float fuseHeat;        // I²t fuse heat
+  bool hwTrip;           // ALERT trip latched
+  bool shortTrip;        // Short-circuit predictor fired
+};
+
+void setPeriod(uint32_t periodUs);  // Rebuild debounce tick counts for a control period
+void reset();                       // Clear debounce counts, tripped rules and their error bits
+uint32_t evaluate(const Inputs& in); // Run all rules, write their ErrMgr bits; returns bits that cut the output
+uint8_t getRuleCount();             // Rules in the table
+void getTiming(float& lastUs, float& maxUs); // evaluate() run time, last and worst (us)
+
+} // namespace Protection
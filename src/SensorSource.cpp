@@ -0,0 +1,125 @@
+#include "SensorSource.h"
+#include "TraceRecorder.h"
+#include "Ina226Manager.h"
+#include "Globals.h"
+#include "Config.h"
+#include "NtcSensor.h"
+#include "ControlTask.h"
+#include <LittleFS.h>
+
+constexpr size_t TRACE_MAX_BYTES_SRAM = 32768;    // Largest trace loaded without PSRAM
+constexpr size_t TRACE_MAX_BYTES_PSRAM = 1048576; // Largest trace loaded into PSRAM
+
+bool HardwareSensorSource::read(SensorFrame& out) {
+  Ina226Manager::Sample s;
+  bool ok = Ina226Manager::getSample(s);
+  out.seq = s.seq;
+  out.timestampUs = s.timestampUs;
+  out.v = s.v;
+  out.i = s.i;
+  out.p = s.p;
+  out.ntcV = NtcSensor::readVolts();
+  return ok;
+}
+
+void MockSensorSource::set(float newV, float newI, float newNtcV) {
+  portENTER_CRITICAL(&mux);
+  v = newV;
+  i = newI;
+  ntcV = newNtcV;
+  portEXIT_CRITICAL(&mux);
+}
+
+bool MockSensorSource::read(SensorFrame& out) {
+  portENTER_CRITICAL(&mux);
+  out.v = v;
+  out.i = i;
+  out.ntcV = ntcV;
+  portEXIT_CRITICAL(&mux);
+  if (++seq == 0) seq = 1;
+  out.seq = seq;
+  out.timestampUs = micros();
+  out.p = out.v * out.i;
+  return true;
+}
+
+bool TraceSensorSource::open(const char* path) {
+  if (SensorSource::getKind() == SensorSource::Kind::Trace) return false;
+  File f = LittleFS.open(path, "r");
+  if (!f) return false;
+
+  TraceHeader header;
+  size_t body = f.size() > sizeof(header) ? f.size() - sizeof(header) : 0;
+  size_t limit = psramFound() ? TRACE_MAX_BYTES_PSRAM : TRACE_MAX_BYTES_SRAM;
+  if (f.read((uint8_t*)&header, sizeof(header)) != sizeof(header) || header.magic != TraceRecorder::MAGIC ||
+      header.version != TraceRecorder::VERSION || header.recordSize != sizeof(TraceRecord)) {
+    f.close();
+    return false;
+  }
+  uint32_t n = min(body, limit) / sizeof(TraceRecord);
+
+  free(records);
+  records = (TraceRecord*)(psramFound() ? ps_malloc(n * sizeof(TraceRecord)) : malloc(n * sizeof(TraceRecord)));
+  count = 0;
+  if (records && n) count = f.read((uint8_t*)records, n * sizeof(TraceRecord)) / sizeof(TraceRecord);
+  f.close();
+  rewind();
+  return count > 0;
+}
+
+void TraceSensorSource::rewind() {
+  next = 0;
+  playheadUs = 0;
+  started = false;
+  current = {};
+}
+
+// Advance the playhead by one control period and apply every record it passed
+bool TraceSensorSource::read(SensorFrame& out) {
+  bool first = !started;
+  if (started) playheadUs += controlPeriodUs;
+  started = true;
+  while (next < count && records[next].tUs <= playheadUs) {
+    const TraceRecord& r = records[next++];
+    if (r.type == (uint8_t)TraceRecorder::RecordType::Sample) {
+      if (++current.seq == 0) current.seq = 1;
+      current.timestampUs = r.tUs;
+      current.v = r.a;
+      current.i = r.b;
+      current.p = r.a * r.b;
+      current.ntcV = r.c;
+    } else if (r.type == (uint8_t)TraceRecorder::RecordType::Command) {
+      labV_set = r.a;
+      labI_set = r.b;
+      labI_cut = r.c;
+      manualOutputEnable = r.flags & 0x01;
+      modeAuto = r.flags & 0x02;
+    }
+  }
+  // First tick after rewind(), on the control task: start from boot state with the trace's setpoints
+  if (first) ControlTask::restartControlPath();
+  out = current;
+  return current.seq != 0;
+}
+
+namespace SensorSource {
+
+static HardwareSensorSource hardwareSource;
+static MockSensorSource mockSource;
+static TraceSensorSource traceSource;
+static ISensorSource* const sources[(uint8_t)Kind::Count] = {&hardwareSource, &mockSource, &traceSource};
+static volatile Kind kind = Kind::Hardware;
+
+void select(Kind k) {
+  if (k >= Kind::Count) return;
+  if (k == Kind::Trace && kind != Kind::Trace) traceSource.rewind();
+  kind = k;
+}
+
+Kind getKind() { return kind; }
+ISensorSource& active() { return *sources[(uint8_t)kind]; }
+bool isHardware() { return kind == Kind::Hardware; }
+MockSensorSource& mock() { return mockSource; }
+TraceSensorSource& trace() { return traceSource; }
+
+} // namespace SensorSource
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <Arduino.h>
+
+struct TraceRecord;
+
+// One set of sensor readings consumed by a control tick
+struct SensorFrame {
+  uint32_t seq;          // Conversion sequence (0 = none yet); changes with every new INA226 result
+  uint32_t timestampUs;  // Conversion time (us)
+  float v;               // Bus voltage (V)
+  float i;               // Current (A)
+  float p;               // Power (W)
+  float ntcV;            // NTC divider voltage (V)
+};
+
+// Source of sensor frames for the control tick
+class ISensorSource {
+public:
+  virtual ~ISensorSource() = default;
+  virtual bool read(SensorFrame& out) = 0; // Frame for this tick (false before the first conversion)
+  virtual const char* name() const = 0;    // Short name for the UI
+};
+
+// INA226 samples and the NTC ADC
+class HardwareSensorSource : public ISensorSource {
+public:
+  bool read(SensorFrame& out) override;
+  const char* name() const override { return "hardware"; }
+};
+
+// Fixed readings set from the web UI; every tick is a fresh conversion
+class MockSensorSource : public ISensorSource {
+public:
+  void set(float v, float i, float ntcV);
+  bool read(SensorFrame& out) override;
+  const char* name() const override { return "mock"; }
+
+private:
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+  float v = 0.0f;
+  float i = 0.0f;
+  float ntcV = 1.65f;    // About 25 °C with the stock divider
+  uint32_t seq = 0;
+};
+
+// Plays a recorded trace tick by tick: samples feed the control path, commands set the setpoints
+class TraceSensorSource : public ISensorSource {
+public:
+  bool open(const char* path);  // Load a trace file into RAM (loop task, not while playing)
+  void rewind();                // Restart from the first record; the control path restarts with it
+  bool finished() const { return next >= count; }
+  uint32_t getCount() const { return count; }
+  uint32_t getPosition() const { return next; }
+  bool read(SensorFrame& out) override;
+  const char* name() const override { return "trace"; }
+
+private:
+  TraceRecord* records = nullptr;   // Loaded records
+  uint32_t count = 0;          // Records loaded
+  uint32_t next = 0;           // Next record to apply
+  uint32_t playheadUs = 0;     // Trace time reached
+  bool started = false;        // First tick played (it covers t = 0)
+  SensorFrame current = {};    // Last sample applied
+};
+
+// Selection of the source read by the control tick
+namespace SensorSource {
+
+enum class Kind : uint8_t { Hardware, Mock, Trace, Count };
+
+void select(Kind kind);           // Switch source (a trace restarts from its beginning)
+Kind getKind();                   // Selected source
+ISensorSource& active();          // Source for the next tick
+bool isHardware();                // Real sensors selected (output MOSFET may switch)
+MockSensorSource& mock();         // Mock backend
+TraceSensorSource& trace();       // Trace player backend
+
+} // namespace SensorSource
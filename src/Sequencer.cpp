@@ -0,0 +1,140 @@
+#include "Sequencer.h"
+#include "Globals.h"
+#include "Ina226Manager.h"
+
+namespace Sequencer {
+
+enum class Command : uint8_t { None, Start, Stop, Pause, Resume };
+
+static Step steps[MAX_STEPS];            // Programmed steps
+static StepResult results[MAX_STEPS];    // Results of the last pass
+static volatile uint8_t stepCount = 0;   // Loaded steps
+static volatile uint16_t loops = 1;      // Programmed passes (0 = endless)
+
+// Shared with web callers; commands are applied by the control tick
+static volatile State state = State::Idle;
+static volatile Command pending = Command::None;
+
+// Run state (control task only)
+static uint8_t current = 0;        // Step being run
+static uint16_t loopCount = 0;     // Completed passes
+static uint32_t seqStartMs = 0;    // Sequence start
+static uint32_t deadlineMs = 0;    // End of the current step
+static uint32_t remainingMs = 0;   // Dwell left when paused
+static double sumV = 0.0;          // Measurement sums for the current step; double keeps a 655 s
+static double sumI = 0.0;          // dwell of 5 ms conversions exact to well under a count
+static uint32_t samples = 0;
+
+void clear() {
+  if (state == State::Running || state == State::Paused) return;
+  stepCount = 0;
+  state = State::Idle;
+}
+
+bool append(const Step& step) {
+  if (state == State::Running || state == State::Paused) return false;
+  if (stepCount >= MAX_STEPS) return false;
+  steps[stepCount] = step;
+  if (steps[stepCount].dwell10ms == 0) steps[stepCount].dwell10ms = 1; // Zero dwell would spin the tick
+  results[stepCount] = {};
+  stepCount = stepCount + 1;
+  return true;
+}
+
+void setLoops(uint16_t n) { loops = n; }
+
+bool start() {
+  if (stepCount == 0) return false;
+  pending = Command::Start;
+  return true;
+}
+
+void stop() { pending = Command::Stop; }
+void pause() { pending = Command::Pause; }
+void resume() { pending = Command::Resume; }
+
+// Apply a step's setpoints and start its dwell at startMs
+static void enterStep(uint8_t index, uint32_t startMs) {
+  const Step& s = steps[index];
+  current = index;
+  labV_set = constrain(s.mV / 1000.0f, systemVoutMin, systemVoutMax);
+  labI_set = min(s.mA / 1000.0f, systemIlimitMax);
+  labI_cut = min(s.cutmA / 1000.0f, systemIlimitMax);
+  if (s.profile < (uint8_t)Ina226Manager::Profile::Count) inaProfile = s.profile; // Applied by the loop task
+  deadlineMs = startMs + s.dwell10ms * 10UL;
+  results[index].startMs = startMs - seqStartMs;
+  sumV = sumI = 0.0;
+  samples = 0;
+}
+
+// Store averages for the step that just ended
+static void closeStep() {
+  StepResult& r = results[current];
+  r.samples = samples;
+  r.vAvg = samples ? (float)(sumV / samples) : 0.0f;
+  r.iAvg = samples ? (float)(sumI / samples) : 0.0f;
+}
+
+void tick(bool fresh) {
+  uint32_t now = millis();
+
+  switch (pending) {
+    case Command::Start:
+      for (uint8_t i = 0; i < stepCount; i++) results[i] = {};
+      loopCount = 0;
+      seqStartMs = now;
+      enterStep(0, now);
+      state = State::Running;
+      break;
+    case Command::Stop:
+      if (state == State::Running || state == State::Paused) state = State::Idle;
+      break;
+    case Command::Pause:
+      if (state == State::Running) {
+        remainingMs = (int32_t)(deadlineMs - now) > 0 ? deadlineMs - now : 0;
+        state = State::Paused;
+      }
+      break;
+    case Command::Resume:
+      if (state == State::Paused) {
+        deadlineMs = now + remainingMs;
+        state = State::Running;
+      }
+      break;
+    default:
+      break;
+  }
+  pending = Command::None;
+  if (state != State::Running) return;
+
+  // Next steps start at the previous deadline, so dwell errors do not accumulate
+  while ((int32_t)(now - deadlineMs) >= 0) {
+    closeStep();
+    uint8_t next = current + 1;
+    if (next >= stepCount) {
+      loopCount++;
+      if (loops != 0 && loopCount >= loops) {
+        state = State::Done;
+        return;
+      }
+      next = 0;
+    }
+    enterStep(next, deadlineMs);
+  }
+
+  // Ticks between conversions repeat the last one; counting them would weight samples by arrival jitter
+  if (!fresh) return;
+  sumV += labV_meas;
+  sumI += labI_meas;
+  samples++;
+}
+
+State getState() { return state; }
+uint8_t getStepCount() { return stepCount; }
+uint8_t getCurrentStep() { return current; }
+uint16_t getLoop() { return loopCount; }
+uint16_t getLoops() { return loops; }
+const Step& getStep(uint8_t index) { return steps[index < MAX_STEPS ? index : 0]; }
+const StepResult& getResult(uint8_t index) { return results[index < MAX_STEPS ? index : 0]; }
+
+} // namespace Sequencer
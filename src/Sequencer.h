@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+
+// List-mode sequencer: steps Vset/Iset/Icut through a preloaded table at the control tick
+namespace Sequencer {
+
+constexpr uint8_t MAX_STEPS = 64;      // Step buffer size
+constexpr uint8_t KEEP_PROFILE = 0xFF; // Step leaves the INA226 profile unchanged
+
+// One programmed step (10 bytes)
+struct Step {
+  uint16_t mV;         // Voltage setpoint (mV)
+  uint16_t mA;         // Current limit (mA)
+  uint16_t cutmA;      // Fuse current (mA)
+  uint16_t dwell10ms;  // Dwell time (10 ms units)
+  uint8_t profile;     // INA226 acquisition profile, or KEEP_PROFILE
+};
+
+// Measured result of the last pass through a step
+struct StepResult {
+  uint32_t startMs;    // Step start, relative to sequence start (ms)
+  float vAvg;          // Average measured voltage (V)
+  float iAvg;          // Average measured current (A)
+  uint32_t samples;    // Conversions averaged (0 = not run yet)
+};
+
+enum class State : uint8_t { Idle, Running, Paused, Done };
+
+void clear();                   // Drop all steps (not while running)
+bool append(const Step& step);  // Add a step (not while running, false when full)
+void setLoops(uint16_t loops);  // Passes through the table (0 = endless)
+bool start();                   // Start from the first step
+void stop();                    // Stop, keeping the current setpoints
+void pause();                   // Hold the current step and its remaining dwell
+void resume();                  // Continue a paused step
+void tick(bool fresh);          // Control tick: apply steps; fresh = new conversion to average
+
+State getState();               // Current state
+uint8_t getStepCount();         // Loaded steps
+uint8_t getCurrentStep();       // Step being run
+uint16_t getLoop();             // Completed passes
+uint16_t getLoops();            // Programmed passes
+const Step& getStep(uint8_t index);         // Programmed step
+const StepResult& getResult(uint8_t index); // Result of a step
+
+} // namespace Sequencer
@@ -0,0 +1,64 @@
+#include "ShortDetector.h"
+
+namespace ShortDetector {
+
+void Detector::reset() {
+  head = 0;
+  filled = 0;
+}
+
+bool Detector::step(uint32_t timestampUs, float v, float i, float threshold, float iset, const Config& cfg,
+                    uint32_t nowMs) {
+  if (i != i || v != v) return false; // NaN
+  if (filled == 0) {
+    vRef = v;
+  } else {
+    float dtMs = (timestampUs - t[(head + WINDOW - 1) % WINDOW]) * 1e-3f;
+    vRef += (v - vRef) * dtMs / (V_REF_TAU_MS + dtMs);
+  }
+  t[head] = timestampUs;
+  vs[head] = v;
+  is[head] = i;
+  head = (head + 1) % WINDOW;
+  if (filled < WINDOW) filled++;
+  if (cfg.slopeAms <= 0.0f || filled < WINDOW) return false;
+
+  // Oldest sample sits at head once the window is full
+  uint8_t oldest = head;
+  uint8_t newest = (head + WINDOW - 1) % WINDOW;
+  uint32_t spanUs = t[newest] - t[oldest];
+  if (spanUs == 0) return false;
+  float slope = (is[newest] - is[oldest]) * 1000.0f / spanUs; // A/ms
+  if (slope < cfg.slopeAms) return false;
+
+  float drop = vRef > 0.0f ? (vRef - v) / vRef : 0.0f;
+  if (drop < cfg.collapse) return false;
+
+  // A CV->CC transition also pulls V down while I rises, but the current loop turns I back towards
+  // iset. Fire only while I is still rising and either CC has lost it (above iset) or the run-up
+  // reaches the trip level within the horizon.
+  uint8_t prev = (head + WINDOW - 2) % WINDOW;
+  if (is[newest] <= is[prev]) return false;
+  if (i <= iset && i + slope * HORIZON_MS < threshold) return false;
+
+  Event& e = log[logHead];
+  e.timeMs = nowMs;
+  e.slopeAms = slope;
+  e.collapse = drop;
+  e.i = i;
+  e.v = v;
+  e.savedMs = i < threshold ? (threshold - i) / slope : 0.0f; // Linear run-up to the threshold
+  logHead = (logHead + 1) % LOG_SIZE;
+  if (count < LOG_SIZE) count++;
+  total++;
+
+  reset(); // One event per short; the window refills before the next can fire
+  return true;
+}
+
+const Event& Detector::getEvent(uint8_t age) const {
+  if (age >= count) age = 0;
+  return log[(logHead + LOG_SIZE - 1 - age) % LOG_SIZE];
+}
+
+} // namespace ShortDetector
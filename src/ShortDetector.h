@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+// Short-circuit predictor: current rising fast while the output voltage collapses.
+// Plain C++ with no Arduino dependencies, so it builds on the host for trace replay tests.
+namespace ShortDetector {
+
+constexpr uint8_t WINDOW = 4;      // Samples the slopes are taken over
+constexpr uint8_t LOG_SIZE = 8;    // Events kept
+constexpr float V_REF_TAU_MS = 20.0f; // Voltage reference time constant; collapse is measured against it
+constexpr float HORIZON_MS = 50.0f;   // Look-ahead for the current run-up to reach the trip threshold
+
+// Detection thresholds
+struct Config {
+  float slopeAms;      // Minimum dI/dt over the window (A/ms), 0 = detector off
+  float collapse;      // Minimum voltage drop below the slow reference (fraction), 0 = slope alone
+};
+
+// One detected short
+struct Event {
+  uint32_t timeMs;     // Detection time (ms, caller's clock)
+  float slopeAms;      // dI/dt over the window (A/ms)
+  float collapse;      // Voltage drop below the reference (fraction)
+  float i;             // Current at detection (A)
+  float v;             // Voltage at detection (V)
+  float savedMs;       // Estimated lead over the threshold trip (ms)
+};
+
+class Detector {
+public:
+  void reset();        // Forget the window (keeps the event log)
+  // Feed one new sample; threshold (A) is the level the plain overcurrent trip would act at and
+  // iset (A) the current loop's setpoint. Returns true when a short is detected on this sample.
+  bool step(uint32_t timestampUs, float v, float i, float threshold, float iset, const Config& cfg, uint32_t nowMs);
+
+  uint8_t getEventCount() const { return count; }     // Events logged (up to LOG_SIZE)
+  uint32_t getTotal() const { return total; }         // Events since boot
+  const Event& getEvent(uint8_t age) const;           // 0 = newest
+
+private:
+  uint32_t t[WINDOW] = {};
+  float vs[WINDOW] = {};
+  float is[WINDOW] = {};
+  uint8_t head = 0;    // Next write position
+  uint8_t filled = 0;  // Samples in the window
+  float vRef = 0.0f;   // Slow voltage reference (V)
+  Event log[LOG_SIZE] = {};
+  uint8_t logHead = 0;
+  uint8_t count = 0;
+  uint32_t total = 0;
+};
+
+} // namespace ShortDetector
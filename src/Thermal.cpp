@@ -0,0 +1,55 @@
+#include "Thermal.h"
+#include "Globals.h"
+#include "Config.h"
+
+namespace Thermal {
+
+static float alpha = 0.0f;        // Per-tick step of the first-order model
+static float riseC = 0.0f;        // Junction rise above the NTC (°C)
+static float lossW = 0.0f;        // Last dissipation estimate (W)
+static float derate = 1.0f;       // Current/power scale
+
+void setPeriod(uint32_t periodUs) {
+  alpha = 1.0f - expf(-(periodUs * 1e-6f) / THERMAL_TAU_S);
+}
+
+void reset() {
+  riseC = 0.0f;
+  lossW = 0.0f;
+  derate = 1.0f;
+}
+
+// Converter loss for the delivered power plus conduction in the output MOSFET
+static float dissipation() {
+  if (!outputActive || isnan(labV_meas) || isnan(labI_meas)) return 0.0f;
+  float i = fabsf(labI_meas);
+  float pOut = fabsf(labV_meas * labI_meas);
+  return pOut * (1.0f / THERMAL_EFFICIENCY - 1.0f) + i * i * THERMAL_RDS_ON;
+}
+
+void update() {
+  lossW = dissipation();
+  riseC += (lossW * THERMAL_RTH_C_W - riseC) * alpha;
+
+  // Linear from 1 at (trip - span) down to the minimum at (trip - hysteresis), so the
+  // derated steady state settles below the point where the overheat rule would clear again
+  float tj = labTemp_ntc + riseC;
+  float full = tempLimitC - tempDiffC;
+  float start = full - THERMAL_DERATE_SPAN_C;
+  if (tj <= start) derate = 1.0f;
+  else if (tj >= full) derate = THERMAL_DERATE_MIN;
+  else derate = 1.0f - (1.0f - THERMAL_DERATE_MIN) * (tj - start) / THERMAL_DERATE_SPAN_C;
+}
+
+float getJunctionC() { return labTemp_ntc + riseC; }
+float getLossW() { return lossW; }
+float getDerate() { return derate; }
+
+float limitCurrent(float iset) {
+  if (derate >= 1.0f) return iset;
+  float limit = iset * derate;
+  if (labV_meas > 0.5f) limit = min(limit, systemPowerMax * derate / labV_meas);
+  return limit;
+}
+
+} // namespace Thermal
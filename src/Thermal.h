@@ -0,0 +1,16 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Junction temperature estimate and progressive current/power derating toward tempLimitC
+namespace Thermal {
+
+void setPeriod(uint32_t periodUs);  // Rebuild the per-tick model factor for a control period
+void reset();                       // Junction back at the NTC temperature, no derating
+void update();                      // Control tick: step the RC model from labTemp_ntc and the output
+float getJunctionC();               // Estimated junction temperature (°C)
+float getLossW();                   // Estimated dissipation (W)
+float getDerate();                  // Current/power scale (1 = no derating)
+float limitCurrent(float iset);     // Current setpoint after derating (A)
+
+} // namespace Thermal
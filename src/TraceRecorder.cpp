@@ -0,0 +1,158 @@
+#include "TraceRecorder.h"
+#include "Globals.h"
+#include <LittleFS.h>
+
+namespace TraceRecorder {
+
+constexpr uint16_t RING_SIZE = 256;   // Records buffered between the control tick and the loop task
+
+static TraceRecord ring[RING_SIZE];   // Producer: control tick, consumer: loop/web task
+static volatile uint16_t head = 0;    // Next write
+static volatile uint16_t tail = 0;    // Next read
+static volatile bool recording = false;
+static volatile bool stopPending = false;
+static volatile bool loadPending = false;
+static bool mounted = false;          // LittleFS available
+static Dest dest = Dest::Flash;
+static uint32_t clientId = 0;
+static uint32_t startUs = 0;          // Recording start (control tick clock)
+static bool startPending = false;     // First tick after start() not seen yet
+static uint32_t records = 0;
+static uint32_t dropped = 0;
+static TraceHeader header = {};
+static bool headerSent = false;       // Header already written/streamed
+static File file;                     // Flash destination
+
+// Last recorded command state
+static float lastVset = NAN, lastIset = NAN, lastIcut = NAN;
+static uint8_t lastFlags = 0xFF;
+
+void begin(bool fsMounted) {
+  mounted = fsMounted;
+}
+
+bool start(Dest d, uint32_t id) {
+  if (recording || stopPending) return false;
+  if (d == Dest::Flash && !mounted) return false;
+  dest = d;
+  clientId = id;
+  head = tail = 0;
+  records = dropped = 0;
+  header = {MAGIC, VERSION, (uint8_t)sizeof(TraceRecord), 0, controlPeriodUs};
+  headerSent = false;
+  lastVset = lastIset = lastIcut = NAN;
+  lastFlags = 0xFF;
+  startPending = true;
+  recording = true;
+  return true;
+}
+
+void stop() {
+  if (!recording) return;
+  recording = false;
+  stopPending = true;
+}
+
+void requestLoad() { loadPending = true; }
+bool isRecording() { return recording; }
+Dest getDest() { return dest; }
+uint32_t getClientId() { return clientId; }
+uint32_t getRecordCount() { return records; }
+uint32_t getDropped() { return dropped; }
+
+// Queue one record; dropped when the consumer falls behind
+static void push(const TraceRecord& r) {
+  uint16_t h = head;
+  uint16_t n = (h + 1) % RING_SIZE;
+  if (n == tail) {
+    dropped++;
+    return;
+  }
+  ring[h] = r;
+  head = n;
+  records++;
+}
+
+void record(const SensorFrame& frame, bool fresh) {
+  if (!recording) return;
+  uint32_t now = micros();
+  if (startPending) {
+    startPending = false;
+    startUs = now;
+  }
+  uint32_t t = now - startUs;
+
+  // Commands from any input (web, encoder, sequencer) show up as setpoint changes
+  uint8_t flags = (manualOutputEnable ? 0x01 : 0) | (modeAuto ? 0x02 : 0);
+  if (labV_set != lastVset || labI_set != lastIset || labI_cut != lastIcut || flags != lastFlags) {
+    lastVset = labV_set;
+    lastIset = labI_set;
+    lastIcut = labI_cut;
+    lastFlags = flags;
+    push({t, (uint8_t)RecordType::Command, flags, 0, labV_set, labI_set, labI_cut});
+  }
+  if (fresh) push({t, (uint8_t)RecordType::Sample, 0, 0, frame.v, frame.i, frame.ntcV});
+}
+
+size_t drain(uint8_t* out, size_t maxBytes) {
+  size_t used = 0;
+  if (!headerSent) {
+    if (maxBytes < sizeof(header)) return 0;
+    memcpy(out, &header, sizeof(header));
+    used = sizeof(header);
+    headerSent = true;
+  }
+  while (tail != head && used + sizeof(TraceRecord) <= maxBytes) {
+    memcpy(out + used, &ring[tail], sizeof(TraceRecord));
+    used += sizeof(TraceRecord);
+    tail = (tail + 1) % RING_SIZE;
+  }
+  return used;
+}
+
+bool isValidSize(size_t bytes) {
+  return bytes > sizeof(TraceHeader) && (bytes - sizeof(TraceHeader)) % sizeof(TraceRecord) == 0;
+}
+
+size_t freeBytes() {
+  if (!mounted) return 0;
+  size_t total = LittleFS.totalBytes();
+  size_t used = LittleFS.usedBytes();
+  size_t free = total > used ? total - used : 0;
+  File f = LittleFS.open(TRACE_PATH, "r");
+  if (f) {
+    free += f.size();
+    f.close();
+  }
+  return free;
+}
+
+void update() {
+  if (loadPending) {
+    loadPending = false;
+    SensorSource::trace().open(TRACE_PATH);
+  }
+
+  if (dest != Dest::Flash || !mounted) {
+    if (stopPending && tail == head) stopPending = false; // Web task drains the rest
+    return;
+  }
+  if ((recording || stopPending) && !file) {
+    file = LittleFS.open(TRACE_PATH, "w");
+    if (!file) {
+      recording = stopPending = false;
+      return;
+    }
+  }
+  if (!file) return;
+
+  uint8_t buf[sizeof(TraceRecord) * 16];
+  size_t n;
+  while ((n = drain(buf, sizeof(buf))) > 0) file.write(buf, n);
+  if (stopPending) {
+    file.close();
+    stopPending = false;
+  }
+}
+
+} // namespace TraceRecorder
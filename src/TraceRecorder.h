@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Arduino.h>
+#include "SensorSource.h"
+
+// Trace file layout: Header, then Records in time order (little-endian)
+struct TraceHeader {
+  uint32_t magic;        // TraceRecorder::MAGIC
+  uint8_t version;       // TraceRecorder::VERSION
+  uint8_t recordSize;    // sizeof(TraceRecord)
+  uint16_t reserved;
+  uint32_t periodUs;     // Control tick period at recording start (us)
+};
+
+// One timestamped record (20 bytes)
+struct TraceRecord {
+  uint32_t tUs;          // Time since recording start (us)
+  uint8_t type;          // TraceRecorder::RecordType
+  uint8_t flags;         // Command: bit 0 output enable, bit 1 auto mode
+  uint16_t reserved;
+  float a;               // Sample: V       Command: Vset (V)
+  float b;               // Sample: I (A)   Command: Iset (A)
+  float c;               // Sample: NTC V   Command: Icut (A)
+};
+
+// Records sensor frames and user commands from the control tick to flash or a WebSocket client
+namespace TraceRecorder {
+
+constexpr uint32_t MAGIC = 0x54555350;       // "PSUT"
+constexpr uint8_t VERSION = 1;
+constexpr const char* TRACE_PATH = "/trace.bin";
+
+enum class RecordType : uint8_t { Sample, Command };
+enum class Dest : uint8_t { Flash, WebSocket };
+
+void begin(bool fsMounted);          // Use the file system mounted by setup()
+bool start(Dest dest, uint32_t clientId = 0); // Start recording (false if already recording)
+void stop();                         // Stop; the flash file is closed by update()
+void requestLoad();                  // Load TRACE_PATH into the trace player from update()
+bool isRecording();
+Dest getDest();
+uint32_t getClientId();              // WebSocket client receiving the stream
+uint32_t getRecordCount();           // Records taken since start
+uint32_t getDropped();               // Records lost to a full buffer
+
+void record(const SensorFrame& frame, bool fresh); // Control tick: sample and changed commands
+void update();                       // Loop task: write to flash, load traces
+size_t drain(uint8_t* out, size_t maxBytes);       // Stream bytes for the WebSocket destination
+
+bool isValidSize(size_t bytes);      // Header plus a whole number of records (at least one)
+size_t freeBytes();                  // Room for TRACE_PATH, counting the file it replaces
+
+} // namespace TraceRecorder
@@ -4,6 +4,27 @@
 #include <WiFi.h>
 #include "Globals.h"
 #include "Config.h"
+#include "ControlTask.h"
+#include "GainSchedule.h"
+#include "AutoTune.h"
+#include "FeedForward.h"
+#include "DcControl.h"
+#include "Sequencer.h"
+#include "Profiler.h"
+#include "Ina226Manager.h"
+#include "Energy.h"
+#include "Calibration.h"
+#include "SensorSource.h"
+#include "TraceRecorder.h"
+#include "BlackBox.h"
+#include "ErrMgr.h"
+#include "NtcSensor.h"
+#include "OutputControl.h"
+#include "FuseModel.h"
+#include "Protection.h"
+#include "Thermal.h"
+#include "DisplayManager.h"
+#include <LittleFS.h>
 #include <map>
 #include <functional>
 
@@ -229,7 +250,7 @@ svg.icon { width: 1.1em; height: 1.1em; stroke: currentColor; fill: none; stroke
 <p id="v"><span class="label">Voltage</span> <span class="value-unit"><span class="number value">--.--</span> <span class="unit">V</span></span></p>
 <p id="i"><span class="label">Current</span> <span class="value-unit"><span class="number value">--.--</span> <span class="unit">A</span></span></p>
 <p id="q"><span class="label">Power </span> <span class="value-unit"><span class="number value">--.--</span> <span class="unit">W</span></span></p></section>
-<section aria-label="Temperature" id="temperature"><span id="ntcTemp">NTC Temp: --.- °C</span></section>
+<section aria-label="Temperature" id="temperature"><span id="ntcTemp">NTC Temp: --.- °C</span><span id="rampInfo"></span><span id="energyInfo" title="Click to reset"></span></section>
 <form aria-label="Power Supply Settings"><fieldset>
 <div class="param-row"><label for="inputV">Vset (V)</label><div class="controls">
 <button class="btn-step" type="button" data-target="inputV" data-step="-0.01">−</button>
@@ -321,6 +342,9 @@ e.btnSettings.classList.remove("alert");if(ec!==0){e.errorStatus.classList.add("
 e.btnSettings.classList.add("alert")}else{e.errorStatus.classList.add("status-normal")}
 if(e.ntcTemp){e.ntcTemp.classList.remove("status-error","status-alert","status-normal");
 e.ntcTemp.classList.add(ec&1?"status-alert":"status-normal")}}
+if("RAMP" in o){const r=o.RAMP,ri=document.getElementById("rampInfo");if(ri)ri.textContent=r.on?`Ramp ${Number(r.v).toFixed(2)} V (${Number(r.vr).toFixed(2)} V/s)`:""}
+if("EN" in o){const n=o.EN,ei=document.getElementById("energyInfo"),s=Math.floor(n.t);
+if(ei)ei.textContent=`${Number(n.ah).toFixed(4)} Ah ${Number(n.wh).toFixed(3)} Wh ${Math.floor(s/3600)}:${String(Math.floor(s/60)%60).padStart(2,"0")}:${String(s%60).padStart(2,"0")}`}
 if("V" in o&&e.vNumber)e.vNumber.textContent=formatNumber(parseFloat(o.V)||0,3,6);
 if("I" in o&&e.iNumber)e.iNumber.textContent=formatNumber(parseFloat(o.I)||0,3,6);
 if("Q" in o&&e.qNumber)e.qNumber.textContent=formatNumber(parseFloat(o.Q)||0,3,6);
@@ -378,6 +402,8 @@ if(e.modeBtn)e.modeBtn.addEventListener("click",()=>{if(ws&&ws.readyState===WebS
 ws.send(JSON.stringify({MODE:e.modeBtn.classList.contains("active")?"manual":"auto"}))});
 if(e.outputBtn)e.outputBtn.addEventListener("click",()=>{if(ws&&ws.readyState===WebSocket.OPEN)
 ws.send(JSON.stringify({OUT:e.outputBtn.classList.contains("active")?"0":"1"}))});
+const ei=document.getElementById("energyInfo");if(ei)ei.addEventListener("click",()=>{
+if(ws&&ws.readyState===WebSocket.OPEN&&confirm("Reset charge and energy counters?"))ws.send(JSON.stringify({action:"ENERGY_RESET"}))});
 if(e.btnCharts)e.btnCharts.addEventListener("click",()=>{window.open("/charts","_blank");
 e.btnCharts.classList.add("active-page");e.btnCharts.title="Charts (открыта)"});
 if(e.btnSettings)e.btnSettings.addEventListener("click",()=>{window.open("/settings","_blank");
@@ -415,6 +441,11 @@ a:hover { text-decoration: underline; }
 ul { margin: 0.5em 0 0 1em; padding: 0; }
 li { margin: 0.3em 0; }
 .section { background: var(--b5); border-radius: .375em; padding: .8em 1em; box-shadow: var(--s1); margin: .5em 0; }
+table.stats { border-collapse: collapse; color: var(--c4); font-variant-numeric: tabular-nums; }
+table.stats td { padding: .1em .8em .1em 0; }
+table.stats td:first-child { color: var(--c2); }
+.nav-btn { background: var(--b6); border: none; color: var(--c1); padding: .3em 1em; border-radius: .375em; cursor: pointer; box-shadow: var(--s1); }
+.nav-btn:hover { background: var(--b1); color: var(--b4); }
 </style>
 </head>
 <body>
@@ -438,14 +469,107 @@ li { margin: 0.3em 0; }
 <p>Use the main interface to control the Lab PSU and monitor voltage, current, power, and temperature.</p>
 <p>Expert mode unlocks advanced settings (PWM, PID, system limits).</p>
 </div>
+<div class="section">
+<h2>Control Loop</h2>
+<table class="stats">
+<tr><td>Period:</td><td id="ctPeriod">-</td></tr>
+<tr><td>Ticks:</td><td id="ctTicks">-</td></tr>
+<tr><td>Jitter min/max:</td><td id="ctJitter">-</td></tr>
+<tr><td>WCET:</td><td id="ctWcet">-</td></tr>
+<tr><td>Overruns:</td><td id="ctOverruns">-</td></tr>
+<tr><td>Missed:</td><td id="ctMissed">-</td></tr>
+<tr><td>Sample age min/max:</td><td id="ctAge">-</td></tr>
+<tr><td>Max sample gap:</td><td id="ctGap">-</td></tr>
+<tr><td>Stale ticks / skipped samples:</td><td id="ctStale">-</td></tr>
+</table>
+<table class="stats" id="ctHist"></table>
+<button class="nav-btn" id="ctReset">Reset</button>
+</div>
+<div class="section">
+<h2>Main Loop</h2>
+<table class="stats">
+<tr><td>Frequency:</td><td id="prfHz">-</td></tr>
+<tr><td>Longest pass:</td><td id="prfMax">-</td></tr>
+<tr><td>Display I²C:</td><td id="dspBus">-</td></tr>
+</table>
+<table class="stats" id="prfTable"></table>
+</div>
+<div class="section">
+<h2>Protection</h2>
+<table class="stats">
+<tr><td>Rule engine:</td><td id="tpRules">-</td></tr>
+<tr><td>Thermal:</td><td id="tpThermal">-</td></tr>
+<tr><td>ALERT level:</td><td id="tpLevel">-</td></tr>
+<tr><td>Hardware trips:</td><td id="tpHw">-</td></tr>
+<tr><td>Detection window:</td><td id="tpDetect">-</td></tr>
+<tr><td>I²t fuse heat:</td><td id="tpHeat">-</td></tr>
+<tr><td>Software fuse trips:</td><td id="tpSw">-</td></tr>
+<tr><td>Short predictor:</td><td id="tpShort">-</td></tr>
+</table>
+<table class="stats" id="tpShortLog"></table>
+</div>
+<div class="section">
+<h2>Sensor Source &amp; Trace</h2>
+<table class="stats">
+<tr><td>Source:</td><td><select id="trSrc"><option value="0">Hardware</option><option value="1">Mock</option><option value="2">Trace</option></select> <span id="trSrcName">-</span></td></tr>
+<tr><td>Mock V / A / NTC V:</td><td><input id="mkV" type="number" step="0.01" value="5"> <input id="mkI" type="number" step="0.001" value="0.1"> <input id="mkN" type="number" step="0.01" value="1.65"> <button class="nav-btn" id="mkSet">Set</button></td></tr>
+<tr><td>Recorder:</td><td id="trRec">-</td></tr>
+<tr><td>Player:</td><td id="trPlay">-</td></tr>
+<tr><td>NTC noise:</td><td id="ntcNoise">-</td></tr>
+</table>
+<button class="nav-btn" id="trRecFlash">Record to flash</button> <button class="nav-btn" id="trRecWs">Record to browser</button> <button class="nav-btn" id="trStop">Stop</button>
+<a href="/trace.bin" download>Download</a> <button class="nav-btn" id="trSave">Save browser trace</button>
+<input type="file" id="trFile"> <button class="nav-btn" id="trUpload">Upload &amp; load</button> <button class="nav-btn" id="trLoad">Load flash trace</button>
+</div>
+<div class="section">
+<h2>Black Box</h2>
+<table class="stats">
+<tr><td>Recorder:</td><td id="bbState">-</td></tr>
+</table>
+<table class="stats" id="bbList"></table>
+</div>
 <script>
 let ws = new WebSocket("ws://" + location.hostname + "/ws");
 const pageName = "system";
 let globals = {};
 ws.onopen = () => {console.log("WS connected");sendOpen();setInterval(sendOpen, 5000);};
 function sendOpen() {if (ws.readyState === WebSocket.OPEN) {ws.send(JSON.stringify({ page: pageName, action: "OPEN" }));}}
-ws.onmessage = (e) => {try {const obj = JSON.parse(e.data);console.log("Received from server:", obj);if ('HUE' in obj) {globals['HUE'] = parseFloat(obj['HUE']);
-  document.documentElement.style.setProperty('--h', globals['HUE']);}} catch (err) {console.warn("WS parse error:", err);}};
+const histEdges = ["<100", "<200", "<500", "<1k", "<2k", "<5k", "<10k", ">=10k"];
+function setText(id, v) {const el = document.getElementById(id);if (el) el.innerText = v;}
+function updateControl(c) {setText("ctPeriod", (c.period / 1000).toFixed(1) + " ms");setText("ctTicks", c.ticks);
+  setText("ctJitter", c.jmin + " / " + c.jmax + " us");setText("ctWcet", c.wcet + " us");setText("ctOverruns", c.overruns);setText("ctMissed", c.missed);setText("ctAge", c.amin + " / " + c.amax + " us");setText("ctGap", c.gap + " us");setText("ctStale", c.stale + " / " + c.skip);
+  document.getElementById("ctHist").innerHTML = c.hist.map((n, i) => `<tr><td>${histEdges[i]} us:</td><td>${n}</td></tr>`).join("");}
+const prfNames = ["Encoder", "INA226", "Control poll", "Touch", "WiFi/OTA", "Web", "Display", "Prefs", "Trace", "Black box"];
+let traceChunks = [];
+const num = id => +document.getElementById(id).value;
+function sendTrace(o) {if (ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify({ TRACE: o }));}
+function updateTrip(t) {setText("tpThermal", `Tj ≈ ${t.tj.toFixed(1)} °C · loss ${t.loss.toFixed(2)} W · ${t.der < 1 ? "derated to " + (t.der * 100).toFixed(0) + " %" : "no derating"}`);setText("tpRules", `${t.rules} rules · ${t.evl.toFixed(1)} us (max ${t.evm.toFixed(1)} us)`);setText("tpLevel", t.lvl < 0 ? "not armed" : t.lvl.toFixed(3) + " A");
+  setText("tpHw", t.hw ? `${t.hw} · last in-range conversion → off ${(t.hwl / 1000).toFixed(2)} ms (worst ${(t.hwm / 1000).toFixed(2)} ms)` : "0");setText("tpDetect", `≤ ${(2 * t.det / 1000).toFixed(2)} ms (two averaged conversions)`);setText("tpHeat", (t.heat * 100).toFixed(1) + " %");
+  setText("tpSw", `${t.sw} · ${(t.swl / 1000).toFixed(1)} ms (max ${(t.swm / 1000).toFixed(1)} ms)`);setText("tpShort", `${t.sc} events`);
+  document.getElementById("tpShortLog").innerHTML = t.sev.map(e => `<tr><td>${(e[0] / 1000).toFixed(1)} s ago:</td><td>${e[1].toFixed(3)} A/ms · V −${(e[2] * 100).toFixed(0)} % · ${e[3].toFixed(2)} A · ~${e[4].toFixed(1)} ms early</td></tr>`).join("");}
+function updateBlackBox(b) {setText("bbState", `${b.w ? (b.hold ? "waiting for output off" : "writing") : "armed"} · ${b.miss} missed · last write ${b.wms} ms, ${b.wlost} ticks lost`);
+  document.getElementById("bbList").innerHTML = b.r.map(r => {const fl = [...Array(32).keys()].filter(i => (r[3] >>> i) & 1).map(i => "bit " + i).join(", ") || "-";
+  const at = r[5] ? new Date(r[5] * 1000).toLocaleString() : `uptime ${(r[4] / 1000).toFixed(1)} s`;
+  return `<tr><td>#${r[1]} · ${at}:</td><td>${fl} · ${r[6]} ticks · <a href="/blackbox?slot=${r[0]}" download="blackbox_${r[1]}.bin">Download</a></td></tr>`;}).join("");}
+function updateTrace(t) {setText("trSrcName", t.src);setText("trRec", `${t.rec ? "recording" : "idle"} · ${t.n} records · ${t.drop} dropped`);setText("trPlay", `${t.pos} / ${t.count}`);}
+document.getElementById("trSrc").addEventListener("change", e => sendTrace({ cmd: "SOURCE", kind: +e.target.value }));
+document.getElementById("mkSet").addEventListener("click", () => sendTrace({ cmd: "MOCK", v: num("mkV"), i: num("mkI"), ntc: num("mkN") }));
+document.getElementById("trRecFlash").addEventListener("click", () => sendTrace({ cmd: "REC", dest: "flash" }));
+document.getElementById("trRecWs").addEventListener("click", () => {traceChunks = [];sendTrace({ cmd: "REC", dest: "ws" });});
+document.getElementById("trStop").addEventListener("click", () => sendTrace({ cmd: "STOP" }));
+document.getElementById("trLoad").addEventListener("click", () => sendTrace({ cmd: "LOAD" }));
+document.getElementById("trSave").addEventListener("click", () => {if (!traceChunks.length) return;const a = document.createElement("a");
+  a.href = URL.createObjectURL(new Blob(traceChunks, { type: "application/octet-stream" }));a.download = "trace.bin";a.click();});
+document.getElementById("trUpload").addEventListener("click", () => {const f = document.getElementById("trFile").files[0];if (!f) return;
+  const fd = new FormData();fd.append("trace", f, "trace.bin");fetch("/trace", { method: "POST", body: fd }).then(r => r.text()).then(t => {if (t !== "OK") alert("Upload rejected: " + t);});});
+function updateProfiler(p) {setText("prfHz", p.hz.toFixed(0) + " Hz");setText("prfMax", p.lmax + " us");
+  setText("dspBus", `${p.dsp[0]} B/s (full frames: ${p.dsp[1]} B/s) · ${p.dsp[2]} frames/s, ${p.dsp[3]} sent · bus ${p.dsp[4].toFixed(1)} ms/s`);
+  document.getElementById("prfTable").innerHTML = "<tr><td>Module</td><td>calls</td><td>min</td><td>avg</td><td>max</td><td>p99 (us)</td></tr>" +
+    p.m.map((r, i) => `<tr><td>${prfNames[i]}:</td>${r.map(v => `<td>${v}</td>`).join("")}</tr>`).join("");}
+document.getElementById("ctReset").addEventListener("click", () => {if (ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify({ action: "CT_RESET" }));});
+ws.binaryType = "arraybuffer";
+ws.onmessage = (e) => {if (typeof e.data !== "string") {traceChunks.push(e.data);return;}try {const obj = JSON.parse(e.data);console.log("Received from server:", obj);if ('HUE' in obj) {globals['HUE'] = parseFloat(obj['HUE']);
+  document.documentElement.style.setProperty('--h', globals['HUE']);}if ('CTL' in obj) updateControl(obj.CTL);if ('PRF' in obj) updateProfiler(obj.PRF);if ('TRC' in obj) updateTrace(obj.TRC);if ('TRIP' in obj) updateTrip(obj.TRIP);if ('BBX' in obj) updateBlackBox(obj.BBX);if ('NTCN' in obj) setText("ntcNoise", `${obj.NTCN[0].toFixed(2)} mV rms (${obj.NTCN[1].toFixed(3)} °C)`);} catch (err) {console.warn("WS parse error:", err);}};
 ws.onclose = () => {console.log("WS closed");};
 ws.onerror = () => {console.log("WS error");};
 </script>
@@ -471,7 +595,7 @@ h1 { display: flex; align-items: center; justify-content: space-between; }
 </style>
 </head>
 <body>
-<h1>Lab PSU - Charts <label><input type="checkbox" id="debugToggle"> Debug</label></h1>
+<h1>Lab PSU - Charts <span><a href="/scope" target="_blank">Scope</a> <label><input type="checkbox" id="debugToggle"> Debug</label></span></h1>
 <div class="chart-container"><canvas id="chartCombined"></canvas></div>
 <script src="https://cdn.jsdelivr.net/npm/chart.js"></script>
 <script>
@@ -479,6 +603,7 @@ const maxPoints = 100;const dataArray = [];const startTime = Date.now();const pa
 function wsOnMessage(event) {try {
 const data = JSON.parse(event.data);
 if ('HUE' in data) {globals['HUE'] = parseFloat(data['HUE']);document.documentElement.style.setProperty('--h', globals['HUE']);}
+if (!('V' in data)) return; // Error pushes and system page frames carry no samples
 const now = Date.now() - startTime;
 const jitter = (arr, maxDiff) => {if (!arr.length) return 0;let min = Infinity, max = -Infinity;for (const v of arr)if (v != null && !isNaN(v) && isFinite(v)) {if (v < min) min = v;if (v > max) max = v;}if (max === -Infinity || min === Infinity) return 0;
 if (max - min < maxDiff * 0.05)return arr[arr.length - 1] + (Math.random() - 0.5) * maxDiff * 0.02;return arr[arr.length - 1];};
@@ -590,6 +715,67 @@ window.addEventListener("resize", () => combinedChart.resize());
 </script>
 </body>
 </html>
+)rawliteral";
+
+
+// === Scope ==
+const char scope_html[] PROGMEM = R"rawliteral(
+<!DOCTYPE html>
+<html lang="en"><head><meta charset="UTF-8">
+<title>Lab PSU - Scope</title>
+<link rel="stylesheet" href="/style.css">
+<style>
+html, body { width: 100%; height: 100%; }
+body { display: flex; flex-direction: column; padding: 1em; gap: .5em; }
+.bar { display: flex; flex-wrap: wrap; gap: .5em; align-items: center; color: var(--c4); }
+.bar input, .bar select { width: 6em; }
+.chart-container { flex: 1 1 auto; background: var(--b5); border-radius: 0.5em; padding: 1em 1.5em; box-shadow: var(--s1); box-sizing: border-box; display: flex; min-height: 0; }
+canvas { width: 100% !important; height: 100% !important; display: block; }
+.nav-btn { background: var(--b6); border: none; color: var(--c1); padding: .3em 1em; border-radius: .375em; cursor: pointer; box-shadow: var(--s1); }
+</style>
+</head>
+<body>
+<h1>Lab PSU - Scope</h1>
+<div class="bar">
+<label>Trigger <select id="scTrig"><option value="0">I level (A)</option><option value="1">dI/dt (A/ms)</option><option value="2">Output edge</option><option value="3">Fault</option></select></label>
+<label>Level <input id="scLevel" type="number" step="0.01" value="1.0"></label>
+<label>Pre <input id="scPre" type="number" min="0" value="200"></label>
+<label>Post <input id="scPost" type="number" min="0" value="800"></label>
+<button class="nav-btn" id="scArm">Arm</button><button class="nav-btn" id="scStop">Stop</button>
+<span id="scState">-</span></div>
+<div class="chart-container"><canvas id="scChart"></canvas></div>
+<script src="https://cdn.jsdelivr.net/npm/chart.js"></script>
+<script>
+const pageName = "scope";const stateNames = ["Idle", "Armed", "Triggered", "Ready", "Timed out"];let ws, fetched = false;
+const chart = new Chart(document.getElementById("scChart").getContext("2d"), {type: "line", data: {datasets: [
+  { label: "V", data: [], borderColor: "#4CAF50", yAxisID: "yV", pointRadius: 0, borderWidth: 1.5 },
+  { label: "I", data: [], borderColor: "#FFC107", yAxisID: "yI", pointRadius: 0, borderWidth: 1.5 }]},
+  options: {responsive: true, maintainAspectRatio: false, animation: false, parsing: false, interaction: { mode: "nearest", intersect: false },
+  scales: {x: { type: "linear", title: { display: true, text: "ms from trigger" }, grid: { color: "#444" } },
+    yV: { position: "left", ticks: { color: "#4CAF50" }, grid: { color: "#4CAF5040" } },
+    yI: { position: "right", ticks: { color: "#FFC107" }, grid: { drawOnChartArea: false } }}}});
+// Binary frame: "SC", version, trigger, count u16, pre u16, level f32, then count x {mV u16, 0.1 mA i16, dt us u16}
+function showCapture(buf) {const d = new DataView(buf);if (d.byteLength < 12 || d.getUint8(0) !== 83 || d.getUint8(1) !== 67) return;
+  const n = d.getUint16(4, true), pre = d.getUint16(6, true);const t = new Array(n);let us = 0;
+  for (let k = 0; k < n; k++) {us += k ? d.getUint16(12 + k * 6 + 4, true) : 0;t[k] = us;}
+  const t0 = t[pre] || 0, v = [], i = [];
+  for (let k = 0; k < n; k++) {const x = (t[k] - t0) / 1000, o = 12 + k * 6;v.push({ x, y: d.getUint16(o, true) / 1000 });i.push({ x, y: d.getInt16(o + 2, true) / 10000 });}
+  chart.data.datasets[0].data = v;chart.data.datasets[1].data = i;chart.update();}
+function send(o) {if (ws && ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify(o));}
+function sendOpen() {send({ page: pageName, action: "OPEN" });}
+function connectWS() {ws = new WebSocket("ws://" + location.hostname + "/ws");ws.binaryType = "arraybuffer";
+  ws.onopen = () => {sendOpen();};ws.onclose = () => {setTimeout(connectWS, 2000);};ws.onerror = () => {ws.close();};
+  ws.onmessage = e => {if (typeof e.data !== "string") {showCapture(e.data);return;}try {const obj = JSON.parse(e.data);
+    if ('HUE' in obj) document.documentElement.style.setProperty('--h', parseFloat(obj.HUE));
+    if ('SCOPE' in obj) {const s = obj.SCOPE;document.getElementById("scState").innerText = `${stateNames[s.state]} ${s.n}/${s.depth}`;
+      if (s.state === 3 && !fetched) {send({ SCOPE: { cmd: "FETCH" } });fetched = true;}}} catch (err) {}};}
+const num = id => +document.getElementById(id).value;
+document.getElementById("scArm").addEventListener("click", () => {fetched = false;send({ SCOPE: { cmd: "ARM", trig: num("scTrig"), level: num("scLevel"), pre: num("scPre"), post: num("scPost") } });});
+document.getElementById("scStop").addEventListener("click", () => send({ SCOPE: { cmd: "STOP" } }));
+setInterval(sendOpen, 5000);connectWS();
+</script>
+</body>
+</html>
 )rawliteral";  
 
 
@@ -649,6 +835,10 @@ body { max-width: 40em; min-width: 40em}
 .collapsible-header.collapsed .arrow { transform: rotate(-90deg); }
 .collapsible-section { transition: max-height 0.3s ease, opacity 0.3s ease; overflow: hidden; }
 .collapsible-section.collapsed { max-height: 0; opacity: 0; }
+.gs-table { margin: .6em auto; border-collapse: separate; border-spacing: .3em; color: var(--c2); }
+.gs-table input { width: 3.5em; height: 1.6em; font-size: .9em; text-align: center; border-radius: .375em; background: var(--b6); color: var(--c4); border: none; box-shadow: var(--s1); }
+.gs-table input:focus { outline: none; background: var(--b1); color: var(--b4); }
+#seqSteps { width: 90%; height: 8em; margin: .6em 5%; font-family: var(--f); background: var(--b6); color: var(--c4); border: none; border-radius: .375em; box-shadow: var(--s1); }
 </style>
 </head>
 <body>
@@ -702,8 +892,58 @@ body { max-width: 40em; min-width: 40em}
 <div class="field"><label>Duty Min:</label><span class="global" id="global_DutyMin"></span><input type="number" id="draft_DutyMin" step="1"></div>
 <div class="field"><label>Duty Max:</label><span class="global" id="global_DutyMax"></span><input type="number" id="draft_DutyMax" step="1"></div>
 <div class="field"><label>Invert PWM:</label><span class="global" id="global_InvertPWM"></span><input type="checkbox" id="draft_InvertPWM"></div>
+<div class="field"><label>INA Profile (0 Fast, 1 Bal, 2 Prec):</label><span class="global" id="global_InaProfile"></span><input type="number" id="draft_InaProfile" step="1" min="0" max="2"></div>
+<div class="field"><label>Feed-forward:</label><span class="global" id="global_FeedFwd"></span><input type="checkbox" id="draft_FeedFwd"></div>
 <div class="field"><label>Debug Mode:</label><span class="global" id="global_DBG"></span><input type="number" id="draft_DBG" step="1" min="0" max="9"></div>
 </div>
+<div class="section button-section"><button id="ffReset" class="nav-btn">Reset Feed-forward</button></div>
+</div><hr>
+<h1 class="collapsible-header" data-section="ramp">Setpoint Ramp <span class="arrow">▼</span></h1>
+<div class="collapsible-section" id="ramp">
+<div class="field-group">
+<div class="field"><label>Profile (0 Lin, 1 S, 2 Exp):</label><span class="global" id="global_RampProfile"></span><input type="number" id="draft_RampProfile" step="1" min="0" max="2"></div>
+<div class="field"><label>V Rate (V/ms):</label><span class="global" id="global_RampRateV"></span><input type="number" id="draft_RampRateV" step="0.001" min="0"></div>
+<div class="field"><label>I Rate (A/ms):</label><span class="global" id="global_RampRateI"></span><input type="number" id="draft_RampRateI" step="0.0001" min="0"></div>
+<div class="field"><label>S-curve Accel (ms):</label><span class="global" id="global_RampAccelMs"></span><input type="number" id="draft_RampAccelMs" step="10" min="1"></div>
+<div class="field"><label>Exp. Tau (ms):</label><span class="global" id="global_RampTauMs"></span><input type="number" id="draft_RampTauMs" step="10" min="1"></div>
+</div>
+</div><hr>
+<h1 class="collapsible-header" data-section="sequencer">Sequencer <span class="arrow">▼</span></h1>
+<div class="collapsible-section" id="sequencer">
+<textarea id="seqSteps" placeholder="V, I, Icut, dwell ms[, INA profile 0-2] (one step per line)"></textarea>
+<div class="field-group">
+<div class="field"><label>Loops (0 = endless):</label><input type="number" id="seqLoops" step="1" min="0" value="1"></div>
+<div class="field"><label>Status:</label><span class="global" id="seqStatus">-</span></div>
+</div>
+<div class="section button-section"><button id="seqLoad" class="nav-btn">Load</button><button id="seqStart" class="nav-btn">Start</button><button id="seqPause" class="nav-btn">Pause</button><button id="seqResume" class="nav-btn">Resume</button><button id="seqStop" class="nav-btn">Stop</button></div>
+<table id="seqTable" class="gs-table"></table>
+</div><hr>
+<h1 class="collapsible-header" data-section="gain-sched">Gain Schedule <span class="arrow">▼</span></h1>
+<div class="collapsible-section" id="gain-sched">
+<div class="field-group">
+<div class="field"><label>Enabled:</label><span class="global" id="global_GainSched"></span><input type="checkbox" id="draft_GainSched"></div>
+<div class="field"><label>Grid:</label><select id="gsSel"><option value="0">CV Kp</option><option value="1">CV Ki</option><option value="2">CV Kd</option><option value="3">CC Kp</option><option value="4">CC Ki</option><option value="5">CC Kd</option></select></div>
+</div>
+<table id="gsTable" class="gs-table"></table>
+<div class="section button-section"><button id="gsApply" class="nav-btn">Apply Table</button></div>
+</div><hr>
+<h1 class="collapsible-header" data-section="autotune">PID Autotune <span class="arrow">▼</span></h1>
+<div class="collapsible-section" id="autotune">
+<div class="field-group">
+<div class="field"><label>Status:</label><span class="global" id="atStatus">-</span></div>
+<div class="field"><label>Ku / Tu:</label><span class="global" id="atResult">-</span></div>
+</div>
+<div class="section button-section"><button id="atCV" class="nav-btn">Tune CV</button><button id="atCC" class="nav-btn">Tune CC</button><button id="atStop" class="nav-btn">Stop</button></div>
+</div><hr>
+<h1 class="collapsible-header" data-section="calibration">Calibration <span class="arrow">▼</span></h1>
+<div class="collapsible-section" id="calibration">
+<div class="field-group">
+<div class="field"><label>Reference V:</label><input type="number" id="calRefV" step="0.001"></div>
+<div class="field"><label>Reference A:</label><input type="number" id="calRefI" step="0.0001"></div>
+<div class="field"><label>Status:</label><span class="global" id="calStatus">-</span></div>
+</div>
+<div class="section button-section"><button id="calPointV" class="nav-btn">Capture V</button><button id="calPointI" class="nav-btn">Capture I</button><button id="calClearV" class="nav-btn">Clear V</button><button id="calClearI" class="nav-btn">Clear I</button></div>
+<table id="calTable" class="gs-table"></table>
 </div><hr>
 <h1 class="collapsible-header" data-section="limits">Limits <span class="arrow">▼</span></h1>
 <div class="collapsible-section" id="limits">
@@ -716,6 +956,11 @@ body { max-width: 40em; min-width: 40em}
 <div class="field"><label>Temp. Hyst.:</label><span class="global" id="global_TempDiff"></span><input type="number" id="draft_TempDiff" step="0.1" min="0.1" max="10"></div>
 <div class="field"><label>Voltage Dev. V:</label><span class="global" id="global_VdevLimit"></span><input type="number" id="draft_VdevLimit" step="0.1" min="0" max="10"></div>
 <div class="field"><label>Current Dev. %:</label><span class="global" id="global_IdevLimit"></span><input type="number" id="draft_IdevLimit" step="1" min="0" max="100"></div>
+<div class="field"><label>Fuse Curve (0 Fast, 1 Slow, 2 Custom):</label><span class="global" id="global_FuseCurve"></span><input type="number" id="draft_FuseCurve" step="1" min="0" max="2"></div>
+<div class="field"><label>Custom Fuse Tau (s):</label><span class="global" id="global_FuseTau"></span><input type="number" id="draft_FuseTau" step="0.01" min="0.005" max="60"></div>
+<div class="field"><label>Custom Fuse Peak (x Icut):</label><span class="global" id="global_FusePeak"></span><input type="number" id="draft_FusePeak" step="0.5" min="1.5" max="20"></div>
+<div class="field"><label>Short dI/dt (A/ms, 0 off):</label><span class="global" id="global_ShortSlope"></span><input type="number" id="draft_ShortSlope" step="0.01" min="0"></div>
+<div class="field"><label>Short V Collapse (0-1):</label><span class="global" id="global_ShortCollapse"></span><input type="number" id="draft_ShortCollapse" step="0.05" min="0" max="1"></div>
 </div>
 </div>
 </div>
@@ -725,29 +970,35 @@ let reconnectInterval = 1000;
 const maxReconnect = 30000;
 const pageName = "settings";
 let initialized = false;
-const fieldPrecision = {Kp: 2, Ki: 3, Kd: 3, IntegralLimit: 1, Kp_I: 2, Ki_I: 3, Kd_I: 3, IntegralLimit_I: 1, DutyMin: 1, DutyMax: 1, VoutMin: 1, VoutMax: 1, IlimitMax: 1, PowerMax: 1, TempMax: 1, TempDiff: 1, HUE: 0, VdevLimit: 1,IdevLimit: 1, DBG: 0};
-const fields = ['WiFiSSID','WiFiPass','HUE','WiFiEnabled','OTAEnabled','InvertPWM','Kp','Ki','Kd','IntegralLimit','DutyMin','Kp_I','Ki_I','Kd_I','IntegralLimit_I','DutyMax','VoutMin','VoutMax','IlimitMax','PowerMax','TempMax','TempDiff','VdevLimit','IdevLimit','DBG'];
-const expertFields = ['WiFiEnabled','OTAEnabled','InvertPWM','Kp','Ki','Kd','IntegralLimit','Kp_I','Ki_I','Kd_I','IntegralLimit_I','DutyMin','DutyMax','VoutMin','VoutMax','IlimitMax','PowerMax','TempMax','TempDiff','DBG'];
+const fieldPrecision = {Kp: 2, Ki: 3, Kd: 3, IntegralLimit: 1, Kp_I: 2, Ki_I: 3, Kd_I: 3, IntegralLimit_I: 1, DutyMin: 1, DutyMax: 1, VoutMin: 1, VoutMax: 1, IlimitMax: 1, PowerMax: 1, TempMax: 1, TempDiff: 1, HUE: 0, VdevLimit: 1,IdevLimit: 1, DBG: 0, InaProfile: 0, RampProfile: 0, RampRateV: 4, RampRateI: 4, RampAccelMs: 0, RampTauMs: 0, FuseCurve: 0, FuseTau: 2, FusePeak: 1, ShortSlope: 3, ShortCollapse: 2};
+const fields = ['WiFiSSID','WiFiPass','HUE','WiFiEnabled','OTAEnabled','InvertPWM','GainSched','FeedFwd','Kp','Ki','Kd','IntegralLimit','DutyMin','Kp_I','Ki_I','Kd_I','IntegralLimit_I','DutyMax','VoutMin','VoutMax','IlimitMax','PowerMax','TempMax','TempDiff','VdevLimit','IdevLimit','DBG','InaProfile','RampProfile','RampRateV','RampRateI','RampAccelMs','RampTauMs','FuseCurve','FuseTau','FusePeak','ShortSlope','ShortCollapse'];
+const expertFields = ['WiFiEnabled','OTAEnabled','InvertPWM','GainSched','FeedFwd','Kp','Ki','Kd','IntegralLimit','Kp_I','Ki_I','Kd_I','IntegralLimit_I','DutyMin','DutyMax','VoutMin','VoutMax','IlimitMax','PowerMax','TempMax','TempDiff','DBG','InaProfile','RampProfile','RampRateV','RampRateI','RampAccelMs','RampTauMs','FuseCurve','FuseTau','FusePeak','ShortSlope','ShortCollapse'];
 const errorMap = ["Overheat","Overcurrent","Fuse Blown","Sensor Fail","INA226 Init Fail","WiFi Init Fail","SSD1306 Init Fail","PWM Init Fail","Vout Over Limit","Over Power","Voltage Deviation",
-  "Current Deviation","Power Over Limit","LEDC Init Fail","PID Divergence","Low Memory","High CPU Temp","Current PID Div"];
+  "Current Deviation","Power Over Limit","LEDC Init Fail","PID Divergence","Low Memory","High CPU Temp","Current PID Div","HW Overcurrent","Short Circuit"];
 let globals = {HUE: 85, TempDiff: 5.0};
 let hueTimeout;
 let errorLog = [];
+let gsLoaded = false;
+let gsData = null;
+let gsSel = 0;
+let atState = 0;
+let seqLast = '';
 function connectWS() {ws = new WebSocket("ws://" + location.hostname + "/ws");ws.onopen = () => {reconnectInterval = 1000;sendOpen();errorLog = []};
   ws.onclose = () => {setTimeout(connectWS, reconnectInterval);reconnectInterval = Math.min(reconnectInterval * 2, maxReconnect);};
   ws.onerror = () => {ws.close();};
-  ws.onmessage = e => {const obj = JSON.parse(e.data);updateGlobals(obj);if ('ERR' in obj) updateErrorLog(obj.ERR);if (!initialized) {setDraftsFromGlobals();initialized = true;}updateApplyButton();};
+  ws.onmessage = e => {const obj = JSON.parse(e.data);updateGlobals(obj);if ('ERR' in obj) updateErrorLog(obj.ERR);if ('GS' in obj && !gsLoaded) {buildGsTable(obj.GS);gsLoaded = true;}if ('AT' in obj) updateAutotune(obj.AT);if ('SEQ' in obj) updateSequencer(obj.SEQ);if ('SEQR' in obj) buildSeqTable(obj.SEQR);if ('CAL' in obj) updateCalibration(obj.CAL);if (!initialized && !('EV' in obj) && !('CTL' in obj)) {setDraftsFromGlobals();initialized = true;}updateApplyButton();};
   setInterval(() => {if (ws && ws.readyState === WebSocket.OPEN) {sendOpen();}}, 5000);}
 function sendOpen() {if (ws && ws.readyState === WebSocket.OPEN) {ws.send(JSON.stringify({ page: pageName, action: "OPEN" }));}}
 function validateDraftValue(field, value) {
-  if(['Kp','Ki','Kd','IntegralLimit','Kp_I','Ki_I','Kd_I','IntegralLimit_I','DutyMin','DutyMax','VoutMin','VoutMax','IlimitMax','PowerMax','TempMax','TempDiff','HUE','VdevLimit','IdevLimit'].includes(field)) {
+  if(['Kp','Ki','Kd','IntegralLimit','Kp_I','Ki_I','Kd_I','IntegralLimit_I','DutyMin','DutyMax','VoutMin','VoutMax','IlimitMax','PowerMax','TempMax','TempDiff','HUE','VdevLimit','IdevLimit','RampRateV','RampRateI','RampAccelMs','RampTauMs','FuseTau','FusePeak','ShortSlope','ShortCollapse'].includes(field)) {
   const num = parseFloat(value);if (isNaN(num)) return false;if (field === 'TempDiff') return num >= 0.1 && num <= 10;return true;}
-  if (field === 'DBG') {const num = parseInt(value);return !isNaN(num) && num >= 0 && num <= 9;}return true;}
+  if (field === 'DBG') {const num = parseInt(value);return !isNaN(num) && num >= 0 && num <= 9;}
+  if (field === 'RampProfile' || field === 'InaProfile' || field === 'FuseCurve') {const num = parseInt(value);return !isNaN(num) && num >= 0 && num <= 2;}return true;}
 function updateGlobals(obj) {
   fields.forEach(field => {
   if (!(field in obj)) return;
   globals[field] = obj[field];
-  const isBool = ['WiFiEnabled','OTAEnabled','InvertPWM'].includes(field);
+  const isBool = ['WiFiEnabled','OTAEnabled','InvertPWM','GainSched','FeedFwd'].includes(field);
   const globalSpan = document.getElementById(`global_${field}`);
   if (globalSpan) {
   globalSpan.innerText = isBool ? (globals[field] ? 'Yes' : 'No') : (field in fieldPrecision ? Number(globals[field]).toFixed(fieldPrecision[field]) : globals[field]);}
@@ -757,21 +1008,21 @@ function setDraftsFromGlobals() {
   fields.forEach(field => {
   const input = document.getElementById(`draft_${field}`);
   if (!input) return;
-  if (['WiFiEnabled','OTAEnabled','InvertPWM'].includes(field)) input.checked = !!globals[field];
+  if (['WiFiEnabled','OTAEnabled','InvertPWM','GainSched','FeedFwd'].includes(field)) input.checked = !!globals[field];
   else if (['WiFiSSID','WiFiPass'].includes(field)) input.value = globals[field] || '';
   else input.value = field in fieldPrecision ? Number(globals[field]).toFixed(fieldPrecision[field]) : globals[field] || '';});updateApplyButton();}
 function getDraftValue(field) {
   const input = document.getElementById(`draft_${field}`);
-  if (['WiFiEnabled','OTAEnabled','InvertPWM'].includes(field)) return input.checked ? 1 : 0;if (field === 'DBG') return parseInt(input.value);
-  if (['Kp','Ki','Kd','IntegralLimit','Kp_I','Ki_I','Kd_I','IntegralLimit_I','DutyMin','DutyMax','VoutMin','VoutMax','IlimitMax','PowerMax','TempMax','TempDiff','HUE','VdevLimit','IdevLimit'].includes(field)) return parseFloat(input.value);
+  if (['WiFiEnabled','OTAEnabled','InvertPWM','GainSched','FeedFwd'].includes(field)) return input.checked ? 1 : 0;if (field === 'DBG' || field === 'RampProfile' || field === 'InaProfile' || field === 'FuseCurve') return parseInt(input.value);
+  if (['Kp','Ki','Kd','IntegralLimit','Kp_I','Ki_I','Kd_I','IntegralLimit_I','DutyMin','DutyMax','VoutMin','VoutMax','IlimitMax','PowerMax','TempMax','TempDiff','HUE','VdevLimit','IdevLimit','RampRateV','RampRateI','RampAccelMs','RampTauMs','FuseTau','FusePeak','ShortSlope','ShortCollapse'].includes(field)) return parseFloat(input.value);
   return input.value;}
 function updateGlobalDisplay(field) {const globalSpan = document.getElementById(`global_${field}`);
-  if (globalSpan) globalSpan.innerText = ['WiFiEnabled','OTAEnabled','InvertPWM'].includes(field) ? (globals[field] ? 'Yes' : 'No') : (field in fieldPrecision ? Number(globals[field]).toFixed(fieldPrecision[field]) : globals[field]);}
+  if (globalSpan) globalSpan.innerText = ['WiFiEnabled','OTAEnabled','InvertPWM','GainSched','FeedFwd'].includes(field) ? (globals[field] ? 'Yes' : 'No') : (field in fieldPrecision ? Number(globals[field]).toFixed(fieldPrecision[field]) : globals[field]);}
 function updateApplyButton() {
   let hasChanges = false;
   for (const field of fields) {
   const dval = getDraftValue(field), gval = globals[field];
-  if (['WiFiEnabled','OTAEnabled','InvertPWM'].includes(field)) {
+  if (['WiFiEnabled','OTAEnabled','InvertPWM','GainSched','FeedFwd'].includes(field)) {
   if (validateDraftValue(field, dval) && dval !== (gval ? 1 : 0)) { hasChanges = true; break; }} else if (field in fieldPrecision) {
   if (validateDraftValue(field, dval) && Number(dval).toFixed(fieldPrecision[field]) !== Number(gval).toFixed(fieldPrecision[field])) { hasChanges = true; break; }
   } else if (validateDraftValue(field, dval) && dval !== gval) { hasChanges = true; break; }}document.getElementById("btnApply").classList.toggle("active", hasChanges);}
@@ -779,7 +1030,7 @@ document.getElementById("btnApply").addEventListener("click", () => {
   const changes = {};
   fields.forEach(field => {
   const dval = getDraftValue(field), gval = globals[field];
-  if (['WiFiEnabled','OTAEnabled','InvertPWM'].includes(field)) {
+  if (['WiFiEnabled','OTAEnabled','InvertPWM','GainSched','FeedFwd'].includes(field)) {
   if (validateDraftValue(field, dval) && dval !== (gval ? 1 : 0)) changes[field] = dval;
   } else if (field in fieldPrecision) {
   if (validateDraftValue(field, dval) && Number(dval).toFixed(fieldPrecision[field]) !== Number(gval).toFixed(fieldPrecision[field])) changes[field] = Number(dval);
@@ -821,6 +1072,39 @@ function updateStatusDisplay() {const listDiv = document.getElementById("statusL
   if (entry) {const className = entry.active ? "error-active" : "error-inactive";listDiv.innerHTML += `<div class="${className}">${errorMap[i]}</div>`;}}}listDiv.scrollTop = listDiv.scrollHeight;
   statusDiv.classList.remove("status-error", "status-normal");listDiv.classList.remove("status-error", "status-normal");statusDiv.classList.add(statusClass);listDiv.classList.add(statusClass);
   if (hasLoggedErrors && !statusDiv.classList.contains("visible")) {statusDiv.classList.add("visible");toggleBtn.innerText = "Hide Errors";toggleBtn.classList.add("active");}}
+function buildGsTable(gs) {gsData = gs;const k = gs.k[Math.floor(gsSel / 3)][gsSel % 3];
+  let h = '<tr><th>R / V</th>' + gs.v.map((v, i) => `<th><input type="number" id="gsV${i}" step="0.1" value="${v}"></th>`).join('') + '</tr>';
+  gs.r.forEach((r, j) => {h += `<tr><th><input type="number" id="gsR${j}" step="1" value="${r}"></th>` + k[j].map((x, i) => `<td><input type="number" id="gsK${j}_${i}" step="0.05" value="${x}"></td>`).join('') + '</tr>';});
+  document.getElementById("gsTable").innerHTML = h;}
+function saveGsGrid() {const num = id => parseFloat(document.getElementById(id).value);const k = gsData.k[Math.floor(gsSel / 3)][gsSel % 3];
+  gsData.v = gsData.v.map((_, i) => num(`gsV${i}`));gsData.r = gsData.r.map((_, j) => num(`gsR${j}`));
+  k.forEach((row, j) => row.forEach((_, i) => {row[i] = num(`gsK${j}_${i}`);}));}
+document.getElementById("gsSel").addEventListener("change", e => {if (!gsData) return;saveGsGrid();gsSel = +e.target.value;buildGsTable(gsData);});
+document.getElementById("gsApply").addEventListener("click", () => {if (!gsLoaded) return;saveGsGrid();
+  if ([...gsData.v, ...gsData.r, ...gsData.k.flat(3)].some(isNaN)) return;ws.send(JSON.stringify({ GS: { v: gsData.v, r: gsData.r, k: gsData.k } }));gsLoaded = false;});
+function updateAutotune(at) {document.getElementById("atStatus").innerText = `${at.loop}: ${at.status}`;
+  document.getElementById("atResult").innerText = at.state === 2 ? `${Number(at.ku).toFixed(2)} / ${Number(at.tu).toFixed(3)} s` : '-';
+  if (at.state === 2 && atState !== 2) setDraftsFromGlobals();atState = at.state;}
+["atCV", "atCC"].forEach(id => document.getElementById(id).addEventListener("click", () => {if (ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify({ action: "AUTOTUNE", loop: id === "atCV" ? "CV" : "CC" }));}));
+function updateSequencer(s) {const names = ['Idle', 'Running', 'Paused', 'Done'];
+  document.getElementById("seqStatus").innerText = `${names[s.state]} · step ${s.step + 1}/${s.count} · loop ${s.loop}${s.loops ? '/' + s.loops : ''}`;
+  const key = `${s.state}:${s.step}:${s.loop}`;if (key !== seqLast && ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify({ SEQ: { cmd: "RESULTS" } }));seqLast = key;}
+function buildSeqTable(rows) {let h = '<tr><th>#</th><th>t (ms)</th><th>V avg</th><th>I avg</th></tr>';
+  rows.forEach((r, i) => {h += `<tr><td>${i + 1}</td><td>${r[3] ? r[0] : '-'}</td><td>${r[3] ? Number(r[1]).toFixed(3) : '-'}</td><td>${r[3] ? Number(r[2]).toFixed(3) : '-'}</td></tr>`;});
+  document.getElementById("seqTable").innerHTML = h;}
+document.getElementById("seqLoad").addEventListener("click", () => {if (ws.readyState !== WebSocket.OPEN) return;
+  const steps = document.getElementById("seqSteps").value.split('\n').map(l => l.split(/[,;\s]+/).filter(x => x).map(Number)).filter(s => (s.length === 4 || s.length === 5) && !s.some(isNaN));
+  const loops = parseInt(document.getElementById("seqLoops").value) || 0;
+  for (let i = 0; i === 0 || i < steps.length; i += 8) ws.send(JSON.stringify({ SEQ: { cmd: i ? "APPEND" : "LOAD", loops, steps: steps.slice(i, i + 8) } }));seqLast = '';});
+["Start", "Pause", "Resume", "Stop"].forEach(c => document.getElementById(`seq${c}`).addEventListener("click", () => {if (ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify({ SEQ: { cmd: c.toUpperCase() } }));}));
+function updateCalibration(c) {document.getElementById("calStatus").innerText = c.st;
+  const row = (n, pts) => pts.map(p => `<tr><td>${n}</td><td>${Number(p[0]).toFixed(4)}</td><td>${Number(p[1]).toFixed(4)}</td></tr>`).join('');
+  document.getElementById("calTable").innerHTML = '<tr><th>Ch</th><th>Raw</th><th>Reference</th></tr>' + row('V', c.v) + row('I', c.i);}
+[["calPointV", "POINT", "V"], ["calPointI", "POINT", "I"], ["calClearV", "CLEAR", "V"], ["calClearI", "CLEAR", "I"]].forEach(([id, cmd, ch]) => document.getElementById(id).addEventListener("click", () => {
+  const ref = parseFloat(document.getElementById(`calRef${ch}`).value);if (ws.readyState !== WebSocket.OPEN || (cmd === "POINT" && isNaN(ref))) return;
+  ws.send(JSON.stringify({ CAL: { cmd, ch, ref } }));}));
+document.getElementById("ffReset").addEventListener("click", () => {if (ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify({ action: "FF_RESET" }));});
+document.getElementById("atStop").addEventListener("click", () => {if (ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify({ action: "AUTOTUNE_STOP" }));});
 connectWS();
 document.querySelectorAll('.collapsible-section, .collapsible-header').forEach(el => el.classList.add('collapsed'));
 </script>
@@ -832,6 +1116,7 @@ document.querySelectorAll('.collapsible-section, .collapsible-header').forEach(e
 
 static AsyncWebServer server(80);
 static AsyncWebSocket ws("/ws");
+static const char* traceUploadError = nullptr;  // Reason the last /trace upload was rejected
 
 namespace WebInterface {
 
@@ -841,6 +1126,10 @@ struct PageState {
 };
 std::map<String, PageState> pages;
 const unsigned long PAGE_TIMEOUT = 10000;
+const size_t SCOPE_HEADER_BYTES = 12; // Binary capture frame header: "SC", version, trigger, count, pre, level
+const size_t LIVE_DOC_SIZE = 6144;    // Live data + settings page frame (heap)
+const size_t SYSTEM_DOC_SIZE = 4096;  // System page frame (heap), sent separately
+const size_t WS_IN_DOC_SIZE = 2560;   // Incoming frame (heap); a full gain schedule takes ~1.8 KB
 
 void handlePageOpen(const String &pageName) {
     pages[pageName].active = true;
@@ -905,6 +1194,72 @@ void begin() {
                 request->send(404, "text/plain", "File not found");
             }
         });
+        server.on("/trace.bin", HTTP_GET, [](AsyncWebServerRequest *request) {
+            if (TraceRecorder::isRecording() || !LittleFS.exists(TraceRecorder::TRACE_PATH)) {
+                request->send(404, "text/plain", "No trace");
+                return;
+            }
+            request->send(LittleFS, TraceRecorder::TRACE_PATH, "application/octet-stream", true);
+        });
+        server.on("/blackbox", HTTP_GET, [](AsyncWebServerRequest *request) {
+            // ?slot=N downloads a record, otherwise the stored records as JSON (newest first)
+            if (request->hasParam("slot")) {
+                int slot = request->getParam("slot")->value().toInt();
+                String path = BlackBox::path(slot);
+                if (slot < 0 || slot >= BlackBox::SLOTS || !LittleFS.exists(path.c_str())) {
+                    request->send(404, "text/plain", "No record");
+                    return;
+                }
+                request->send(LittleFS, path, "application/octet-stream", true);
+                return;
+            }
+            BlackBox::Info recs[BlackBox::SLOTS];
+            uint8_t n = BlackBox::list(recs, BlackBox::SLOTS);
+            StaticJsonDocument<1024> doc;
+            for (uint8_t k = 0; k < n; k++) {
+                JsonObject r = doc.createNestedObject();
+                r["slot"] = recs[k].slot;
+                r["seq"] = recs[k].seq;
+                r["errors"] = recs[k].errorMask;
+                r["new"] = recs[k].newBits;
+                r["uptime"] = recs[k].uptimeMs;
+                r["time"] = recs[k].unixTime;
+                r["ticks"] = recs[k].count;
+            }
+            String json;
+            serializeJson(doc, json);
+            request->send(200, "application/json", json);
+        });
+        server.on("/trace", HTTP_POST, [](AsyncWebServerRequest *request) {
+            if (traceUploadError) request->send(400, "text/plain", traceUploadError);
+            else request->send(200, "text/plain", "OK");
+        }, [](AsyncWebServerRequest *request, const String &filename, size_t index, uint8_t *data, size_t len, bool final) {
+            // Uploaded trace replaces the flash trace and is loaded into the player
+            static File upload;
+            static size_t written = 0;
+            if (index == 0) {
+                written = 0;
+                traceUploadError = nullptr;
+                if (upload) upload.close();
+                if (TraceRecorder::isRecording()) traceUploadError = "Recording in progress";
+                else if (request->contentLength() > TraceRecorder::freeBytes()) traceUploadError = "Trace larger than free flash";
+                else if (!(upload = LittleFS.open(TraceRecorder::TRACE_PATH, "w"))) traceUploadError = "Cannot open trace file";
+            }
+            if (!upload) return;
+            size_t n = upload.write(data, len);
+            written += n;
+            if (n != len) traceUploadError = "Flash full";
+            if (!final && !traceUploadError) return;
+
+            // A rejected upload leaves no partial trace behind
+            upload.close();
+            if (!traceUploadError && !TraceRecorder::isValidSize(written)) traceUploadError = "Not a trace: size is not header + whole records";
+            if (traceUploadError) LittleFS.remove(TraceRecorder::TRACE_PATH);
+            else TraceRecorder::requestLoad();
+        });
+        server.on("/scope", HTTP_GET, [](AsyncWebServerRequest *request) {
+            request->send_P(200, "text/html", scope_html);
+        });
         server.on("/system", HTTP_GET, [](AsyncWebServerRequest *request) {
             if (system_html) {
                 request->send_P(200, "text/html", system_html);
@@ -929,7 +1284,7 @@ void begin() {
 
             String msg = String((char *)data).substring(0, len);
             msg.trim();
-            StaticJsonDocument<128> doc;
+            DynamicJsonDocument doc(WS_IN_DOC_SIZE);
             if (deserializeJson(doc, msg) != DeserializationError::Ok) return;
 
             // Page open
@@ -944,6 +1299,12 @@ void begin() {
             if (doc.containsKey("action")) {
                 if (doc["action"] == "DEBUG_ON") debugEnabled = true;
                 else if (doc["action"] == "DEBUG_OFF") debugEnabled = false;
+                else if (doc["action"] == "CT_RESET") ControlTask::resetStats();
+                else if (doc["action"] == "AUTOTUNE")
+                    AutoTune::start(doc["loop"] == "CC" ? AutoTune::Loop::Current : AutoTune::Loop::Voltage);
+                else if (doc["action"] == "AUTOTUNE_STOP") AutoTune::stop();
+                else if (doc["action"] == "ENERGY_RESET") Energy::reset();
+                else if (doc["action"] == "FF_RESET") FeedForward::setTable(FeedForward::defaultTable());
             }
 
             // Live setpoints
@@ -966,6 +1327,120 @@ void begin() {
             if (doc.containsKey("DutyMin")) ::dutyMin = doc["DutyMin"];
             if (doc.containsKey("DutyMax")) ::dutyMax = doc["DutyMax"];
             if (doc.containsKey("InvertPWM")) ::invertPwmSignal = !!doc["InvertPWM"];
+            if (doc.containsKey("GainSched")) ::gainScheduleEnabled = !!doc["GainSched"];
+            if (doc.containsKey("FeedFwd")) ::feedForwardEnabled = !!doc["FeedFwd"];
+            if (doc.containsKey("InaProfile")) Ina226Manager::setProfile((Ina226Manager::Profile)doc["InaProfile"].as<uint8_t>());
+            if (doc.containsKey("RampProfile")) ::rampProfile = constrain(doc["RampProfile"].as<int>(), 0, 2);
+            if (doc.containsKey("RampRateV")) ::rampRateV = max(doc["RampRateV"].as<float>(), 0.0f);
+            if (doc.containsKey("RampRateI")) ::rampRateI = max(doc["RampRateI"].as<float>(), 0.0f);
+            if (doc.containsKey("RampAccelMs")) ::rampAccelMs = max(doc["RampAccelMs"].as<float>(), 1.0f);
+            if (doc.containsKey("RampTauMs")) ::rampTauMs = max(doc["RampTauMs"].as<float>(), 1.0f);
+            if (doc.containsKey("FuseCurve")) ::fuseCurve = constrain(doc["FuseCurve"].as<int>(), 0, (int)FuseModel::Curve::Count - 1);
+            if (doc.containsKey("FuseTau")) ::fuseTauS = constrain(doc["FuseTau"].as<float>(), 0.005f, 60.0f);
+            if (doc.containsKey("FusePeak")) ::fusePeak = constrain(doc["FusePeak"].as<float>(), 1.5f, 20.0f);
+            if (doc.containsKey("ShortSlope")) ::shortSlopeAms = max(doc["ShortSlope"].as<float>(), 0.0f);
+            if (doc.containsKey("ShortCollapse")) ::shortCollapse = constrain(doc["ShortCollapse"].as<float>(), 0.0f, 1.0f);
+            if (doc.containsKey("GS")) {
+                GainSchedule::Table table = GainSchedule::getTable();
+                JsonObject gs = doc["GS"];
+                for (uint8_t i = 0; i < GainSchedule::V_POINTS; i++) table.vPoints[i] = gs["v"][i] | table.vPoints[i];
+                for (uint8_t j = 0; j < GainSchedule::R_POINTS; j++) table.rPoints[j] = gs["r"][j] | table.rPoints[j];
+                // k[loop][gain][r][v]
+                for (uint8_t l = 0; l < GainSchedule::LOOPS; l++)
+                    for (uint8_t g = 0; g < GainSchedule::GAINS; g++)
+                        for (uint8_t j = 0; j < GainSchedule::R_POINTS; j++)
+                            for (uint8_t i = 0; i < GainSchedule::V_POINTS; i++)
+                                table.scale[l][g][j][i] = gs["k"][l][g][j][i] | table.scale[l][g][j][i];
+                GainSchedule::setTable(table);
+            }
+            if (doc.containsKey("SEQ")) {
+                JsonObject seq = doc["SEQ"];
+                String cmd = seq["cmd"] | "";
+                if (cmd == "LOAD" || cmd == "APPEND") {
+                    if (cmd == "LOAD") {
+                        Sequencer::clear();
+                        Sequencer::setLoops(seq["loops"] | 1);
+                    }
+                    for (JsonArray s : seq["steps"].as<JsonArray>()) {
+                        Sequencer::Step step = {
+                            (uint16_t)constrain(lroundf((s[0] | 0.0f) * 1000.0f), 0L, 65535L),
+                            (uint16_t)constrain(lroundf((s[1] | 0.0f) * 1000.0f), 0L, 65535L),
+                            (uint16_t)constrain(lroundf((s[2] | 0.0f) * 1000.0f), 0L, 65535L),
+                            (uint16_t)constrain(lroundf((s[3] | 0.0f) / 10.0f), 0L, 65535L),
+                            (uint8_t)(s[4] | Sequencer::KEEP_PROFILE)
+                        };
+                        if (!Sequencer::append(step)) break;
+                    }
+                } else if (cmd == "START") Sequencer::start();
+                else if (cmd == "STOP") Sequencer::stop();
+                else if (cmd == "PAUSE") Sequencer::pause();
+                else if (cmd == "RESUME") Sequencer::resume();
+                else if (cmd == "RESULTS") {
+                    // Per-step results go only to the asking client: [startMs, vAvg, iAvg, samples]
+                    DynamicJsonDocument res(JSON_ARRAY_SIZE(Sequencer::MAX_STEPS) + Sequencer::MAX_STEPS * JSON_ARRAY_SIZE(4) + JSON_OBJECT_SIZE(1));
+                    JsonArray rows = res.createNestedArray("SEQR");
+                    for (uint8_t i = 0; i < Sequencer::getStepCount(); i++) {
+                        const Sequencer::StepResult& r = Sequencer::getResult(i);
+                        JsonArray row = rows.createNestedArray();
+                        row.add(r.startMs);
+                        row.add(r.vAvg);
+                        row.add(r.iAvg);
+                        row.add(r.samples);
+                    }
+                    String out;
+                    serializeJson(res, out);
+                    client->text(out);
+                }
+            }
+            if (doc.containsKey("CAL")) {
+                JsonObject cal = doc["CAL"];
+                String cmd = cal["cmd"] | "";
+                Calibration::Channel ch = cal["ch"] == "I" ? Calibration::Channel::Current : Calibration::Channel::Voltage;
+                if (cmd == "POINT") Calibration::requestPoint(ch, cal["ref"] | 0.0f);
+                else if (cmd == "CLEAR") Calibration::requestClear(ch);
+            }
+            if (doc.containsKey("TRACE")) {
+                JsonObject trace = doc["TRACE"];
+                String cmd = trace["cmd"] | "";
+                if (cmd == "REC") TraceRecorder::start(trace["dest"] == "ws" ? TraceRecorder::Dest::WebSocket : TraceRecorder::Dest::Flash, client->id());
+                else if (cmd == "STOP") TraceRecorder::stop();
+                else if (cmd == "LOAD") TraceRecorder::requestLoad();
+                else if (cmd == "SOURCE") SensorSource::select((SensorSource::Kind)(trace["kind"] | 0));
+                else if (cmd == "MOCK") SensorSource::mock().set(trace["v"] | 0.0f, trace["i"] | 0.0f, trace["ntc"] | 1.65f);
+            }
+            if (doc.containsKey("SCOPE")) {
+                JsonObject scope = doc["SCOPE"];
+                String cmd = scope["cmd"] | "";
+                if (cmd == "ARM") {
+                    Ina226Manager::CaptureConfig cfg = {
+                        (Ina226Manager::Trigger)(scope["trig"] | 0),
+                        scope["level"] | 1.0f,
+                        (uint16_t)constrain(scope["pre"] | 0, 0, 65535),
+                        (uint16_t)constrain(scope["post"] | 0, 0, 65535)
+                    };
+                    Ina226Manager::armCapture(cfg);
+                } else if (cmd == "STOP") Ina226Manager::stopCapture();
+                else if (cmd == "FETCH") {
+                    // Finished capture goes only to the asking client as one binary frame
+                    uint16_t count = Ina226Manager::getCaptureLength();
+                    AsyncWebSocketMessageBuffer *buf = count ? ws.makeBuffer(SCOPE_HEADER_BYTES + count * sizeof(Ina226Manager::CapturePoint)) : nullptr;
+                    if (buf) {
+                        const Ina226Manager::CaptureConfig &cfg = Ina226Manager::getCaptureConfig();
+                        uint8_t *frame = buf->get();
+                        uint16_t trigIndex;
+                        count = Ina226Manager::readCapture((Ina226Manager::CapturePoint *)(frame + SCOPE_HEADER_BYTES), count, trigIndex);
+                        float level = cfg.level;
+                        frame[0] = 'S';
+                        frame[1] = 'C';
+                        frame[2] = 1;                  // Frame version
+                        frame[3] = (uint8_t)cfg.trigger;
+                        memcpy(frame + 4, &count, 2);
+                        memcpy(frame + 6, &trigIndex, 2);
+                        memcpy(frame + 8, &level, 4);
+                        client->binary(buf);
+                    }
+                }
+            }
             if (doc.containsKey("WiFiEnabled")) ::wifiEnabled = !!doc["WiFiEnabled"];
             if (doc.containsKey("WiFiSSID")) strncpy(::wifiSSID, doc["WiFiSSID"], sizeof(::wifiSSID) - 1);
             if (doc.containsKey("WiFiPass")) strncpy(::wifiPass, doc["WiFiPass"], sizeof(::wifiPass) - 1);
@@ -1001,8 +1476,169 @@ void begin() {
     server.begin();
 }
 
+// Stream recorded trace bytes to the client that asked for them
+static void streamTrace() {
+    if (TraceRecorder::getDest() != TraceRecorder::Dest::WebSocket) return;
+    uint8_t buf[sizeof(TraceHeader) + 64 * sizeof(TraceRecord)];
+    AsyncWebSocketClient *client = ws.client(TraceRecorder::getClientId());
+    if (!client) {
+        TraceRecorder::stop();
+        while (TraceRecorder::drain(buf, sizeof(buf)) > 0) {} // Nobody to send to
+        return;
+    }
+    if (!client->canSend()) return;
+    size_t n = TraceRecorder::drain(buf, sizeof(buf));
+    if (n) client->binary(buf, n);
+}
+
+// Push error edges as they happen instead of waiting for the next periodic frame
+static void pushErrors() {
+    constexpr size_t MAX_EVENTS = 12; // Per message; the rest go out on the next pass
+    static ErrMgr::Cursor cursor;
+    StaticJsonDocument<JSON_OBJECT_SIZE(2) + JSON_ARRAY_SIZE(MAX_EVENTS) + MAX_EVENTS * JSON_ARRAY_SIZE(3)> doc;
+    JsonArray evs = doc.createNestedArray("EV"); // [bit, rising, micros], oldest first; bit 255 = latch cleared
+    ErrMgr::Event ev;
+    while (evs.size() < MAX_EVENTS && ErrMgr::poll(cursor, ev)) {
+        JsonArray e = evs.createNestedArray();
+        e.add(ev.bit);
+        e.add(ev.rising);
+        e.add(ev.tUs);
+    }
+    if (evs.size() == 0) return;
+    doc["ERR"] = ErrMgr::code();
+    String output;
+    serializeJson(doc, output);
+    ws.textAll(output);
+}
+
+// Serialize and broadcast; a full document drops keys silently, so report it once
+static void sendDoc(const JsonDocument& doc, const char* what) {
+    static bool warned = false;
+    if (doc.overflowed() && !warned) {
+        warned = true;
+        Serial.printf("WS %s frame overflowed its %u byte document\n", what, (unsigned)doc.capacity());
+    }
+    String output;
+    serializeJson(doc, output);
+    ws.textAll(output);
+}
+
+// System page statistics, sent as their own message so the live frame keeps its size
+static void sendSystemPage() {
+    DynamicJsonDocument doc(SYSTEM_DOC_SIZE);
+    ControlTask::Stats ct;
+    ControlTask::getStats(ct);
+    JsonObject ctl = doc.createNestedObject("CTL");
+    ctl["period"] = ct.periodUs;
+    ctl["ticks"] = ct.ticks;
+    ctl["overruns"] = ct.overruns;
+    ctl["missed"] = ct.missed;
+    ctl["jmin"] = ct.jitterMinUs;
+    ctl["jmax"] = ct.jitterMaxUs;
+    ctl["wcet"] = ct.execMaxUs;
+    ctl["stale"] = ct.staleTicks;
+    ctl["amin"] = ct.sampleAgeMinUs;
+    ctl["amax"] = ct.sampleAgeMaxUs;
+    ctl["gap"] = ct.sampleGapMaxUs;
+    ctl["skip"] = ct.skippedSamples;
+    JsonArray hist = ctl.createNestedArray("hist");
+    for (uint8_t i = 0; i < ControlTask::EXEC_HIST_BUCKETS; i++) hist.add(ct.execHist[i]);
+
+    OutputControl::TripStats ts;
+    OutputControl::getTripStats(ts);
+    JsonObject trip = doc.createNestedObject("TRIP");
+    float evalLastUs, evalMaxUs;
+    Protection::getTiming(evalLastUs, evalMaxUs);
+    trip["rules"] = Protection::getRuleCount();
+    trip["evl"] = evalLastUs;
+    trip["evm"] = evalMaxUs;
+    trip["tj"] = Thermal::getJunctionC();
+    trip["loss"] = Thermal::getLossW();
+    trip["der"] = Thermal::getDerate();
+    trip["lvl"] = Ina226Manager::getTripLimit();
+    trip["det"] = Ina226Manager::getConversionPeriodUs();
+    trip["hw"] = ts.hwTrips;
+    trip["hwl"] = ts.hwLastUs;
+    trip["hwm"] = ts.hwMaxUs;
+    trip["heat"] = OutputControl::getFuseHeat();
+    ShortDetector::Event sev[ShortDetector::LOG_SIZE];
+    uint32_t shortTotal;
+    uint8_t shortCount = OutputControl::getShortEvents(sev, ShortDetector::LOG_SIZE, shortTotal);
+    trip["sc"] = shortTotal;
+    JsonArray sevArr = trip.createNestedArray("sev"); // [age ms, A/ms, collapse, A, lead ms], newest first
+    for (uint8_t k = 0; k < shortCount; k++) {
+        JsonArray e = sevArr.createNestedArray();
+        e.add(millis() - sev[k].timeMs);
+        e.add(sev[k].slopeAms);
+        e.add(sev[k].collapse);
+        e.add(sev[k].i);
+        e.add(sev[k].savedMs);
+    }
+    trip["sw"] = ts.swTrips;
+    trip["swl"] = ts.swLastUs;
+    trip["swm"] = ts.swMaxUs;
+
+    JsonObject trc = doc.createNestedObject("TRC");
+    trc["src"] = SensorSource::active().name();
+    trc["rec"] = TraceRecorder::isRecording();
+    trc["n"] = TraceRecorder::getRecordCount();
+    trc["drop"] = TraceRecorder::getDropped();
+    trc["pos"] = SensorSource::trace().getPosition();
+    trc["count"] = SensorSource::trace().getCount();
+    BlackBox::Info recs[BlackBox::SLOTS];
+    uint8_t bbCount = BlackBox::list(recs, BlackBox::SLOTS);
+    JsonObject bbx = doc.createNestedObject("BBX");
+    bbx["w"] = BlackBox::isWriting();
+    bbx["hold"] = BlackBox::isWriting() && outputActive;
+    BlackBox::WriteStats bbw = BlackBox::getWriteStats();
+    bbx["wms"] = bbw.ms;
+    bbx["wlost"] = bbw.lostTicks;
+    bbx["miss"] = BlackBox::getMissed();
+    JsonArray bbRecs = bbx.createNestedArray("r"); // [slot, seq, errors, new bits, uptime ms, unix time, ticks], newest first
+    for (uint8_t k = 0; k < bbCount; k++) {
+        JsonArray r = bbRecs.createNestedArray();
+        r.add(recs[k].slot);
+        r.add(recs[k].seq);
+        r.add(recs[k].errorMask);
+        r.add(recs[k].newBits);
+        r.add(recs[k].uptimeMs);
+        r.add(recs[k].unixTime);
+        r.add(recs[k].count);
+    }
+    JsonArray ntcNoise = doc.createNestedArray("NTCN"); // [mV rms, °C rms]
+    ntcNoise.add(NtcSensor::getNoiseMv());
+    ntcNoise.add(NtcSensor::getNoiseC());
+
+    // Loop profiler: [calls, min, avg, max, p99] per module, in Profiler::Slot order
+    const Profiler::Snapshot& prf = Profiler::getSnapshot();
+    JsonObject prfObj = doc.createNestedObject("PRF");
+    prfObj["hz"] = prf.loopHz;
+    prfObj["lmax"] = prf.loopMaxUs;
+    DisplayManager::Stats ds;
+    DisplayManager::getStats(ds);
+    JsonArray dsp = prfObj.createNestedArray("dsp"); // [B/s, full-frame B/s, frames/s, transfers/s, bus ms/s]
+    dsp.add(ds.bytesPerSec);
+    dsp.add(ds.fullBytesPerSec);
+    dsp.add(ds.framesPerSec);
+    dsp.add(ds.transfersPerSec);
+    dsp.add(ds.busMsPerSec);
+    JsonArray mods = prfObj.createNestedArray("m");
+    for (uint8_t s = 0; s < Profiler::SLOT_COUNT; s++) {
+        const Profiler::ModuleStats& m = prf.module[s];
+        JsonArray row = mods.createNestedArray();
+        row.add(m.calls);
+        row.add(m.minUs);
+        row.add(m.avgUs);
+        row.add(m.maxUs);
+        row.add(m.p99Us);
+    }
+    sendDoc(doc, "system");
+}
+
 void update() {
     static unsigned long lastSend = 0;
+    if (!apMode) streamTrace();
+    if (!apMode) pushErrors();
     if (apMode || (millis() - lastSend) < WEBSOCKET_SEND_INTERVAL) return;
     lastSend = millis();
 
@@ -1011,7 +1647,7 @@ void update() {
         if ((millis() - kv.second.lastOpen) > PAGE_TIMEOUT) kv.second.active = false;
     }
 
-    StaticJsonDocument<2048> doc;
+    DynamicJsonDocument doc(LIVE_DOC_SIZE);
     // Live data
     doc["V"] = labV_meas;
     doc["I"] = labI_meas;
@@ -1025,14 +1661,47 @@ void update() {
     doc["HUE"] = themeHue;
     doc["WIFI_SSID"] = WiFi.SSID();
     doc["WIFI_RSSI"] = WiFi.RSSI();
+    DcControl::RampState ramp = DcControl::getRampState();
+    JsonObject rampObj = doc.createNestedObject("RAMP");
+    rampObj["v"] = ramp.vset;
+    rampObj["i"] = ramp.iset;
+    rampObj["vr"] = ramp.vRate * 1000.0f;  // V/s
+    rampObj["ir"] = ramp.iRate * 1000.0f;  // A/s
+    rampObj["on"] = ramp.vActive || ramp.iActive;
+    Energy::Totals en;
+    Energy::get(en);
+    JsonObject enObj = doc.createNestedObject("EN");
+    enObj["ah"] = en.chargeAh;
+    enObj["wh"] = en.energyWh;
+    enObj["t"] = en.runtimeS;
+    JsonArray enV = enObj.createNestedArray("v");  // [min, avg, max]
+    enV.add(en.vMin);
+    enV.add(en.vAvg);
+    enV.add(en.vMax);
+    JsonArray enI = enObj.createNestedArray("i");
+    enI.add(en.iMin);
+    enI.add(en.iAvg);
+    enI.add(en.iMax);
+    JsonArray enP = enObj.createNestedArray("p");
+    enP.add(en.pMin);
+    enP.add(en.pAvg);
+    enP.add(en.pMax);
 
     // Page flags
     doc["PAGE_CHARTS"] = pages["charts"].active ? 1 : 0;
     doc["PAGE_SETTINGS"] = pages["settings"].active ? 1 : 0;
     doc["PAGE_SYSTEM"] = pages["system"].active ? 1 : 0;
 
+    // Active scope page
+    if (pages["scope"].active) {
+        JsonObject scope = doc.createNestedObject("SCOPE");
+        scope["state"] = (uint8_t)Ina226Manager::getCaptureState();
+        scope["n"] = Ina226Manager::getCaptureCount();
+        scope["depth"] = Ina226Manager::getCaptureDepth();
+    }
+
     // Error code
-    doc["ERR"] = errorCode;
+    doc["ERR"] = ErrMgr::code();
 
     // Debug data
     if (debugEnabled) {
@@ -1059,6 +1728,61 @@ void update() {
         doc["DutyMin"] = ::dutyMin;
         doc["DutyMax"] = ::dutyMax;
         doc["InvertPWM"] = ::invertPwmSignal;
+        doc["GainSched"] = ::gainScheduleEnabled;
+        doc["FeedFwd"] = ::feedForwardEnabled;
+        doc["InaProfile"] = ::inaProfile;
+        doc["RampProfile"] = ::rampProfile;
+        doc["RampRateV"] = ::rampRateV;
+        doc["RampRateI"] = ::rampRateI;
+        doc["RampAccelMs"] = ::rampAccelMs;
+        doc["RampTauMs"] = ::rampTauMs;
+        doc["FuseCurve"] = ::fuseCurve;
+        doc["FuseTau"] = ::fuseTauS;
+        doc["FusePeak"] = ::fusePeak;
+        doc["ShortSlope"] = ::shortSlopeAms;
+        doc["ShortCollapse"] = ::shortCollapse;
+        const GainSchedule::Table& table = GainSchedule::getTable();
+        JsonObject gs = doc.createNestedObject("GS");
+        JsonArray gsV = gs.createNestedArray("v");
+        JsonArray gsR = gs.createNestedArray("r");
+        JsonArray gsK = gs.createNestedArray("k");
+        for (uint8_t i = 0; i < GainSchedule::V_POINTS; i++) gsV.add(table.vPoints[i]);
+        for (uint8_t j = 0; j < GainSchedule::R_POINTS; j++) gsR.add(table.rPoints[j]);
+        for (uint8_t l = 0; l < GainSchedule::LOOPS; l++) {
+            JsonArray loop = gsK.createNestedArray();
+            for (uint8_t g = 0; g < GainSchedule::GAINS; g++) {
+                JsonArray grid = loop.createNestedArray();
+                for (uint8_t j = 0; j < GainSchedule::R_POINTS; j++) {
+                    JsonArray row = grid.createNestedArray();
+                    for (uint8_t i = 0; i < GainSchedule::V_POINTS; i++) row.add(table.scale[l][g][j][i]);
+                }
+            }
+        }
+        JsonObject seq = doc.createNestedObject("SEQ");
+        seq["state"] = (uint8_t)Sequencer::getState();
+        seq["step"] = Sequencer::getCurrentStep();
+        seq["loop"] = Sequencer::getLoop();
+        seq["loops"] = Sequencer::getLoops();
+        seq["count"] = Sequencer::getStepCount();
+        // Calibration points: [raw, reference] per channel
+        const Calibration::Table& calTable = Calibration::getTable();
+        JsonObject cal = doc.createNestedObject("CAL");
+        const char* calKeys[] = {"v", "i"};
+        for (uint8_t c = 0; c < (uint8_t)Calibration::Channel::Count; c++) {
+            JsonArray pts = cal.createNestedArray(calKeys[c]);
+            for (uint8_t k = 0; k < calTable.ch[c].count; k++) {
+                JsonArray pt = pts.createNestedArray();
+                pt.add(calTable.ch[c].raw[k]);
+                pt.add(calTable.ch[c].ref[k]);
+            }
+        }
+        cal["st"] = Calibration::getStatus();
+        JsonObject at = doc.createNestedObject("AT");
+        at["state"] = (uint8_t)AutoTune::getState();
+        at["loop"] = AutoTune::getLoop() == AutoTune::Loop::Voltage ? "CV" : "CC";
+        at["status"] = AutoTune::getStatus();
+        at["ku"] = AutoTune::getKu();
+        at["tu"] = AutoTune::getTu();
         doc["WiFiEnabled"] = ::wifiEnabled;
         doc["WiFiSSID"] = ::wifiSSID;
         doc["WiFiPass"] = ::wifiPass;
@@ -1074,10 +1798,8 @@ void update() {
         doc["DBG"] = ::dbgMode;
     }
 
-    // Send to clients
-    String output;
-    serializeJson(doc, output);
-    ws.textAll(output);
+    sendDoc(doc, "live");
+    if (pages["system"].active) sendSystemPage();
 }
 
 } // namespace WebInterface
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "WifiOtaManager.h"
 #include "Globals.h"
+#include "ErrMgr.h"
 #include <WiFi.h>
 #include <ArduinoOTA.h>
 
@@ -69,10 +70,10 @@ static void updateSTAInfo() {
 static void setupAP() {
   WiFi.mode(WIFI_AP);
   if (!WiFi.softAP(apSSID, apPass)) {
-    errorWifiInitFail = true; // Set error flag on failure
+    ErrMgr::set(ErrMgr::WifiInitFail); // Set error flag on failure
     return;
   }
-  errorWifiInitFail = false;
+  ErrMgr::clear(ErrMgr::WifiInitFail);
   wifiConnected = true;
   IPAddress ip = WiFi.softAPIP();
   snprintf(wifiIP, sizeof(wifiIP), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
@@ -83,10 +84,10 @@ static void setupAP() {
 static void setupSTA() {
   WiFi.mode(WIFI_STA);
   if (!WiFi.begin(wifiSSID, wifiPass)) {
-    errorWifiInitFail = true; // Set error flag on failure
+    ErrMgr::set(ErrMgr::WifiInitFail); // Set error flag on failure
     return;
   }
-  errorWifiInitFail = false;
+  ErrMgr::clear(ErrMgr::WifiInitFail);
   wifiConnected = false;
   if (otaEnabled) startOTA();
 }
@@ -94,7 +95,7 @@ static void setupSTA() {
 // Initialize Wi-Fi and OTA
 void begin() {
   if (!wifiEnabled) {
-    errorWifiInitFail = true;
+    ErrMgr::set(ErrMgr::WifiInitFail);
     return;
   }
 
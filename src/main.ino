@@ -1,5 +1,6 @@
 #include <WiFi.h>
 #include <Wire.h>
+#include <LittleFS.h>
 #include <ESPmDNS.h>
 #include <WiFiUdp.h>
 #include <ArduinoOTA.h>
@@ -17,6 +18,10 @@
 #include "WebInterface.h"
 #include "PreferencesManager.h"
 #include "ErrMgr.h"
+#include "ControlTask.h"
+#include "Profiler.h"
+#include "TraceRecorder.h"
+#include "BlackBox.h"
 
 // Initialize hardware and managers
 void setup() {
@@ -34,10 +39,16 @@ void setup() {
   WifiOtaManager::begin();
   WebInterface::begin();
   ErrMgr::begin();
+  bool fsMounted = LittleFS.begin(true); // Format on first use; shared by the trace recorder and black box
+  TraceRecorder::begin(fsMounted);
+  BlackBox::begin(fsMounted);
+  ControlTask::begin(); // Control and protection run on a timer-driven task
 }
 
 // Main loop for updating system components
 void loop() {
+  Profiler::beginLoop();
+
   // Blink LED at specified interval
   if (millis() - lastBlink >= LED_BLINK_INTERVAL) {
     ledState = !ledState;
@@ -45,14 +56,14 @@ void loop() {
     lastBlink = millis();
   }
 
-  EncoderManager::update();
-  Ina226Manager::update();
-  OutputControl::update();
-  TouchUI::update();
-  DcControl::update();
-  WifiOtaManager::update();
-  WebInterface::update();
-  DisplayManager::update();
-  ErrMgr::update();
-  PreferencesManager::update();
+  Profiler::run(Profiler::SLOT_ENCODER, EncoderManager::update);
+  Profiler::run(Profiler::SLOT_INA226, Ina226Manager::update);
+  Profiler::run(Profiler::SLOT_CONTROL_POLL, ControlTask::poll);
+  Profiler::run(Profiler::SLOT_TOUCH, TouchUI::update);
+  Profiler::run(Profiler::SLOT_WIFI_OTA, WifiOtaManager::update);
+  Profiler::run(Profiler::SLOT_WEB, WebInterface::update);
+  Profiler::run(Profiler::SLOT_DISPLAY, DisplayManager::update);
+  Profiler::run(Profiler::SLOT_PREFS, PreferencesManager::update);
+  Profiler::run(Profiler::SLOT_TRACE, TraceRecorder::update);
+  Profiler::run(Profiler::SLOT_BLACKBOX, BlackBox::update);
 }
\ No newline at end of file
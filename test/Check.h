@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdio.h>
+#include <math.h>
+
+// Minimal assertions for the host tests: failures are counted, main() returns the count
+
+inline int& checkFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if (!(cond)) {                                                        \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);     \
+      checkFailures()++;                                                  \
+    }                                                                     \
+  } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                             \
+  do {                                                                    \
+    double va_ = (a), vb_ = (b);                                          \
+    if (!(fabs(va_ - vb_) <= (tol))) {                                    \
+      printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g (tol %g)\n",     \
+             __FILE__, __LINE__, #a, #b, va_, vb_, (double)(tol));        \
+      checkFailures()++;                                                  \
+    }                                                                     \
+  } while (0)
+
+inline int checkResult(const char* name) {
+  printf("%s: %s (%d failures)\n", name, checkFailures() ? "FAIL" : "ok", checkFailures());
+  return checkFailures() ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+// DcControl built with the Q16.16 kernel under its own namespace, so the fixed-point benchmark can
+// run both kernels against the plant in one process
+#define PID_FIXED_POINT 1
+#define DcControl DcControlQ16
+#include "DcControl.cpp"
@@ -0,0 +1,5 @@
+// DisplayManager built with full-frame transfers under its own namespace, so the display benchmark
+// can drive both transfer modes in one process
+#define DISPLAY_DIFF_UPDATE 0
+#define DisplayManager DisplayManagerFull
+#include "DisplayManager.cpp"
@@ -0,0 +1,220 @@
+// Closed-loop benchmark of DcControl against the plant model.
+// Reports settling time, overshoot, steady-state error, CV/CC transition time and host CPU
+// time per tick for step, load-dump and short-circuit scenarios, and the same voltage step with
+// the duty feed-forward off, on with its seed table, and on after a learning pass; fails on
+// regression bounds.
+
+#include "Check.h"
+#include "Rig.h"
+#include "HostHal.h"
+#include "Globals.h"
+#include "FeedForward.h"
+#include <vector>
+
+using Trace = std::vector<Rig::Point>;
+
+struct Result {
+  const char* name;
+  float settleMs;      // Last excursion outside the band after the event (ms), NAN = never settled
+  float overshoot;     // Excursion past the target in the step direction (V or A)
+  float sse;           // Mean |error| over the last second (V or A)
+  float transitionMs;  // Time until the other loop first regulates inside its band (ms), NAN = n/a
+  int flips;           // CV/CC mode changes after the event
+  double nsPerTick;    // Mean host CPU time of one DcControl step
+};
+
+static Trace record(uint32_t ms) {
+  Trace t;
+  uint64_t stop = HostHal::nowUs() + ms * 1000ULL;
+  while (HostHal::nowUs() < stop) t.push_back(Rig::tick());
+  return t;
+}
+
+static float value(const Rig::Point& p, bool current) { return current ? p.i : p.v; }
+
+// Time from the event until the signal last left target +/- band
+static float settleMs(const Trace& t, uint64_t t0, float target, float band, bool current) {
+  uint64_t last = t0;
+  for (const auto& p : t)
+    if (fabsf(value(p, current) - target) > band) last = p.us;
+  if (last == t.back().us) return NAN;
+  return (last - t0) / 1000.0f;
+}
+
+static float overshoot(const Trace& t, float from, float target, bool current) {
+  float dir = target >= from ? 1.0f : -1.0f;
+  float worst = 0.0f;
+  for (const auto& p : t) worst = max(worst, (value(p, current) - target) * dir);
+  return worst;
+}
+
+static float sse(const Trace& t, float target, bool current) {
+  uint64_t from = t.back().us - 1000000ULL;
+  double sum = 0.0;
+  int n = 0;
+  for (const auto& p : t)
+    if (p.us > from) {
+      sum += fabsf(value(p, current) - target);
+      n++;
+    }
+  return n ? (float)(sum / n) : NAN;
+}
+
+// Time until the given loop is active with its signal inside the band
+static float transitionMs(const Trace& t, uint64_t t0, bool toCC, float target, float band) {
+  for (const auto& p : t)
+    if (p.cc == toCC && fabsf(value(p, toCC) - target) <= band) return (p.us - t0) / 1000.0f;
+  return NAN;
+}
+
+static int flips(const Trace& t, bool startCC) {
+  int n = 0;
+  bool cc = startCC;
+  for (const auto& p : t) {
+    if (p.cc != cc) n++;
+    cc = p.cc;
+  }
+  return n;
+}
+
+static float vBand(float v) { return max(0.005f * v, 0.02f); }
+static float iBand(float i) { return max(0.02f * i, 0.01f); }
+
+// Setpoint step with a light resistive load
+static Result stepScenario(const char* name, const Plant::Config& cfg, float from, float to) {
+  Rig::begin(cfg, 100.0f, from, 2.0f);
+  Rig::run(3000);
+  uint64_t t0 = HostHal::nowUs();
+  labV_set = to;
+  Trace t = record(3000);
+  return {name, settleMs(t, t0, to, vBand(to), false), overshoot(t, from, to, false),
+          sse(t, to, false), NAN, flips(t, false), Rig::getTickNs()};
+}
+
+// Full load released at 12 V: the converter cannot sink, the loop has to pull the droop back out
+static Result loadDumpScenario() {
+  Rig::begin(Plant::buck(), 6.0f, 12.0f, 3.0f);
+  Rig::run(3000);
+  uint64_t t0 = HostHal::nowUs();
+  Plant::setLoad(1000.0f);
+  Trace t = record(3000);
+  return {"load dump 2A->12mA", settleMs(t, t0, 12.0f, vBand(12.0f), false), overshoot(t, 11.0f, 12.0f, false),
+          sse(t, 12.0f, false), NAN, flips(t, false), Rig::getTickNs()};
+}
+
+// Load steps past the current limit and back
+static Result cvToCcScenario() {
+  Rig::begin(Plant::buck(), 12.0f, 12.0f, 1.5f);
+  Rig::run(3000);
+  uint64_t t0 = HostHal::nowUs();
+  Plant::setLoad(4.0f);
+  Trace t = record(3000);
+  return {"CV->CC 1A->1.5A lim", settleMs(t, t0, 1.5f, iBand(1.5f), true), overshoot(t, 1.0f, 1.5f, true),
+          sse(t, 1.5f, true), transitionMs(t, t0, true, 1.5f, iBand(1.5f)), flips(t, false), Rig::getTickNs()};
+}
+
+static Result ccToCvScenario() {
+  Rig::begin(Plant::buck(), 4.0f, 12.0f, 1.5f);
+  Rig::run(3000);
+  uint64_t t0 = HostHal::nowUs();
+  Plant::setLoad(12.0f);
+  Trace t = record(3000);
+  return {"CC->CV 1.5A lim->1A", settleMs(t, t0, 12.0f, vBand(12.0f), false), overshoot(t, 6.0f, 12.0f, false),
+          sse(t, 12.0f, false), transitionMs(t, t0, false, 12.0f, vBand(12.0f)), flips(t, true), Rig::getTickNs()};
+}
+
+// Dead short at 12 V with a 1 A limit. The output cannot go below Vref plus the dutyMin offset,
+// so the current stays at the converter's switch limit; the figure of merit is how fast the CC
+// loop reaches dutyMin (the protection path has to open the output from there).
+static Result shortScenario(float& peakA) {
+  Rig::begin(Plant::buck(), 12.0f, 12.0f, 1.0f);
+  Rig::run(3000);
+  uint64_t t0 = HostHal::nowUs();
+  Plant::setLoad(0.05f);
+  Trace t = record(3000);
+  peakA = 0.0f;
+  float floorMs = NAN;
+  for (const auto& p : t) {
+    peakA = max(peakA, p.i);
+    if (isnan(floorMs) && p.cc && p.duty <= dutyMin) floorMs = (p.us - t0) / 1000.0f;
+  }
+  return {"short 12V/1A lim", settleMs(t, t0, 1.0f, iBand(1.0f), true), overshoot(t, 1.0f, 1.0f, true),
+          sse(t, 1.0f, true), floorMs, flips(t, false), Rig::getTickNs()};
+}
+
+constexpr float FF_RAMP_V_MS = 0.02f;  // Setpoint slew for the feed-forward steps (V/ms): 17 V in 850 ms
+
+// Slewed setpoint step with the feed-forward off, on with the seed table, or on after learning at both ends
+static Result feedForwardScenario(const char* name, bool enabled, bool learn, float from, float to) {
+  feedForwardEnabled = enabled;
+  FeedForward::setTable(FeedForward::defaultTable());
+  if (learn) {
+    Rig::begin(Plant::buck(), 100.0f, from, 2.0f);
+    for (int pass = 0; pass < 3; pass++) {
+      labV_set = from;
+      Rig::run(20000);
+      labV_set = to;
+      Rig::run(20000);
+    }
+  }
+  Rig::begin(Plant::buck(), 100.0f, from, 2.0f);
+  Rig::run(3000);
+  rampRateV = FF_RAMP_V_MS;
+  uint64_t t0 = HostHal::nowUs();
+  labV_set = to;
+  Trace t = record(4000);
+  feedForwardEnabled = false;
+  return {name, settleMs(t, t0, to, vBand(to), false), overshoot(t, from, to, false), sse(t, to, false), NAN,
+          flips(t, false), Rig::getTickNs()};
+}
+
+static void print(const Result& r, bool current) {
+  const char* u = current ? "A" : "V";
+  printf("%-24s %9.0f %9.3f %s %9.4f %s %9.0f %6d %9.0f\n", r.name, r.settleMs, r.overshoot, u, r.sse, u,
+         r.transitionMs, r.flips, r.nsPerTick);
+}
+
+int main() {
+  printf("%-24s %9s %11s %11s %9s %6s %9s\n", "scenario", "settle ms", "overshoot", "SS error", "CV/CC ms",
+         "flips", "ns/tick");
+
+  Result up = stepScenario("step 5->12V", Plant::buck(), 5.0f, 12.0f);
+  print(up, false);
+  Result down = stepScenario("step 12->5V", Plant::buck(), 12.0f, 5.0f);
+  print(down, false);
+  Result lin = stepScenario("step 5->12V (linear)", Plant::linear(), 5.0f, 12.0f);
+  print(lin, false);
+  Result dump = loadDumpScenario();
+  print(dump, false);
+  Result cc = cvToCcScenario();
+  print(cc, true);
+  Result cv = ccToCvScenario();
+  print(cv, false);
+  float peakA;
+  Result sc = shortScenario(peakA);
+  print(sc, true);
+  printf("short: peak %.2f A averaged reading, CV/CC column = time to dutyMin\n", peakA);
+  Result ffOff = feedForwardScenario("step 3->20V, FF off", false, false, 3.0f, 20.0f);
+  print(ffOff, false);
+  Result ffSeed = feedForwardScenario("step 3->20V, FF seed", true, false, 3.0f, 20.0f);
+  print(ffSeed, false);
+  Result ffLearned = feedForwardScenario("step 3->20V, FF learned", true, true, 3.0f, 20.0f);
+  print(ffLearned, false);
+
+  // Regression bounds: the current tuning with margin; tighten them when the loops improve
+  CHECK(up.settleMs < 1600.0f && up.overshoot < 3.0f && up.sse < 0.06f);
+  CHECK(down.settleMs < 3000.0f && down.overshoot < 1.4f && down.sse < 0.04f);
+  CHECK(lin.settleMs < 3000.0f && lin.overshoot < 1.2f && lin.sse < 0.08f);
+  CHECK(dump.settleMs < 300.0f && dump.overshoot < 0.35f && dump.sse < 0.04f);
+  CHECK(cc.transitionMs < 700.0f && cc.flips <= 12);
+  CHECK(cv.transitionMs < 400.0f && cv.settleMs < 2500.0f && cv.flips <= 2);
+  CHECK(sc.transitionMs < 150.0f);
+  // The feed-forward carries the duty along the ramp: settled shortly after the 850 ms ramp instead of
+  // the PID catching up afterwards, and learning tightens it further
+  CHECK(ffOff.settleMs < 3000.0f && ffOff.overshoot < 0.3f);
+  CHECK(ffLearned.settleMs < 1000.0f && ffLearned.settleMs < ffOff.settleMs / 2.0f);
+  CHECK(ffLearned.settleMs <= ffSeed.settleMs && ffLearned.overshoot <= ffSeed.overshoot);
+  CHECK(ffLearned.overshoot < 0.5f && ffLearned.sse < ffOff.sse);
+
+  return checkResult("bench_control");
+}
@@ -0,0 +1,174 @@
+// DisplayManager transfers on the SSD1306 stub: the same scripted session (idle, live readings, a
+// Vset edit, the config pages, an overheat fault) with changed-tile transfers and with a full frame
+// every redraw (DISPLAY_DIFF_UPDATE 1 and 0). Prints the updateDisplayArea()/sendBuffer() calls and
+// bytes per phase, and checks that the panel ends every phase showing the frame buffer.
+
+#include "Check.h"
+#include "HostHal.h"
+#include "Config.h"
+#include "DisplayManager.h"
+#include "EncoderManager.h"
+#include "ErrMgr.h"
+#include "Globals.h"
+#include <vector>
+
+namespace DisplayManagerFull {
+  extern U8G2_SSD1306_128X64_NONAME_F_HW_I2C display;
+  void begin();
+  void update();
+}
+
+// Declared in SegmentFont.h for drawSegmentBlinkRange(), which the firmware link drops as unused
+bool blinkState = true;
+uint16_t blinkInterval = 500;
+
+constexpr uint32_t LOOP_US = 2000;        // loop() pass without the display
+constexpr uint32_t BYTE_NS = 22500;       // 9 bit times at 400 kHz
+constexpr uint32_t SAMPLE_MS = 35;        // New INA226 reading
+constexpr uint32_t PRESS_MS = 800;        // Long press
+
+struct Variant {
+  const char* name;
+  U8G2& display;
+  void (*begin)();
+  void (*update)();
+};
+
+// One step of the session, driven every loop() pass
+struct Phase {
+  const char* name;
+  uint32_t ms;
+  void (*step)();
+};
+
+static uint32_t seed = 1;
+static uint32_t passFrom = 0, passTo = 0;  // Phase time covered by this loop() pass (ms, inclusive)
+
+// A pass can take longer than 1 ms, so events fire on the pass whose window holds their time
+static bool at(uint32_t ms) { return ms >= passFrom && ms <= passTo; }
+static bool every(uint32_t ms) { return passFrom <= passTo && (passFrom == 0 || (passFrom - 1) / ms != passTo / ms); }
+
+static float noise(float amplitude) {
+  seed = seed * 1664525u + 1013904223u;
+  return ((seed >> 8) / 16777216.0f - 0.5f) * 2.0f * amplitude;
+}
+
+static void measure(float v, float i) {
+  labV_meas = v;
+  labI_meas = i;
+  labQ_meas = v * i;
+}
+
+static void press(uint32_t ms) {
+  if (at(ms)) HostHal::setPinLevel(ENC_SW, LOW);
+  if (at(ms + PRESS_MS)) HostHal::setPinLevel(ENC_SW, HIGH);
+}
+
+static const Phase PHASES[] = {
+  // First main screen after the boot message, while the smoothed readings settle
+  {"boot", 3000, [] { measure(12.0f, 0.5f); }},
+  {"idle", 10000, [] { measure(12.0f, 0.5f); }},
+  {"live", 10000, [] {
+     if (every(SAMPLE_MS)) measure(12.0f + noise(0.005f), 0.5f + noise(0.002f));
+   }},
+  // Eight detents up, then the edit times out back to the idle screen
+  {"edit", 15000, [] {
+     measure(12.0f, 0.5f);
+     if (passTo < 2000 && every(250)) HostHal::turnEncoder(1);
+   }},
+  // Into the config pages, once round all of them, back to the main screen
+  {"menu", 12000, [] {
+     press(0);
+     for (int page = 1; page <= EncoderManager::getMenuCount(); page++)
+       if (at(1000 + 1000 * page)) HostHal::turnEncoder(1);
+     press(10000);
+   }},
+  // Overheat for 3 s, then 3 s latched with the header blinking
+  {"fault", 6000, [] {
+     if (at(0)) ErrMgr::set(ErrMgr::Overheat);
+     if (at(3000)) ErrMgr::clear(ErrMgr::Overheat);
+   }},
+};
+constexpr int PHASE_COUNT = sizeof(PHASES) / sizeof(PHASES[0]);
+
+static void clearErrors() {
+  ErrMgr::assign(UINT32_MAX, 0);
+  manualOutputEnable = true;
+  ErrMgr::update();
+  manualOutputEnable = false;
+  ErrMgr::update();
+}
+
+// Runs the session; per-phase transfers, and whether the panel matched the buffer after every phase
+static std::vector<U8g2Transfers> runSession(const Variant& v, bool& panelMatches) {
+  HostHal::reset();
+  HostHal::costs().oledByteNs = BYTE_NS;
+  lastDisplayUpdate = 0;
+  labV_set = 12.0f;
+  labI_set = 1.0f;
+  labI_cut = 2.0f;
+  seed = 1;
+  clearErrors();
+  v.begin();
+  EncoderManager::begin();
+
+  std::vector<U8g2Transfers> out;
+  panelMatches = true;
+  for (const Phase& p : PHASES) {
+    v.display.resetTransfers();
+    uint64_t start = HostHal::nowUs();
+    passTo = UINT32_MAX;
+    for (uint64_t now = start; now - start < p.ms * 1000ULL; now = HostHal::nowUs()) {
+      passFrom = passTo + 1;
+      passTo = (now - start) / 1000;
+      p.step();
+      EncoderManager::update();
+      v.update();
+      HostHal::advanceUs(LOOP_US);
+    }
+    out.push_back(v.display.getTransfers());
+    panelMatches &= memcmp(v.display.getPanel(), v.display.getBufferPtr(), U8G2::BUFFER_BYTES) == 0;
+  }
+  clearErrors();
+  return out;
+}
+
+int main() {
+  manualOutputEnable = false;
+  ErrMgr::update();
+  ErrMgr::begin();
+
+  Variant diff = {"tiles", DisplayManager::display, DisplayManager::begin, DisplayManager::update};
+  Variant full = {"full", DisplayManagerFull::display, DisplayManagerFull::begin, DisplayManagerFull::update};
+  bool diffMatches, fullMatches;
+  std::vector<U8g2Transfers> d = runSession(diff, diffMatches);
+  CHECK(EncoderManager::getScreenState() == EncoderManager::ScreenState::MainIdle);
+  float vsetAfterEdit = labV_set;
+  std::vector<U8g2Transfers> f = runSession(full, fullMatches);
+  CHECK(EncoderManager::getScreenState() == EncoderManager::ScreenState::MainIdle);
+
+  printf("%-6s %-6s %6s %6s %6s %9s %9s %8s\n", "phase", "mode", "frames", "areas", "rows", "data B", "I2C B",
+         "bus ms/s");
+  uint32_t diffTotal = 0, fullTotal = 0;
+  for (int k = 0; k < PHASE_COUNT; k++) {
+    const Phase& p = PHASES[k];
+    for (const U8g2Transfers* t : {&d[k], &f[k]}) {
+      printf("%-6s %-6s %6u %6u %6u %9u %9u %8.1f\n", p.name, t == &d[k] ? diff.name : full.name,
+             (unsigned)t->sendBuffers, (unsigned)t->areas, (unsigned)t->rows, (unsigned)t->dataBytes,
+             (unsigned)t->i2cBytes, t->i2cBytes * (BYTE_NS * 1e-6) / (p.ms * 1e-3));
+    }
+    diffTotal += d[k].i2cBytes;
+    fullTotal += f[k].i2cBytes;
+    CHECK(f[k].areas == 0);                   // Full mode never sends a partial frame
+    CHECK(d[k].i2cBytes < f[k].i2cBytes);
+  }
+  printf("total: %u bytes with changed tiles, %u with full frames (%.1f %%)\n", (unsigned)diffTotal,
+         (unsigned)fullTotal, 100.0 * diffTotal / fullTotal);
+
+  CHECK(diffMatches);
+  CHECK(fullMatches);
+  CHECK_NEAR(vsetAfterEdit, 12.08f, 1e-4f);   // Eight 10 mV detents
+  CHECK(d[1].sendBuffers == 0 && d[1].areas == 0);  // Nothing changes on a steady screen
+  CHECK(d[2].i2cBytes * 10 < f[2].i2cBytes);       // Live readings: a few digits per redraw
+  return checkResult("bench_display");
+}
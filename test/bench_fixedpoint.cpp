@@ -0,0 +1,109 @@
+// Float vs Q16.16 DcControl kernels on the plant model: host time per tick and duty/voltage
+// difference over a scenario that exercises both loops. Each kernel runs the scenario from the
+// same start; the traces are compared tick by tick.
+
+#include "Check.h"
+#include "HostHal.h"
+#include "Plant.h"
+#include "Globals.h"
+#include "Config.h"
+#include "DcControl.h"
+#include "FixedPoint.h"
+#include <chrono>
+#include <vector>
+
+namespace DcControlQ16 {
+  void begin();
+  void tick(bool freshSample);
+  float getPwmDuty();
+}
+
+struct Kernel {
+  const char* name;
+  void (*begin)();
+  void (*tick)(bool);
+  float (*duty)();
+};
+
+struct Run {
+  std::vector<float> duty;
+  std::vector<float> v;
+  double nsPerTick;
+};
+
+// 5 V -> 12 V step, load step into the 1.5 A limit and back, 12 V -> 3.3 V
+static Run runScenario(const Kernel& k) {
+  HostHal::reset();
+  Plant::reset(Plant::buck(), 100.0f);
+  controlPeriodUs = DC_CONTROL_UPDATE_INTERVAL * 1000UL;
+  labV_set = rampedVset = 5.0f;
+  labI_set = rampedIset = 1.5f;
+  labV_meas = labI_meas = 0.0f;
+  rampRateV = 0.003f;
+  rampRateI = 0.0f;
+  modeAuto = outputActive = true;
+  isCC = false;
+  k.begin();
+
+  Run r;
+  double ns = 0.0;
+  for (int n = 0; n < 600; n++) {
+    if (n == 100) labV_set = 12.0f;
+    if (n == 250) Plant::setLoad(4.0f);
+    if (n == 350) Plant::setLoad(100.0f);
+    if (n == 450) labV_set = 3.3f;
+
+    Plant::run(HostHal::ledcDuty(DC_CONTROL_PIN), controlPeriodUs);
+    HostHal::advanceUs(controlPeriodUs);
+    Plant::Sample s = Plant::sample();
+    labV_meas = s.v;
+    labI_meas = s.i;
+
+    auto t0 = std::chrono::steady_clock::now();
+    k.tick(true);
+    ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    r.duty.push_back(k.duty());
+    r.v.push_back(labV_meas);
+  }
+  r.nsPerTick = ns / r.duty.size();
+  return r;
+}
+
+int main() {
+  // Conversion and multiply error of the Q16.16 helpers over the control range
+  double convErr = 0.0, mulErr = 0.0;
+  uint32_t seed = 7;
+  for (int n = 0; n < 100000; n++) {
+    seed = seed * 1664525u + 1013904223u;
+    float a = ((seed >> 8) / 16777216.0f - 0.5f) * 200.0f;  // Duty-scale values
+    seed = seed * 1664525u + 1013904223u;
+    float b = ((seed >> 8) / 16777216.0f - 0.5f) * 20.0f;   // Gains
+    convErr = fmax(convErr, fabs(fromQ16(toQ16(a)) - a));
+    mulErr = fmax(mulErr, fabs(fromQ16(q16Mul(toQ16(a), toQ16(b))) - (double)a * b));
+  }
+  printf("Q16.16 helpers: max conversion error %.2e, max multiply error %.2e\n", convErr, mulErr);
+
+  Run f = runScenario({"float", DcControl::begin, DcControl::tick, DcControl::getPwmDuty});
+  Run q = runScenario({"q16", DcControlQ16::begin, DcControlQ16::tick, DcControlQ16::getPwmDuty});
+
+  double maxDuty = 0.0, sumDuty = 0.0, maxV = 0.0;
+  for (size_t n = 0; n < f.duty.size(); n++) {
+    double d = fabs(f.duty[n] - q.duty[n]);
+    maxDuty = fmax(maxDuty, d);
+    sumDuty += d;
+    maxV = fmax(maxV, fabs(f.v[n] - q.v[n]));
+  }
+
+  printf("%-8s %10s\n", "kernel", "ns/tick");
+  printf("%-8s %10.1f\n", "float", f.nsPerTick);
+  printf("%-8s %10.1f\n", "q16", q.nsPerTick);
+  printf("duty difference: max %.4f %%, mean %.5f %%; voltage difference: max %.4f V\n",
+         maxDuty, sumDuty / f.duty.size(), maxV);
+  printf("(host figures; on the ESP32-S2 the float path is soft-float and the Profiler page has the on-target cost)\n");
+
+  CHECK(convErr <= 0.5 / Q16_ONE + 1e-6);
+  CHECK(mulErr < 2e-3);
+  CHECK(maxDuty < 0.05);   // 0.05 % duty is two 12-bit PWM steps
+  CHECK(maxV < 0.02);
+  return checkResult("bench_fixedpoint");
+}
@@ -0,0 +1,152 @@
+// Protection::evaluate() microbenchmark: host time per call for the rule table against the same rules
+// written out by hand, in steady state (no bit changes) and with the overcurrent rule tripping and
+// clearing every few calls. Also checks the table's debounce, hysteresis and latch behaviour. On the ESP32-S2
+// the System page shows the on-target cost, measured in CPU cycles around every call.
+
+#include "Check.h"
+#include "HostHal.h"
+#include "ErrMgr.h"
+#include "FuseModel.h"
+#include "Globals.h"
+#include "Protection.h"
+#include <chrono>
+
+constexpr int N = 1000000;
+constexpr int RUNS = 5;
+constexpr uint32_t PERIOD_US = 35000;
+constexpr uint8_t DEBOUNCE = 3;            // 105 ms at 35 ms
+
+static float currents[4096];
+
+// The rule table written out as one hand-written check per protection
+struct InlineRules {
+  uint8_t heat = 0, vdev = 0, idev = 0;    // Debounce counters
+  bool hot = false, fuse = false, hw = false, sc = false;
+
+  __attribute__((noinline)) uint32_t evaluate(const Protection::Inputs& in) {  // Out of line, like the table
+    uint32_t bits = 0;
+    hot = in.junctionC >= tempLimitC - (hot ? tempDiffC : 0.0f) ? (heat < DEBOUNCE ? ++heat : heat) >= DEBOUNCE
+                                                                 : (heat = 0, false);
+    if (hot) bits |= 1UL << ErrMgr::Overheat;
+    if (!in.starting && labI_meas > systemIlimitMax) bits |= 1UL << ErrMgr::OverCurrent;
+    fuse = in.fuseHeat >= 1.0f - (fuse ? 1.0f - FuseModel::RESET_HEAT : 0.0f);
+    if (fuse) bits |= 1UL << ErrMgr::FuseBlown;
+    if (labTemp_ntc < 0.0f || labTemp_ntc > 100.0f) bits |= 1UL << ErrMgr::SensorFail;
+    if (!in.starting && (labV_meas < systemVoutMin || labV_meas > systemVoutMax)) bits |= 1UL << ErrMgr::VoutOverLimit;
+    if (!in.starting && labQ_meas > systemPowerMax) bits |= 1UL << ErrMgr::OverPower;
+    bool v = modeAuto && !in.starting && !isCC && fabsf(labV_meas - rampedVset) > VdevLimit;
+    if (v ? ++vdev >= DEBOUNCE : (vdev = 0, false)) {
+      vdev = DEBOUNCE;
+      bits |= 1UL << ErrMgr::VoltageDev;
+    }
+    bool i = modeAuto && labI_meas / rampedIset - 1.0f > IdevLimit;
+    if (i ? ++idev >= DEBOUNCE : (idev = 0, false)) {
+      idev = DEBOUNCE;
+      bits |= 1UL << ErrMgr::CurrentDev;
+    }
+    hw = in.hwTrip || (hw && !in.enableEdge);
+    if (hw) bits |= 1UL << ErrMgr::HwOverCurrent;
+    sc = in.shortTrip || (sc && !in.enableEdge);
+    if (sc) bits |= 1UL << ErrMgr::ShortCircuit;
+    ErrMgr::assign(OWNED, bits);
+    return bits;
+  }
+
+  static constexpr uint32_t OWNED =
+      (1UL << ErrMgr::Overheat) | (1UL << ErrMgr::OverCurrent) | (1UL << ErrMgr::FuseBlown) |
+      (1UL << ErrMgr::SensorFail) | (1UL << ErrMgr::VoutOverLimit) | (1UL << ErrMgr::OverPower) |
+      (1UL << ErrMgr::VoltageDev) | (1UL << ErrMgr::CurrentDev) | (1UL << ErrMgr::HwOverCurrent) |
+      (1UL << ErrMgr::ShortCircuit);
+};
+
+// Typical running state: 12 V / 1 A regulated in CV, everything inside its limits
+static Protection::Inputs steadyState() {
+  labV_meas = rampedVset = labV_set = 12.0f;
+  labI_meas = 1.0f;
+  rampedIset = labI_set = 2.0f;
+  labQ_meas = 12.0f;
+  labTemp_ntc = 30.0f;
+  modeAuto = true;
+  isCC = false;
+  Protection::Inputs in = {};
+  in.junctionC = 40.0f;
+  in.fuseHeat = 0.2f;
+  return in;
+}
+
+// Best of RUNS: ns per evaluate(); tripping = current crosses the system limit every few calls
+template <typename Eval>
+static double nsPerCall(Eval eval, bool tripping, uint32_t& sink) {
+  double best = 1e30;
+  for (int run = 0; run < RUNS; run++) {
+    Protection::Inputs in = steadyState();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < N; k++) {
+      if (tripping) labI_meas = currents[k & 4095];
+      sink += eval(in);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    best = fmin(best, ns / N);
+  }
+  return best;
+}
+
+int main() {
+  HostHal::reset();
+  ErrMgr::begin();
+  Protection::setPeriod(PERIOD_US);
+  uint32_t seed = 1;
+  for (float& i : currents) {
+    seed = seed * 1664525u + 1013904223u;
+    i = (seed >> 8) % 4 == 0 ? systemIlimitMax + 0.5f : 1.0f;  // Over the limit one call in four
+  }
+
+  uint32_t sink = 0;
+  InlineRules inl;
+  auto table = [](const Protection::Inputs& in) { return Protection::evaluate(in); };
+  auto hand = [&inl](const Protection::Inputs& in) { return inl.evaluate(in); };
+  double tableQuiet = nsPerCall(table, false, sink);
+  double inlineQuiet = nsPerCall(hand, false, sink);
+  double tableTrip = nsPerCall(table, true, sink);
+  double inlineTrip = nsPerCall(hand, true, sink);
+
+  printf("%-12s %8s %12s %12s\n", "evaluator", "rules", "steady ns", "tripping ns");
+  printf("%-12s %8u %12.1f %12.1f\n", "table", (unsigned)Protection::getRuleCount(), tableQuiet, tableTrip);
+  printf("%-12s %8u %12.1f %12.1f\n", "hand-written", (unsigned)Protection::getRuleCount(), inlineQuiet, inlineTrip);
+  printf("(sink %u)\n", (unsigned)sink);
+  // The table pays for its indirection (limit pointers, per-rule state) with a few times the if-chain's
+  // time; both stay orders of magnitude under the 5 ms fast-profile tick
+  CHECK(tableQuiet < 1000.0 && tableTrip < 1000.0);
+
+  // Behaviour: debounce, gates, hysteresis and latches
+  Protection::Inputs in = steadyState();
+  CHECK(Protection::evaluate(in) == 0);
+
+  labV_meas = 10.5f;  // VoltageDev after 105 ms, not before
+  for (uint8_t k = 1; k < DEBOUNCE; k++) CHECK(!(Protection::evaluate(in) & (1UL << ErrMgr::VoltageDev)));
+  CHECK(Protection::evaluate(in) & (1UL << ErrMgr::VoltageDev));
+  in.starting = true;  // Gated off during the startup delay
+  CHECK(!(Protection::evaluate(in) & (1UL << ErrMgr::VoltageDev)));
+  in.starting = false;
+  labV_meas = 12.0f;
+
+  in.fuseHeat = 1.0f;  // Fuse clears at RESET_HEAT, not just below 1
+  CHECK(Protection::evaluate(in) & (1UL << ErrMgr::FuseBlown));
+  in.fuseHeat = FuseModel::RESET_HEAT + 0.01f;
+  CHECK(Protection::evaluate(in) & (1UL << ErrMgr::FuseBlown));
+  in.fuseHeat = FuseModel::RESET_HEAT - 0.01f;
+  CHECK(!(Protection::evaluate(in) & (1UL << ErrMgr::FuseBlown)));
+
+  in.hwTrip = true;  // ALERT latches until the next manual enable
+  CHECK(Protection::evaluate(in) & (1UL << ErrMgr::HwOverCurrent));
+  in.hwTrip = false;
+  CHECK(Protection::evaluate(in) & (1UL << ErrMgr::HwOverCurrent));
+  in.enableEdge = true;
+  CHECK(!(Protection::evaluate(in) & (1UL << ErrMgr::HwOverCurrent)));
+  in.enableEdge = false;
+
+  labTemp_ntc = NAN;  // NaN never violates
+  CHECK(Protection::evaluate(in) == 0);
+
+  return checkResult("bench_protection");
+}
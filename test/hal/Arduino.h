@@ -0,0 +1,150 @@
+#pragma once
+
+// Host stand-in for the Arduino-ESP32 core: just enough API for the control modules.
+// Time comes from the simulated clock in HostHal, PWM writes are captured per pin, FreeRTOS
+// tasks are host threads handed the CPU one at a time by the simulated scheduler.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+using std::min;
+using std::max;
+
+#define IRAM_ATTR
+#define PROGMEM
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+template <class T, class L, class H>
+auto constrain(T amt, L low, H high) -> decltype(amt + low + high) {
+  return amt < low ? low : (amt > high ? high : amt);
+}
+
+// Time (simulated clock)
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// GPIO, interrupts and LEDC
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution);
+bool ledcWrite(uint8_t pin, uint32_t duty);
+bool ledcOutputInvert(uint8_t pin, bool invert);
+
+// ADC
+typedef struct {
+  uint8_t pin;
+  uint8_t channel;
+  int avg_read_raw;
+  int avg_read_mvolts;
+} adc_continuous_data_t;
+uint32_t analogReadMilliVolts(uint8_t pin);
+bool analogContinuous(const uint8_t pins[], size_t pinsCount, uint32_t conversionsPerPin, uint32_t samplingFreqHz,
+                      void (*userFunc)(void));
+bool analogContinuousStart();
+bool analogContinuousRead(adc_continuous_data_t** buffer, uint32_t timeoutMs);
+
+// Minimal Arduino String
+class String : public std::string {
+ public:
+  String() {}
+  String(const char* s) : std::string(s ? s : "") {}
+  String(const std::string& s) : std::string(s) {}
+  String(char c) : std::string(1, c) {}
+  String(int v) : std::string(std::to_string(v)) {}
+  String(unsigned v) : std::string(std::to_string(v)) {}
+  String(long v) : std::string(std::to_string(v)) {}
+  String(unsigned long v) : std::string(std::to_string(v)) {}
+  String(float v, unsigned decimals = 2) : String((double)v, decimals) {}
+  String(double v, unsigned decimals = 2) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    assign(buf);
+  }
+  long toInt() const { return atol(c_str()); }
+  float toFloat() const { return (float)atof(c_str()); }
+};
+inline String operator+(const String& a, const String& b) { return String(std::string(a).append(b)); }
+inline String operator+(const String& a, const char* b) { return String(std::string(a).append(b)); }
+inline String operator+(const char* a, const String& b) { return String(std::string(a).append(b)); }
+
+// Serial output goes to stdout only when HostHal::setVerbose(true)
+class HardwareSerial {
+ public:
+  void begin(unsigned long) {}
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  size_t print(const char* s);
+  size_t println(const char* s = "");
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t println(const String& s) { return println(s.c_str()); }
+};
+extern HardwareSerial Serial;
+
+// Chip services
+class EspClass {
+ public:
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getCycleCount();
+  uint32_t getFreeHeap() { return 200000; }
+  void restart() {}
+};
+extern EspClass ESP;
+
+bool psramFound();
+void* ps_malloc(size_t size);
+
+// FreeRTOS
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef struct HostTask* TaskHandle_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+BaseType_t xTaskCreate(void (*fn)(void*), const char* name, uint32_t stack, void* arg, UBaseType_t priority,
+                       TaskHandle_t* handle);
+void vTaskDelete(TaskHandle_t task);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+void vTaskDelay(TickType_t ticks);
+void taskYIELD();
+#define portYIELD_FROM_ISR(woken) ((void)(woken))
+
+// Spinlocks collapse to nothing: only one host thread runs at a time
+typedef struct { int owner; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
@@ -0,0 +1,288 @@
+// Peripheral stubs: INA226, I2C, GPIO registers, the LittleFS image, the SSD1306 and the rotary encoder
+
+#include "HostHal.h"
+#include "HostInternal.h"
+#include <Arduino.h>
+#include <INA226_WE.h>
+#include <LittleFS.h>
+#include <RotaryEncoder.h>
+#include <U8g2lib.h>
+#include <Wire.h>
+#include <soc/gpio_struct.h>
+#include <map>
+
+TwoWire Wire;
+gpio_dev_t GPIO;
+LittleFSFS LittleFS;
+
+namespace HostHal {
+
+typedef std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> FileMap;
+
+static Ina226 inaModel;                   // INA226 state behind the stub
+static FileMap files;                     // LittleFS contents
+static uint32_t fsCapacity = 1024 * 1024; // Partition size (bytes)
+static uint32_t fsBegins = 0;             // LittleFS.begin() calls
+static int encoderTurns = 0;              // Detents not yet taken by RotaryEncoder::tick()
+static uint64_t oledNs = 0;               // Display bus time not yet charged to the clock (ns)
+
+namespace internal {
+
+void resetDevices() {
+  inaModel = Ina226();
+  files.clear();
+  fsCapacity = 1024 * 1024;
+  fsBegins = 0;
+  encoderTurns = 0;
+  oledNs = 0;
+}
+
+} // namespace internal
+
+Ina226& ina226() { return inaModel; }
+void setFsCapacity(uint32_t bytes) { fsCapacity = bytes; }
+uint32_t fsBeginCount() { return fsBegins; }
+void turnEncoder(int steps) { encoderTurns += steps; }
+
+static void chargeI2c() {
+  if (costs().i2cUs) advanceUs(costs().i2cUs);
+}
+
+static void chargeOled(uint32_t bytes) {
+  oledNs += (uint64_t)bytes * costs().oledByteNs;
+  if (oledNs >= 1000) advanceUs(oledNs / 1000);
+  oledNs %= 1000;
+}
+
+} // namespace HostHal
+
+using namespace HostHal;
+
+HostGpioSetReg& HostGpioSetReg::operator=(uint32_t mask) {
+  for (uint8_t p = 0; p < 32; p++)
+    if (mask & (1UL << p)) digitalWrite(p, HIGH);
+  return *this;
+}
+
+HostGpioClearReg& HostGpioClearReg::operator=(uint32_t mask) {
+  for (uint8_t p = 0; p < 32; p++)
+    if (mask & (1UL << p)) digitalWrite(p, LOW);
+  return *this;
+}
+
+// INA226
+
+static const uint16_t AVERAGES[] = {1, 4, 16, 64, 128, 256, 512, 1024};
+static const uint16_t CONV_US[] = {140, 204, 332, 588, 1100, 2116, 4156, 8244};
+
+void INA226_WE::updatePeriod() {
+  inaModel.convPeriodUs = (uint32_t)averages * (shuntUs + busUs);
+  inaModel.convOriginUs = nowUs();  // Changing settings restarts the running conversion
+  inaModel.lastFlagConv = 0;
+}
+
+bool INA226_WE::init() {
+  chargeI2c();
+  return inaModel.present;
+}
+
+void INA226_WE::setAverage(INA226_AVERAGES a) {
+  chargeI2c();
+  averages = AVERAGES[a];
+  updatePeriod();
+}
+
+void INA226_WE::setConversionTime(INA226_CONV_TIME shunt, INA226_CONV_TIME bus) {
+  chargeI2c();
+  shuntUs = CONV_US[shunt];
+  busUs = CONV_US[bus];
+  updatePeriod();
+}
+
+void INA226_WE::readAndClearFlags() {
+  chargeI2c();
+  uint64_t done = (nowUs() - inaModel.convOriginUs) / inaModel.convPeriodUs;
+  convAlert = done > inaModel.lastFlagConv;
+  inaModel.lastFlagConv = done;
+  limitAlert = inaModel.alertLimitA > 0.0f && inaModel.currentA > inaModel.alertLimitA;
+  inaModel.flagReads++;
+}
+
+void INA226_WE::setAlertType(INA226_ALERT_TYPE type, float limit) {
+  chargeI2c();
+  inaModel.alertLimitA = type == CURRENT_OVER ? limit / 1000.0f : 0.0f;
+}
+
+float INA226_WE::getBusVoltage_V() {
+  chargeI2c();
+  return inaModel.busV;
+}
+
+float INA226_WE::getCurrent_mA() {
+  chargeI2c();
+  return inaModel.currentA * 1000.0f;
+}
+
+float INA226_WE::getBusPower() { return getBusVoltage_V() * getCurrent_mA(); }
+float INA226_WE::getShuntVoltage_mV() { return getCurrent_mA() * 0.0053f; }
+
+// LittleFS
+
+bool File::seek(uint32_t p) {
+  if (!data || p > data->size()) return false;
+  pos = p;
+  return true;
+}
+
+size_t File::read(uint8_t* buf, size_t len) {
+  if (!data || writable) return 0;
+  size_t n = min(len, data->size() - pos);
+  memcpy(buf, data->data() + pos, n);
+  pos += n;
+  return n;
+}
+
+int File::read() {
+  uint8_t b;
+  return read(&b, 1) == 1 ? b : -1;
+}
+
+size_t File::write(const uint8_t* buf, size_t len) {
+  if (!data || !writable) return 0;
+  size_t room = LittleFS.totalBytes() - LittleFS.usedBytes();
+  size_t grow = pos + len > data->size() ? pos + len - data->size() : 0;
+  if (grow > room) len -= grow - room;  // Partition full: short write
+  if (pos + len > data->size()) data->resize(pos + len);
+  memcpy(data->data() + pos, buf, len);
+  pos += len;
+  return len;
+}
+
+void File::close() {
+  data.reset();
+  pos = 0;
+}
+
+bool LittleFSFS::begin(bool, const char*, uint8_t, const char*) {
+  fsBegins++;
+  return true;
+}
+
+bool LittleFSFS::format() {
+  files.clear();
+  return true;
+}
+
+File LittleFSFS::open(const char* path, const char* mode) {
+  File f;
+  auto it = files.find(path);
+  if (mode[0] == 'r') {
+    if (it == files.end()) return f;
+    f.data = it->second;
+  } else {
+    if (it == files.end() || mode[0] == 'w') {
+      files[path] = std::make_shared<std::vector<uint8_t>>();
+      it = files.find(path);
+    }
+    f.data = it->second;
+    f.writable = true;
+    if (mode[0] == 'a') f.pos = f.data->size();
+  }
+  f.path = path;
+  return f;
+}
+
+bool LittleFSFS::exists(const char* path) { return files.count(path) != 0; }
+bool LittleFSFS::remove(const char* path) { return files.erase(path) != 0; }
+
+bool LittleFSFS::rename(const char* from, const char* to) {
+  auto it = files.find(from);
+  if (it == files.end()) return false;
+  auto data = it->second;
+  files.erase(it);
+  files[to] = data;
+  return true;
+}
+
+size_t LittleFSFS::totalBytes() { return fsCapacity; }
+
+size_t LittleFSFS::usedBytes() {
+  size_t used = 0;
+  for (auto& f : files) used += f.second->size();
+  return used;
+}
+
+// Rotary encoder
+
+void RotaryEncoder::tick() {
+  position += encoderTurns;
+  encoderTurns = 0;
+}
+
+// SSD1306 through U8g2: page layout, one byte per 8 vertical pixels, 128 bytes per page
+
+constexpr uint32_t OLED_ROW_OVERHEAD = 5;  // Address, control byte and column/page commands per row
+constexpr uint32_t OLED_CHUNK = 32;        // Data bytes per I2C write (Wire buffer)
+constexpr uint32_t OLED_CHUNK_OVERHEAD = 2; // Address and data control byte per write
+
+void U8G2::clearBuffer() { memset(buffer, 0, sizeof(buffer)); }
+
+void U8G2::drawPixel(int x, int y) {
+  if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+  uint8_t& b = buffer[(y / 8) * WIDTH + x];
+  uint8_t bit = 1 << (y % 8);
+  if (color == 0) b &= ~bit;
+  else if (color == 1) b |= bit;
+  else b ^= bit;
+}
+
+void U8G2::drawBox(int x, int y, int w, int h) {
+  for (int j = y; j < y + h; j++)
+    for (int i = x; i < x + w; i++) drawPixel(i, j);
+}
+
+void U8G2::drawFrame(int x, int y, int w, int h) {
+  if (w <= 0 || h <= 0) return;
+  for (int i = x; i < x + w; i++) drawPixel(i, y), drawPixel(i, y + h - 1);
+  for (int j = y + 1; j < y + h - 1; j++) drawPixel(x, j), drawPixel(x + w - 1, j);
+}
+
+// Each character gets its own pixel pattern in a w x h cell ending on the baseline; a space is blank
+int U8G2::drawStr(int x, int y, const char* s) {
+  int x0 = x;
+  for (; *s; s++, x += font->w) {
+    if (*s == ' ') continue;
+    for (int row = 0; row < font->h; row++) {
+      for (int col = 0; col < font->w - 1; col++) {
+        uint32_t hsh = ((uint8_t)*s * 2654435761u) ^ (row * 40503u + col * 9973u);
+        if ((hsh >> 7) & 1) drawPixel(x + col, y - font->h + 1 + row);
+      }
+    }
+  }
+  return x - x0;
+}
+
+int U8G2::getStrWidth(const char* s) const { return font->w * (int)strlen(s); }
+
+void U8G2::sendRow(uint8_t tx, uint8_t ty, uint8_t tw) {
+  uint32_t offset = ty * WIDTH + tx * 8, bytes = tw * 8;
+  memcpy(panel + offset, buffer + offset, bytes);
+  uint32_t wire = OLED_ROW_OVERHEAD + bytes + (bytes + OLED_CHUNK - 1) / OLED_CHUNK * OLED_CHUNK_OVERHEAD;
+  transfers.rows++;
+  transfers.dataBytes += bytes;
+  transfers.i2cBytes += wire;
+  HostHal::chargeOled(wire);
+}
+
+void U8G2::sendBuffer() {
+  transfers.sendBuffers++;
+  for (uint8_t ty = 0; ty < TILE_H; ty++) sendRow(0, ty, TILE_W);
+}
+
+void U8G2::updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th) {
+  if (tx >= TILE_W || ty >= TILE_H) return;
+  tw = std::min<int>(tw, TILE_W - tx);
+  th = std::min<int>(th, TILE_H - ty);
+  transfers.areas++;
+  for (uint8_t r = 0; r < th; r++) sendRow(tx, ty + r, tw);
+}
@@ -0,0 +1,130 @@
+#include "HostHal.h"
+#include "HostInternal.h"
+#include <Arduino.h>
+#include <stdarg.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace HostHal {
+
+constexpr int PIN_COUNT = 64;
+
+static bool verbose = false;             // Echo Serial output
+static Costs callCosts;                  // Simulated time of blocking calls
+static uint32_t pwmValue[PIN_COUNT];     // Last LEDC value per pin
+static uint8_t pwmBits[PIN_COUNT];       // LEDC resolution per pin
+static bool pwmInvert[PIN_COUNT];        // LEDC output inversion per pin
+static int level[PIN_COUNT];             // GPIO levels
+static uint32_t analogMv[PIN_COUNT];     // ADC inputs (mV)
+static void (*isr[PIN_COUNT])();         // Attached interrupt handlers
+static int isrMode[PIN_COUNT];           // RISING / FALLING / CHANGE
+
+void reset() {
+  internal::simUs = 0;
+  internal::resetTimers();
+  internal::resetDevices();
+  callCosts = Costs();
+  for (int p = 0; p < PIN_COUNT; p++) {
+    pwmValue[p] = 0;
+    pwmBits[p] = 0;
+    pwmInvert[p] = false;
+    level[p] = HIGH;
+    analogMv[p] = 1650;
+    isr[p] = nullptr;
+  }
+}
+
+uint64_t nowUs() { return internal::simUs; }
+void setVerbose(bool on) { verbose = on; }
+Costs& costs() { return callCosts; }
+
+uint32_t ledcValue(uint8_t pin) { return pin < PIN_COUNT ? pwmValue[pin] : 0; }
+
+float ledcDuty(uint8_t pin) {
+  if (pin >= PIN_COUNT || pwmBits[pin] == 0) return 0.0f;
+  float d = pwmValue[pin] / (float)((1UL << pwmBits[pin]) - 1);
+  return pwmInvert[pin] ? 1.0f - d : d;
+}
+
+int pinLevel(uint8_t pin) { return pin < PIN_COUNT ? level[pin] : LOW; }
+
+void setPinLevel(uint8_t pin, int lvl) {
+  if (pin >= PIN_COUNT) return;
+  int old = level[pin];
+  level[pin] = lvl;
+  if (!isr[pin] || old == lvl) return;
+  if (isrMode[pin] == CHANGE || (isrMode[pin] == FALLING && lvl == LOW) || (isrMode[pin] == RISING && lvl == HIGH)) isr[pin]();
+}
+
+void setAnalogMilliVolts(uint8_t pin, uint32_t mv) { if (pin < PIN_COUNT) analogMv[pin] = mv; }
+
+} // namespace HostHal
+
+using namespace HostHal;
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t val) { if (pin < PIN_COUNT) level[pin] = val; }
+int digitalRead(uint8_t pin) { return pinLevel(pin); }
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+  if (pin >= PIN_COUNT) return;
+  isr[pin] = handler;
+  isrMode[pin] = mode;
+}
+
+void detachInterrupt(uint8_t pin) { if (pin < PIN_COUNT) isr[pin] = nullptr; }
+
+bool ledcAttach(uint8_t pin, uint32_t, uint8_t resolution) {
+  if (pin >= PIN_COUNT) return false;
+  pwmBits[pin] = resolution;
+  return true;
+}
+
+bool ledcWrite(uint8_t pin, uint32_t duty) {
+  if (pin >= PIN_COUNT) return false;
+  pwmValue[pin] = duty;
+  return true;
+}
+
+bool ledcOutputInvert(uint8_t pin, bool invert) {
+  if (pin >= PIN_COUNT) return false;
+  pwmInvert[pin] = invert;
+  return true;
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+  if (callCosts.adcUs) advanceUs(callCosts.adcUs);
+  return pin < PIN_COUNT ? analogMv[pin] : 0;
+}
+
+// No DMA ADC on the host: callers fall back to one-shot reads
+bool analogContinuous(const uint8_t[], size_t, uint32_t, uint32_t, void (*)(void)) { return false; }
+bool analogContinuousStart() { return false; }
+bool analogContinuousRead(adc_continuous_data_t**, uint32_t) { return false; }
+
+uint32_t EspClass::getCycleCount() { return (uint32_t)(internal::simUs * 240); }
+
+bool psramFound() { return false; }
+void* ps_malloc(size_t size) { return malloc(size); }
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+  if (!verbose) return 0;
+  va_list args;
+  va_start(args, fmt);
+  int n = vprintf(fmt, args);
+  va_end(args);
+  return n > 0 ? n : 0;
+}
+
+size_t HardwareSerial::print(const char* s) {
+  if (!verbose) return 0;
+  fputs(s, stdout);
+  return strlen(s);
+}
+
+size_t HardwareSerial::println(const char* s) {
+  if (!verbose) return 0;
+  puts(s);
+  return strlen(s) + 1;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+
+// Host-side control of the stub HAL: simulated clock, scheduler, captured outputs and sensor inputs
+namespace HostHal {
+
+  void reset();                           // Clock to zero, pins, PWM, costs and devices to defaults
+  uint64_t nowUs();                       // Simulated time (us)
+  void advanceUs(uint64_t us);            // Move the clock forward, firing due timers and the tasks they wake
+  void setVerbose(bool on);               // Echo Serial output to stdout
+
+  // Scheduler
+  void setDispatchLatency(uint32_t (*latencyUs)()); // Delay from a timer expiry to its callback (nullptr = none)
+  void setTaskCreateFails(bool fail);     // xTaskCreate() returns pdFAIL
+  int taskCount();                        // Live tasks
+
+  // Simulated time taken by blocking HAL calls
+  struct Costs {
+    uint32_t i2cUs = 0;                   // One INA226 register transfer
+    uint32_t adcUs = 0;                   // One analogReadMilliVolts()
+    uint32_t oledByteNs = 0;              // One byte to the SSD1306 (9 bit times at the bus clock)
+  };
+  Costs& costs();
+
+  // GPIO and LEDC
+  uint32_t ledcValue(uint8_t pin);        // Last ledcWrite() value (raw counts)
+  float ledcDuty(uint8_t pin);            // Last ledcWrite() as a fraction of full scale, inversion applied
+  int pinLevel(uint8_t pin);              // Last level written (digitalWrite or GPIO registers)
+  void setPinLevel(uint8_t pin, int lvl); // Drive an input; runs an attached ISR on a matching edge
+  void setAnalogMilliVolts(uint8_t pin, uint32_t mv); // analogReadMilliVolts() result
+
+  // Rotary encoder behind the RotaryEncoder stub
+  void turnEncoder(int steps);            // Detents for the next tick(), positive clockwise
+
+  // INA226 model behind the INA226_WE stub
+  struct Ina226 {
+    bool present = true;                  // init() succeeds
+    float busV = 0.0f;                    // Bus voltage returned by the next read (V)
+    float currentA = 0.0f;                // Current returned by the next read (A)
+    uint32_t convPeriodUs = 35200;        // Time per result, from the averaging/conversion settings
+    uint64_t convOriginUs = 0;            // Start of the first conversion
+    uint64_t lastFlagConv = 0;            // Conversions completed at the last flag read
+    float alertLimitA = 0.0f;             // CURRENT_OVER limit (A), 0 = none
+    uint32_t flagReads = 0;               // readAndClearFlags() calls
+  };
+  Ina226& ina226();
+
+  // LittleFS image
+  void setFsCapacity(uint32_t bytes);     // totalBytes() of the simulated partition
+  uint32_t fsBeginCount();                // LittleFS.begin() calls since reset()
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+
+// State shared between the stub HAL translation units
+namespace HostHal {
+namespace internal {
+
+  extern uint64_t simUs;       // Simulated clock (us)
+  void resetTimers();          // Drop all esp_timers
+  void resetDevices();         // INA226 model, encoder and file system to defaults
+
+}
+}
@@ -0,0 +1,234 @@
+// Simulated clock, esp_timer and FreeRTOS tasks.
+//
+// Each task is a host thread, but only one thread runs at a time: the harness (main) thread hands
+// the CPU to a notified task and waits until it blocks again in ulTaskNotifyTake(). A notify from
+// the harness thread or a timer callback preempts at once, like a higher-priority task on the
+// single-core ESP32-S2. Time only moves through advanceUs(), so runs are deterministic.
+
+#include "HostHal.h"
+#include "HostInternal.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_cpu.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct HostTimer {
+  esp_timer_cb_t callback;
+  void* arg;
+  bool skipUnhandled;
+  bool armed = false;
+  bool deleted = false;
+  uint64_t dueUs = 0;
+  uint64_t periodUs = 0;       // 0 = one-shot
+};
+
+struct HostTask {
+  void (*fn)(void*);
+  void* arg;
+  const char* name;
+  uint32_t notify = 0;         // Pending notifications
+  bool blocked = false;        // Waiting in ulTaskNotifyTake()
+  bool started = false;
+  bool deleted = false;
+};
+
+namespace HostHal {
+namespace internal {
+
+uint64_t simUs = 0;
+
+static std::vector<HostTimer*> timers;
+
+void resetTimers() {
+  for (HostTimer* t : timers) t->armed = false;
+}
+
+} // namespace internal
+
+using internal::simUs;
+using internal::timers;
+
+// Never destroyed: parked task threads still reference them at process exit
+static std::mutex& mtx = *new std::mutex;
+static std::condition_variable& cv = *new std::condition_variable;
+static std::vector<HostTask*> tasks;
+static HostTask* running = nullptr;            // Task holding the CPU (nullptr = harness)
+static thread_local HostTask* self = nullptr;  // Task of the calling thread
+static uint32_t (*dispatchLatency)() = nullptr;
+static bool createFails = false;
+
+// Give the CPU to a task until it blocks (harness thread only)
+static void switchTo(HostTask* t) {
+  std::unique_lock<std::mutex> lock(mtx);
+  running = t;
+  cv.notify_all();
+  cv.wait(lock, [] { return running == nullptr; });
+}
+
+// Run every notified task until all are blocked again
+static void runReady() {
+  if (self) return;  // Tasks are picked up when the running one blocks
+  for (bool again = true; again;) {
+    again = false;
+    for (HostTask* t : tasks) {
+      bool ready = !t->started || (t->blocked && t->notify);
+      if (t->deleted || !ready) continue;
+      t->started = true;
+      switchTo(t);
+      again = true;
+    }
+  }
+}
+
+void setDispatchLatency(uint32_t (*latencyUs)()) { dispatchLatency = latencyUs; }
+void setTaskCreateFails(bool fail) { createFails = fail; }
+
+int taskCount() {
+  int n = 0;
+  for (HostTask* t : tasks) n += !t->deleted;
+  return n;
+}
+
+void advanceUs(uint64_t us) {
+  uint64_t target = simUs + us;
+  for (;;) {
+    HostTimer* next = nullptr;
+    for (HostTimer* t : timers)
+      if (t->armed && t->dueUs <= target && (!next || t->dueUs < next->dueUs)) next = t;
+    if (!next) break;
+
+    if (next->dueUs > simUs) simUs = next->dueUs;
+    if (next->periodUs) {
+      next->dueUs += next->periodUs;
+    } else {
+      next->armed = false;
+    }
+    if (dispatchLatency) simUs += dispatchLatency();
+    if (next->periodUs && next->skipUnhandled)
+      while (next->dueUs <= simUs) next->dueUs += next->periodUs;
+
+    next->callback(next->arg);
+    runReady();
+    if (simUs > target) target = simUs;
+  }
+  simUs = target;
+}
+
+} // namespace HostHal
+
+using namespace HostHal;
+
+unsigned long millis() { return (unsigned long)(simUs / 1000); }
+unsigned long micros() { return (unsigned long)(uint32_t)simUs; }
+void delay(uint32_t ms) { advanceUs(ms * 1000ULL); }
+void delayMicroseconds(uint32_t us) { advanceUs(us); }
+void yield() {}
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count() { return (esp_cpu_cycle_count_t)(simUs * 240); }
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+  HostTimer* t = new HostTimer{args->callback, args->arg, args->skip_unhandled_events};
+  timers.push_back(t);
+  *out = t;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t periodUs) {
+  if (!t || t->armed) return ESP_ERR_INVALID_STATE;
+  t->armed = true;
+  t->periodUs = periodUs;
+  t->dueUs = simUs + periodUs;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeoutUs) {
+  if (!t || t->armed) return ESP_ERR_INVALID_STATE;
+  t->armed = true;
+  t->periodUs = 0;
+  t->dueUs = simUs + timeoutUs;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+  if (!t || !t->armed) return ESP_ERR_INVALID_STATE;
+  t->armed = false;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t t) {
+  if (!t) return ESP_FAIL;
+  t->armed = false;
+  t->deleted = true;
+  return ESP_OK;
+}
+
+int64_t esp_timer_get_time() { return (int64_t)simUs; }
+
+BaseType_t xTaskCreate(void (*fn)(void*), const char* name, uint32_t, void* arg, UBaseType_t, TaskHandle_t* handle) {
+  if (createFails) return pdFAIL;
+  HostTask* t = new HostTask{fn, arg, name};
+  tasks.push_back(t);
+  if (handle) *handle = t;
+
+  std::thread([t] {
+    self = t;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv.wait(lock, [t] { return running == t; });
+    }
+    t->fn(t->arg);
+    vTaskDelete(nullptr);  // Returning from a task body is not allowed on target either
+  }).detach();
+
+  runReady();  // Higher priority than the creator: runs until it first blocks
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  HostTask* t = task ? task : self;
+  if (!t) return;
+  std::unique_lock<std::mutex> lock(mtx);
+  t->deleted = true;
+  if (t != self) return;
+  running = nullptr;
+  cv.notify_all();
+  cv.wait(lock, [] { return false; });  // Parked for good
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    task->notify++;
+  }
+  runReady();
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken) {
+  if (woken) *woken = pdTRUE;
+  xTaskNotifyGive(task);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+  HostTask* t = self;
+  if (!t) return 0;
+  std::unique_lock<std::mutex> lock(mtx);
+  if (t->notify == 0) {
+    if (ticksToWait == 0) return 0;
+    // Timeouts are not modelled: the task waits for the next notification
+    t->blocked = true;
+    running = nullptr;
+    cv.notify_all();
+    cv.wait(lock, [t] { return running == t; });
+    t->blocked = false;
+  }
+  uint32_t n = t->notify;
+  t->notify = clearOnExit ? 0 : n - 1;
+  return n;
+}
+
+void vTaskDelay(TickType_t ticks) { advanceUs(ticks * 1000ULL); }
+void taskYIELD() {}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Host stand-in for the INA226_WE library, backed by HostHal::ina226(). Conversions complete on
+// the simulated clock at the rate the averaging and conversion-time settings give.
+
+#include <stdint.h>
+
+typedef enum {
+  INA226_AVERAGE_1, INA226_AVERAGE_4, INA226_AVERAGE_16, INA226_AVERAGE_64,
+  INA226_AVERAGE_128, INA226_AVERAGE_256, INA226_AVERAGE_512, INA226_AVERAGE_1024
+} INA226_AVERAGES;
+
+typedef enum {
+  INA226_CONV_TIME_140, INA226_CONV_TIME_204, INA226_CONV_TIME_332, INA226_CONV_TIME_588,
+  INA226_CONV_TIME_1100, INA226_CONV_TIME_2116, INA226_CONV_TIME_4156, INA226_CONV_TIME_8244
+} INA226_CONV_TIME;
+
+typedef enum { INA226_POWER_DOWN, INA226_TRIGGERED, INA226_CONTINUOUS } INA226_MEASURE_MODE;
+
+typedef enum { SHUNT_OVER, SHUNT_UNDER, CURRENT_OVER, CURRENT_UNDER, BUS_OVER, BUS_UNDER, POWER_OVER } INA226_ALERT_TYPE;
+
+class INA226_WE {
+ public:
+  explicit INA226_WE(int addr = 0x40) { (void)addr; }
+  bool init();
+  void setAverage(INA226_AVERAGES averages);
+  void setConversionTime(INA226_CONV_TIME shuntConvTime, INA226_CONV_TIME busConvTime);
+  void setConversionTime(INA226_CONV_TIME convTime) { setConversionTime(convTime, convTime); }
+  void setMeasureMode(INA226_MEASURE_MODE mode) { (void)mode; }
+  void setResistorRange(float resistor, float range) { (void)resistor; (void)range; }
+  void readAndClearFlags();
+  void enableConvReadyAlert() {}
+  void disableConvReadyAlert() {}
+  void enableAlertLatch() {}
+  void disableAlertLatch() {}
+  void setAlertPinActiveHigh() {}
+  void setAlertType(INA226_ALERT_TYPE type, float limit);
+  float getBusVoltage_V();
+  float getCurrent_mA();
+  float getBusPower();
+  float getShuntVoltage_mV();
+
+  bool overflow = false;
+  bool convAlert = false;
+  bool limitAlert = false;
+
+ private:
+  void updatePeriod();
+  uint16_t averages = 1;
+  uint16_t shuntUs = 1100;
+  uint16_t busUs = 1100;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+// Host stand-in for LittleFS: an in-memory file system with a fixed capacity
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+class File {
+ public:
+  File() {}
+  explicit operator bool() const { return data != nullptr; }
+  size_t size() const { return data ? data->size() : 0; }
+  size_t position() const { return pos; }
+  int available() const { return data ? (int)(data->size() - pos) : 0; }
+  bool seek(uint32_t p);
+  size_t read(uint8_t* buf, size_t len);
+  int read();
+  size_t write(const uint8_t* buf, size_t len);
+  size_t write(uint8_t b) { return write(&b, 1); }
+  void flush() {}
+  void close();
+  const char* name() const { return path.c_str(); }
+
+ private:
+  friend class LittleFSFS;
+  std::shared_ptr<std::vector<uint8_t>> data;
+  std::string path;
+  size_t pos = 0;
+  bool writable = false;
+};
+
+class LittleFSFS {
+ public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+             const char* partitionLabel = "spiffs");
+  void end() {}
+  bool format();
+  File open(const char* path, const char* mode = "r");
+  File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to);
+  size_t totalBytes();
+  size_t usedBytes();
+};
+
+extern LittleFSFS LittleFS;
@@ -0,0 +1,16 @@
+#pragma once
+
+// Host stand-in for the RotaryEncoder library; turns come from HostHal::turnEncoder()
+
+class RotaryEncoder {
+ public:
+  enum class LatchMode { FOUR3 = 1, FOUR0 = 2, TWO03 = 3 };
+
+  RotaryEncoder(int pin1, int pin2, LatchMode mode = LatchMode::FOUR0) {}
+  void tick();                                 // Take the detents turned since the last tick
+  long getPosition() const { return position; }
+  void setPosition(long p) { position = p; }
+
+ private:
+  long position = 0;
+};
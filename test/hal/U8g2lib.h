@@ -0,0 +1,72 @@
+#pragma once
+
+// Host stand-in for U8g2 with the SSD1306 128x64 full-buffer driver: the frame buffer in the
+// controller's page layout, the drawing calls the firmware makes, and a copy of the panel RAM that
+// only sendBuffer() and updateDisplayArea() write. Every transfer is counted in I2C bytes.
+
+#include <stdint.h>
+
+// Fonts only need their cell size here; glyphs are drawn as a pattern unique to each character
+struct HostFont {
+  uint8_t w;   // Advance (px)
+  uint8_t h;   // Height above and including the baseline (px)
+};
+inline const HostFont u8g2_font_6x12_tf[1] = {{6, 12}};
+inline const HostFont u8g2_font_5x8_tf[1] = {{5, 8}};
+
+struct u8g2_cb_t {};
+inline const u8g2_cb_t u8g2_cb_r0 = {};
+#define U8G2_R0 (&u8g2_cb_r0)
+#define U8X8_PIN_NONE 255
+
+// Bus traffic since construction or resetTransfers()
+struct U8g2Transfers {
+  uint32_t sendBuffers;  // Full frames
+  uint32_t areas;        // updateDisplayArea() calls
+  uint32_t rows;         // Page rows addressed, one command write each
+  uint32_t dataBytes;    // Tile bytes
+  uint32_t i2cBytes;     // Everything on the bus: addresses, control bytes, commands and data
+};
+
+class U8G2 {
+ public:
+  static constexpr int WIDTH = 128;
+  static constexpr int HEIGHT = 64;
+  static constexpr int TILE_W = WIDTH / 8;
+  static constexpr int TILE_H = HEIGHT / 8;
+  static constexpr int BUFFER_BYTES = WIDTH * HEIGHT / 8;
+
+  bool begin() { return true; }
+  void clearBuffer();
+  void setFont(const HostFont* f) { font = f; }
+  void setDrawColor(uint8_t c) { color = c; }
+  void drawPixel(int x, int y);
+  void drawBox(int x, int y, int w, int h);
+  void drawFrame(int x, int y, int w, int h);
+  int drawStr(int x, int y, const char* s);
+  int getStrWidth(const char* s) const;
+
+  uint8_t* getBufferPtr() { return buffer; }
+  uint8_t getBufferTileWidth() const { return TILE_W; }
+  uint8_t getBufferTileHeight() const { return TILE_H; }
+  void sendBuffer();
+  void updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th);
+
+  const uint8_t* getPanel() const { return panel; }           // Panel RAM as last sent
+  const U8g2Transfers& getTransfers() const { return transfers; }
+  void resetTransfers() { transfers = {}; }
+
+ private:
+  void sendRow(uint8_t tx, uint8_t ty, uint8_t tw);
+
+  uint8_t buffer[BUFFER_BYTES] = {};
+  uint8_t panel[BUFFER_BYTES] = {};
+  const HostFont* font = u8g2_font_6x12_tf;
+  uint8_t color = 1;
+  U8g2Transfers transfers = {};
+};
+
+class U8G2_SSD1306_128X64_NONAME_F_HW_I2C : public U8G2 {
+ public:
+  U8G2_SSD1306_128X64_NONAME_F_HW_I2C(const u8g2_cb_t*, uint8_t clock, uint8_t data, uint8_t reset) {}
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stand-in for the I2C driver; devices are modelled behind their own stubs
+
+#include <stdint.h>
+
+class TwoWire {
+ public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+  bool setClock(uint32_t) { return true; }
+};
+
+extern TwoWire Wire;
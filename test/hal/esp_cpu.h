@@ -0,0 +1,8 @@
+#pragma once
+
+// Host stand-in for esp_cpu: the cycle counter follows the simulated clock at 240 MHz
+
+#include <stdint.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count();
@@ -0,0 +1,20 @@
+#pragma once
+
+// Host stand-in for the GPIO register block: set/clear writes land in HostHal pin levels
+
+#include <stdint.h>
+
+struct HostGpioSetReg {
+  HostGpioSetReg& operator=(uint32_t mask);
+};
+
+struct HostGpioClearReg {
+  HostGpioClearReg& operator=(uint32_t mask);
+};
+
+typedef struct {
+  HostGpioSetReg out_w1ts;    // GPIO 0-31 set
+  HostGpioClearReg out_w1tc;  // GPIO 0-31 clear
+} gpio_dev_t;
+
+extern gpio_dev_t GPIO;
@@ -0,0 +1,84 @@
+#include "Plant.h"
+#include <math.h>
+
+namespace Plant {
+
+static Config cfg;           // Model parameters
+static float load = 100.0f;  // Load resistance (ohms)
+static float vFb = 0.0f;     // Filtered feedback duty (0..1)
+static float vInt = 0.0f;    // Converter internal voltage (V)
+static float vC = 0.0f;      // Output capacitor voltage (V)
+static double sumV = 0.0;    // Conversion window sums
+static double sumI = 0.0;
+static uint32_t sumN = 0;
+static float peakI = 0.0f;   // Window peak load current (A)
+
+Config buck() { return Config(); }
+
+Config linear() {
+  Config c;
+  c.vPot = 30.0f;
+  c.tauConvUs = 50.0f;
+  c.rOut = 0.01f;
+  c.iLimit = 2.2f;
+  c.cOut = 100e-6f;
+  return c;
+}
+
+void reset(const Config& c, float loadOhms) {
+  cfg = c;
+  load = loadOhms;
+  vFb = 0.0f;
+  vInt = vC = cfg.vRef;
+  sumV = sumI = 0.0;
+  sumN = 0;
+  peakI = 0.0f;
+}
+
+void setLoad(float ohms) { load = ohms; }
+float getLoad() { return load; }
+float vOut() { return vC; }
+float iLoad() { return isinf(load) ? 0.0f : vC / load; }
+float iPeak() { return peakI; }
+
+void run(float duty, uint32_t us) {
+  const float h = cfg.stepUs * 1e-6f;
+  const float aFb = 1.0f - expf(-(float)cfg.stepUs / cfg.tauFbUs);
+  const float aConv = 1.0f - expf(-(float)cfg.stepUs / cfg.tauConvUs);
+  const float g = isinf(load) ? 0.0f : 1.0f / load;  // Load conductance
+
+  for (uint32_t t = 0; t < us; t += cfg.stepUs) {
+    vFb += (duty - vFb) * aFb;
+    vInt += (cfg.vRef + (cfg.vPot - cfg.vRef) * vFb - vInt) * aConv;
+
+    // Backward Euler on C dv/dt = (vInt - v)/rOut - v/R, then clamp the converter current
+    float k = h / cfg.cOut;
+    float v = (vC + k * vInt / cfg.rOut) / (1.0f + k * (1.0f / cfg.rOut + g));
+    float iConv = (vInt - v) / cfg.rOut;
+    if (iConv < 0.0f) v = vC / (1.0f + k * g);
+    else if (iConv > cfg.iLimit) v = (vC + k * cfg.iLimit) / (1.0f + k * g);
+    vC = v;
+
+    float i = vC * g;
+    sumV += vC;
+    sumI += i;
+    sumN++;
+    if (i > peakI) peakI = i;
+  }
+}
+
+Sample sample() {
+  Sample s = {vC, vC * (isinf(load) ? 0.0f : 1.0f / load)};
+  if (sumN) {
+    s.v = (float)(sumV / sumN);
+    s.i = (float)(sumI / sumN);
+  }
+  s.v = roundf(s.v / cfg.vLsb) * cfg.vLsb;
+  s.i = roundf(s.i / cfg.iLsb) * cfg.iLsb;
+  sumV = sumI = 0.0;
+  sumN = 0;
+  peakI = 0.0f;
+  return s;
+}
+
+} // namespace Plant
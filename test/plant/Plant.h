@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+// Discrete-time model of a feedback-PWM buck converter with its output capacitor and load.
+// The feedback MOSFET off gives Vref, fully on gives the potentiometer voltage; in between the
+// RC-filtered duty moves the converter's reference linearly. The converter sources current up
+// to its switch limit and cannot sink, so unloading the output only lets the capacitor drift.
+namespace Plant {
+
+  struct Config {
+    float vRef = 1.25f;        // Output with the feedback MOSFET off (V)
+    float vPot = 36.0f;        // Output with the MOSFET fully on (V)
+    float tauFbUs = 4700.0f;   // PWM RC filter time constant (us)
+    float tauConvUs = 800.0f;  // Converter regulation loop time constant (us)
+    float rOut = 0.08f;        // Converter output resistance (ohms), load regulation droop
+    float iLimit = 5.0f;       // Converter switch current limit (A)
+    float cOut = 470e-6f;      // Output capacitance (F)
+    float vLsb = 0.00125f;     // INA226 bus voltage LSB (V)
+    float iLsb = 0.00047f;     // INA226 current LSB (A), 2.5 uV over the 5.3 mOhm shunt
+    uint32_t stepUs = 10;      // Integration step (us)
+  };
+
+  // Averaged reading over one INA226 conversion window
+  struct Sample {
+    float v;  // Bus voltage (V)
+    float i;  // Load current (A)
+  };
+
+  Config buck();    // XL6019-class switcher (the defaults)
+  Config linear();  // LM317-class linear stage: fast stiff loop, lower current limit
+
+  void reset(const Config& cfg = Config(), float loadOhms = 100.0f); // Discharged output
+  void setLoad(float ohms);             // Load resistance (ohms), INFINITY = open
+  float getLoad();
+  void run(float duty, uint32_t us);    // Advance the model with the feedback duty (0..1)
+  Sample sample();                      // Quantized average since the last sample
+  float vOut();                         // Instantaneous output voltage (V)
+  float iLoad();                        // Instantaneous load current (A)
+  float iPeak();                        // Largest load current since the last sample (A)
+
+}
@@ -0,0 +1,57 @@
+#include "Rig.h"
+#include "HostHal.h"
+#include "Globals.h"
+#include "Config.h"
+#include "DcControl.h"
+#include <chrono>
+
+namespace Rig {
+
+static uint32_t ticks = 0;     // Ticks since begin()
+static double tickNs = 0.0;    // Summed DcControl::tick time (ns)
+static double tickMaxNs = 0.0; // Worst DcControl::tick time (ns)
+
+void begin(const Plant::Config& cfg, float loadOhms, float vset, float iset) {
+  HostHal::reset();
+  Plant::reset(cfg, loadOhms);
+  controlPeriodUs = DC_CONTROL_UPDATE_INTERVAL * 1000UL;
+  labV_set = rampedVset = vset;
+  labI_set = rampedIset = iset;
+  labV_meas = labI_meas = 0.0f;
+  rampRateV = rampRateI = 0.0f;
+  modeAuto = true;
+  outputActive = true;
+  isCC = false;
+  DcControl::begin();
+  ticks = 0;
+  tickNs = tickMaxNs = 0.0;
+}
+
+Point tick(bool fresh) {
+  Plant::run(HostHal::ledcDuty(DC_CONTROL_PIN), controlPeriodUs);
+  HostHal::advanceUs(controlPeriodUs);
+  if (fresh) {
+    Plant::Sample s = Plant::sample();
+    labV_meas = s.v;
+    labI_meas = s.i;
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  DcControl::tick(fresh);
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  tickNs += ns;
+  if (ns > tickMaxNs) tickMaxNs = ns;
+  ticks++;
+
+  return {HostHal::nowUs(), labV_meas, labI_meas, DcControl::getPwmDuty(), isCC};
+}
+
+void run(uint32_t ms) {
+  for (uint64_t end = HostHal::nowUs() + ms * 1000ULL; HostHal::nowUs() < end;) tick();
+}
+
+uint32_t getTicks() { return ticks; }
+double getTickNs() { return ticks ? tickNs / ticks : 0.0; }
+double getTickMaxNs() { return tickMaxNs; }
+
+} // namespace Rig
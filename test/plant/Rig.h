@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include "Plant.h"
+
+// Closed loop of DcControl around the plant model on the simulated clock.
+// Each tick runs the plant for one control period with the current PWM duty, publishes the
+// averaged INA226 reading to labV_meas/labI_meas and runs one DcControl step.
+namespace Rig {
+
+  struct Point {
+    uint64_t us;  // Simulated time at the end of the tick (us)
+    float v;      // Measured voltage (V)
+    float i;      // Measured current (A)
+    float duty;   // PWM duty after the step (%)
+    bool cc;      // Current loop active
+  };
+
+  // Reset the clock, plant and control globals; output on, automatic mode, unslewed setpoints
+  void begin(const Plant::Config& cfg, float loadOhms, float vset, float iset);
+  Point tick(bool fresh = true);        // One control period
+  void run(uint32_t ms);                // Ticks for ms without recording
+
+  uint32_t getTicks();                  // Ticks since begin()
+  double getTickNs();                   // Mean host CPU time of DcControl::tick (ns)
+  double getTickMaxNs();                // Worst host CPU time of DcControl::tick (ns)
+
+}
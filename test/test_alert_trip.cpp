@@ -0,0 +1,103 @@
+// INA226 ALERT trip timing on the simulated clock: the test plays the INA226, averaging the load current
+// over each conversion and pulling ALERT low when an averaged result exceeds the armed level. The
+// firmware times each trip from the last in-range conversion it picked up to the ISR's pin write; that
+// measurement, and the real onset-to-off time, must stay within two conversions.
+
+#include "Check.h"
+#include "HostHal.h"
+#include "ControlTask.h"
+#include "DcControl.h"
+#include "ErrMgr.h"
+#include "Globals.h"
+#include "Ina226Manager.h"
+#include "OutputControl.h"
+
+constexpr uint32_t LOOP_US = 1000;       // One pass of loop()
+constexpr uint32_t SETTLE_US = 4000000;  // Past the startup delay with the output on
+
+struct Result {
+  uint32_t trueUs;      // Onset to MOSFET pin low (us)
+  uint32_t measuredUs;  // OutputControl's figure for the trip (us)
+  uint32_t convUs;      // Conversion period (us)
+  bool pinLow;          // MOSFET pin low straight after the edge
+};
+
+// Step the load from iBefore to iAfter (multiples of the ALERT level) at fraction f into a conversion
+static Result run(float before, float after, float f) {
+  HostHal::reset();
+  HostHal::Ina226& ina = HostHal::ina226();
+  inaProfile = (uint8_t)Ina226Manager::Profile::Balanced;
+  labV_set = 12.0f;
+  ina.busV = 12.0f;
+  ina.currentA = 0.1f;
+  labI_meas = 0.0f;  // Not the previous run's trip current
+  manualOutputEnable = true;
+
+  Ina226Manager::begin();
+  OutputControl::begin();
+  DcControl::begin();
+  ErrMgr::begin();
+  ControlTask::begin();
+  HostHal::setPinLevel(INA226_ALERT_PIN, HIGH);  // Pulled up, released
+
+  auto loopFor = [](uint64_t untilUs) {
+    while (HostHal::nowUs() < untilUs) {
+      Ina226Manager::update();
+      HostHal::advanceUs(min<uint64_t>(LOOP_US, untilUs - HostHal::nowUs()));
+    }
+  };
+  loopFor(SETTLE_US);
+  float level = Ina226Manager::getTripLimit();
+  uint32_t conv = Ina226Manager::getConversionPeriodUs();
+  CHECK(level > 0.0f);
+  CHECK(HostHal::pinLevel(PROTECTION_MOSFET_PIN) == HIGH);
+  ina.currentA = before * level;
+
+  // Conversions run back to back from convOriginUs; the step lands f into the next one
+  uint64_t next = ina.convOriginUs + ((HostHal::nowUs() - ina.convOriginUs) / conv + 2) * conv;
+  uint64_t onset = next - conv + (uint64_t)(f * conv);
+  loopFor(onset);
+
+  // Each conversion end publishes its average; the first one over the level pulls ALERT low
+  Result r = {};
+  r.convUs = conv;
+  float avg = (before * f + after * (1.0f - f)) * level;
+  for (uint64_t end = next; end < next + 4 * conv; end += conv) {
+    loopFor(end);
+    ina.currentA = avg;
+    if (avg > level) {
+      HostHal::setPinLevel(INA226_ALERT_PIN, LOW);
+      r.trueUs = (uint32_t)(HostHal::nowUs() - onset);
+      r.pinLow = HostHal::pinLevel(PROTECTION_MOSFET_PIN) == LOW;
+      break;
+    }
+    avg = after * level;
+  }
+  loopFor(HostHal::nowUs() + 3 * conv);  // Control ticks pick the trip up
+
+  OutputControl::TripStats ts;
+  OutputControl::getTripStats(ts);
+  r.measuredUs = ts.hwLastUs;
+  return r;
+}
+
+int main() {
+  // A hard step trips on the conversion it lands in; a marginal one only on the next
+  Result hard = run(0.05f, 3.0f, 0.6f);
+  Result marginal = run(0.05f, 1.5f, 0.6f);
+  printf("%-10s %10s %12s %12s\n", "step", "conv us", "onset-off us", "measured us");
+  printf("%-10s %10u %12u %12u\n", "3x", (unsigned)hard.convUs, (unsigned)hard.trueUs, (unsigned)hard.measuredUs);
+  printf("%-10s %10u %12u %12u\n", "1.5x", (unsigned)marginal.convUs, (unsigned)marginal.trueUs,
+         (unsigned)marginal.measuredUs);
+
+  for (const Result* r : {&hard, &marginal}) {
+    CHECK(r->pinLow);
+    CHECK(r->trueUs > 0 && r->trueUs <= 2 * r->convUs);            // The static bound on the System page
+    CHECK(r->measuredUs > 0 && r->measuredUs <= 2 * r->convUs);
+    CHECK(r->trueUs <= r->measuredUs + r->convUs);                  // Onset may sit inside the last in-range conversion
+  }
+  CHECK(hard.trueUs < hard.convUs);
+  CHECK(marginal.trueUs > marginal.convUs);  // Needed a second averaged conversion
+
+  return checkResult("test_alert_trip");
+}
@@ -0,0 +1,91 @@
+// AutoTune end to end against the plant: relay test on the CV loop, at the nominal tick with a
+// conversion every tick and at the fast tick where most ticks see no new conversion. The relay
+// must only switch on fresh samples, both runs must agree on Tu, and the tuned gains must settle.
+
+#include "Check.h"
+#include "Rig.h"
+#include "HostHal.h"
+#include "Globals.h"
+#include "Config.h"
+#include "AutoTune.h"
+#include "DcControl.h"
+
+constexpr uint32_t CONV_US = DC_CONTROL_UPDATE_INTERVAL * 1000UL; // Balanced profile conversion period
+
+struct Tune {
+  AutoTune::State state;
+  float ku, tu;
+  int staleSwitches;   // Relay steps taken on a tick without a new conversion
+  float kp, kd;
+};
+
+// Relay test on the CV loop at 12 V into 12 ohms, ticking every periodUs
+static Tune tune(uint32_t periodUs) {
+  Rig::begin(Plant::buck(), 12.0f, 12.0f, 3.0f);
+  controlPeriodUs = periodUs;
+  Rig::run(3000);
+
+  Tune r = {};
+  CHECK(AutoTune::start(AutoTune::Loop::Voltage));
+  float prevDuty = DcControl::getPwmDuty();
+  uint64_t nextConvUs = HostHal::nowUs() + CONV_US;
+  for (uint32_t k = 0; k < 40000000 / periodUs && AutoTune::isActive(); k++) {
+    bool fresh = HostHal::nowUs() + periodUs >= nextConvUs;
+    if (fresh) nextConvUs += CONV_US;
+    Rig::Point p = Rig::tick(fresh);
+    if (k > 0 && !fresh && AutoTune::isActive() && p.duty != prevDuty) r.staleSwitches++; // k = 0 engages the relay
+    prevDuty = p.duty;
+  }
+  r.state = AutoTune::getState();
+  r.ku = AutoTune::getKu();
+  r.tu = AutoTune::getTu();
+  r.kp = Kp;
+  r.kd = Kd;
+  return r;
+}
+
+// Step 5 V -> 12 V with the current gains; peak-to-peak ripple over the last second (V)
+static float settledRipple(float& finalV) {
+  Rig::begin(Plant::buck(), 12.0f, 5.0f, 3.0f);
+  Rig::run(3000);
+  labV_set = 12.0f;
+  Rig::run(2000);
+  float lo = 1e9f, hi = -1e9f;
+  for (int k = 0; k < 1000000 / (int)controlPeriodUs; k++) {
+    Rig::Point p = Rig::tick();
+    lo = fminf(lo, p.v);
+    hi = fmaxf(hi, p.v);
+    finalV = p.v;
+  }
+  return hi - lo;
+}
+
+int main() {
+  Tune nominal = tune(CONV_US);
+  Tune fast = tune(5000);
+
+  printf("%-10s %6s %8s %8s %8s %10s %10s\n", "tick", "state", "Ku", "Tu s", "stale sw", "Kp", "Kd");
+  printf("%-10s %6u %8.2f %8.3f %8d %10.4f %10.4f\n", "35 ms", (unsigned)nominal.state, nominal.ku, nominal.tu,
+         nominal.staleSwitches, nominal.kp, nominal.kd);
+  printf("%-10s %6u %8.2f %8.3f %8d %10.4f %10.4f\n", "5 ms", (unsigned)fast.state, fast.ku, fast.tu,
+         fast.staleSwitches, fast.kp, fast.kd);
+
+  CHECK(nominal.state == AutoTune::State::Done);
+  CHECK(fast.state == AutoTune::State::Done);
+  CHECK(fast.staleSwitches == 0);
+  CHECK(nominal.ku > 0.0f && nominal.tu >= 2.0f * CONV_US * 1e-6f * 0.99f);  // A sampled relay needs two samples
+  CHECK(fabsf(fast.tu - nominal.tu) <= 0.25f * nominal.tu);  // Same plant, same sample rate
+  CHECK(fabsf(fast.ku - nominal.ku) <= 0.25f * nominal.ku);
+
+  // The gains from the fast-tick run hold 12 V without a limit cycle at the nominal tick
+  Kp = fast.kp;
+  Ki = 0.0f;
+  Kd = fast.kd;
+  float finalV = 0.0f;
+  float ripple = settledRipple(finalV);
+  printf("tuned step 5->12 V: final %.3f V, ripple %.3f V\n", finalV, ripple);
+  CHECK_NEAR(finalV, 12.0, 0.1);
+  CHECK(ripple < 0.1f);
+
+  return checkResult("test_autotune");
+}
@@ -0,0 +1,111 @@
+// Black box on the LittleFS stub: 2000 control ticks with three faults. Each record is frozen in RAM,
+// held there while the output is on (flash writes stall the control tick on target), written once the
+// output goes off, and must come back with its trigger tick on the fault.
+
+#include "Check.h"
+#include "HostHal.h"
+#include "BlackBox.h"
+#include "Config.h"
+#include "ErrMgr.h"
+#include "Globals.h"
+#include <LittleFS.h>
+
+constexpr uint32_t TICKS = 2000;
+constexpr uint32_t TICK_US = 1000;
+constexpr uint32_t CLEAR_AFTER = 10;     // Ticks a fault stays raised
+constexpr uint32_t OFF_AFTER = 100;      // Ticks from a fault until the output is switched off
+constexpr uint32_t ON_AFTER = 150;       // Ticks from a fault until it is switched on again
+
+struct Fault {
+  uint32_t tick;
+  ErrMgr::Bit bit;
+  bool cutsOutput;                       // Otherwise the output stays on to the end of the run
+};
+
+static const Fault FAULTS[] = {
+  {300, ErrMgr::Overheat, true},
+  {900, ErrMgr::FuseBlown, true},
+  {1500, ErrMgr::VoltageDev, false},
+};
+constexpr uint32_t LATE_TICK = 1600;     // Rises while the third record is still held
+
+int main() {
+  HostHal::reset();
+  CHECK(LittleFS.begin(true));
+  manualOutputEnable = false;
+  ErrMgr::update();
+  ErrMgr::assign(UINT32_MAX, 0);
+  ErrMgr::begin();
+  BlackBox::begin(true);
+  outputActive = true;
+
+  bool heldWhileOn = true;               // No record reached flash while the output was on
+  uint8_t stored = 0;
+  for (uint32_t k = 0; k < TICKS; k++) {
+    labV_meas = k * 0.001f;              // Tick number in the record's mV column
+    for (const Fault& f : FAULTS) {
+      if (k == f.tick) ErrMgr::set(f.bit);
+      if (k == f.tick + CLEAR_AFTER) ErrMgr::clear(f.bit);
+      if (f.cutsOutput && k == f.tick + OFF_AFTER) outputActive = false;
+      if (f.cutsOutput && k == f.tick + ON_AFTER) outputActive = true;
+    }
+    if (k == LATE_TICK) ErrMgr::set(ErrMgr::ShortCircuit);
+    BlackBox::tick(true);
+    BlackBox::update();
+    BlackBox::Info info[BlackBox::SLOTS];
+    uint8_t n = BlackBox::list(info, BlackBox::SLOTS);
+    if (n != stored && outputActive) heldWhileOn = false;
+    stored = n;
+    HostHal::advanceUs(TICK_US);
+  }
+  CHECK(heldWhileOn);
+  CHECK(stored == 2);
+  CHECK(BlackBox::isWriting());          // Third record still waiting for the output to go off
+
+  outputActive = false;
+  for (uint32_t pass = 0; pass < 100 && BlackBox::isWriting(); pass++) BlackBox::update();
+  CHECK(!BlackBox::isWriting());
+  CHECK(BlackBox::getMissed() == 1);     // The late fault, raised while the ring was frozen
+  CHECK(BlackBox::getWriteStats().lostTicks == 0);
+
+  BlackBox::Info info[BlackBox::SLOTS];
+  uint8_t n = BlackBox::list(info, BlackBox::SLOTS);
+  CHECK(n == 3);
+  printf("%-5s %-5s %6s %8s %8s %10s\n", "seq", "slot", "ticks", "trigger", "new", "trig mV");
+  for (uint8_t r = 0; r < n; r++) {
+    const Fault& f = FAULTS[2 - r];      // Newest first
+    CHECK(info[r].seq == 2u - r);
+    CHECK(info[r].newBits == (1UL << f.bit));
+
+    File file = LittleFS.open(BlackBox::path(info[r].slot), "r");
+    CHECK((bool)file);
+    if (!file) continue;
+    BlackBoxHeader h;
+    CHECK(file.read((uint8_t*)&h, sizeof(h)) == sizeof(h));
+    CHECK(h.magic == BlackBox::MAGIC && h.version == BlackBox::VERSION && h.tickSize == sizeof(BlackBoxTick));
+    CHECK(h.count == info[r].count && h.count <= BLACKBOX_DEPTH);
+    CHECK(h.trigger == h.count - 1 - BLACKBOX_POST);
+    CHECK(file.size() == sizeof(h) + (size_t)h.count * sizeof(BlackBoxTick));
+
+    // Ticks are consecutive, oldest first, with the fault on the trigger
+    BlackBoxTick t, prev = {};
+    bool consecutive = true;
+    uint16_t triggerMv = 0;
+    for (uint16_t i = 0; i < h.count; i++) {
+      if (file.read((uint8_t*)&t, sizeof(t)) != sizeof(t)) {
+        consecutive = false;
+        break;
+      }
+      if (i > 0 && t.mV != prev.mV + 1) consecutive = false;
+      if (i == h.trigger) triggerMv = t.mV;
+      prev = t;
+    }
+    file.close();
+    CHECK(consecutive);
+    CHECK(triggerMv == f.tick);
+    printf("%-5u %-5u %6u %8u %8lx %10u\n", (unsigned)h.seq, (unsigned)info[r].slot, (unsigned)h.count,
+           (unsigned)h.trigger, (unsigned long)h.newBits, (unsigned)triggerMv);
+  }
+
+  return checkResult("test_blackbox");
+}
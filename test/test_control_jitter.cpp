@@ -0,0 +1,117 @@
+// Control task scheduling on the simulated clock: the periodic timer wakes the control task through a
+// dispatch latency with occasional spikes, while loop() picks up INA226 conversions between stalls of
+// the web and display work. Period jitter must stay within the dispatch latency, and the sample
+// statistics must show the loop() stalls the period statistics cannot see.
+
+#include "Check.h"
+#include "HostHal.h"
+#include "ControlTask.h"
+#include "DcControl.h"
+#include "ErrMgr.h"
+#include "Globals.h"
+#include "Ina226Manager.h"
+#include "OutputControl.h"
+
+constexpr uint32_t WARMUP_US = 200000;   // Simulated time before the statistics start
+constexpr uint32_t RUN_US = 20000000;    // Simulated run time
+constexpr uint32_t LOOP_US = 1000;       // One pass of loop() without stalls
+constexpr uint32_t LATENCY_MAX_US = 300; // Normal timer-to-task dispatch latency
+constexpr uint32_t SPIKE_US = 2500;      // Occasional dispatch spike (WiFi, flash writes)
+
+static uint32_t seed;
+
+static uint32_t nextRandom() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+// 0..LATENCY_MAX_US, one spike in 64 dispatches
+static uint32_t dispatchLatency() {
+  uint32_t r = nextRandom();
+  return (r & 63) == 0 ? SPIKE_US : r % (LATENCY_MAX_US + 1);
+}
+
+// Run the firmware's scheduling for RUN_US with loop() stalling stallUs every 50 passes
+static ControlTask::Stats run(uint32_t stallUs) {
+  HostHal::reset();
+  seed = 1;
+  HostHal::setDispatchLatency(dispatchLatency);
+  HostHal::costs().i2cUs = 60;
+  HostHal::ina226().busV = 12.0f;
+  HostHal::ina226().currentA = 0.5f;
+  inaProfile = (uint8_t)Ina226Manager::Profile::Balanced;
+
+  Ina226Manager::begin();
+  OutputControl::begin();
+  DcControl::begin();
+  ErrMgr::begin();
+  ControlTask::begin();
+
+  // Warm up so samples left over from the previous run are consumed before counting
+  for (uint32_t pass = 0; HostHal::nowUs() < WARMUP_US; pass++) {
+    Ina226Manager::update();
+    HostHal::advanceUs(LOOP_US);
+  }
+  ControlTask::resetStats();
+
+  for (uint32_t pass = 0; HostHal::nowUs() < WARMUP_US + RUN_US; pass++) {
+    Ina226Manager::update();
+    ControlTask::poll();
+    HostHal::advanceUs(pass % 50 == 49 ? stallUs : LOOP_US);
+  }
+
+  ControlTask::Stats st;
+  ControlTask::getStats(st);
+  return st;
+}
+
+static void print(const char* name, const ControlTask::Stats& st) {
+  printf("%-12s %7u %6u %6u %8d %8d %8u %8u %8u %8u %6u\n", name, (unsigned)st.ticks, (unsigned)st.overruns,
+         (unsigned)st.missed, (int)st.jitterMinUs, (int)st.jitterMaxUs, (unsigned)st.staleTicks,
+         (unsigned)st.sampleAgeMinUs, (unsigned)st.sampleAgeMaxUs, (unsigned)st.sampleGapMaxUs,
+         (unsigned)st.skippedSamples);
+}
+
+int main() {
+  printf("%-12s %7s %6s %6s %8s %8s %8s %8s %8s %8s %6s\n", "loop stall", "ticks", "over", "missed", "jmin us",
+         "jmax us", "stale", "age min", "age max", "gap max", "skip");
+  ControlTask::Stats quiet = run(LOOP_US);
+  ControlTask::Stats stalled = run(60000);
+  ControlTask::Stats again = run(60000);
+  print("none", quiet);
+  print("60 ms", stalled);
+
+  uint32_t period = quiet.periodUs;
+  uint32_t convUs = Ina226Manager::getConversionPeriodUs();
+  CHECK(ControlTask::isRunning());
+  CHECK(period == DC_CONTROL_UPDATE_INTERVAL * 1000UL);
+
+  // The timer keeps its own schedule: jitter is bounded by the dispatch latency, whatever loop() does
+  for (const ControlTask::Stats* st : {&quiet, &stalled}) {
+    CHECK_NEAR(st->ticks, RUN_US / period, 2);
+    CHECK(st->overruns == 0);
+    CHECK(st->missed == 0);
+    CHECK(st->jitterMaxUs <= (int32_t)SPIKE_US);
+    CHECK(st->jitterMinUs >= -(int32_t)SPIKE_US);
+  }
+
+  // A short loop() picks every conversion up within one pass and the next tick consumes it
+  CHECK(quiet.sampleAgeMaxUs <= period + LOOP_US + SPIKE_US);
+  CHECK(quiet.sampleGapMaxUs <= convUs + 2 * LOOP_US);
+  CHECK(quiet.staleTicks <= quiet.ticks / 50);
+
+  // Stalls delay pick-up and leave ticks without a sample; the period statistics stay clean
+  CHECK(stalled.sampleGapMaxUs >= 60000);
+  CHECK(stalled.sampleGapMaxUs <= 60000 + 2 * convUs);
+  CHECK(stalled.skippedSamples > quiet.skippedSamples);
+  CHECK(stalled.sampleAgeMaxUs <= period + LOOP_US + SPIKE_US);
+  CHECK(stalled.staleTicks > quiet.staleTicks);
+
+  // Same seed, same schedule
+  CHECK(again.ticks == stalled.ticks);
+  CHECK(again.jitterMaxUs == stalled.jitterMaxUs);
+  CHECK(again.sampleGapMaxUs == stalled.sampleGapMaxUs);
+  CHECK(again.staleTicks == stalled.staleTicks);
+
+  return checkResult("test_control_jitter");
+}
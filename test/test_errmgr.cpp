@@ -0,0 +1,135 @@
+// ErrMgr bitset and event ring: edges from assign(), the latch and its LATCH_CLEAR event, a reader
+// that falls behind the ring, and producers racing a reader. The racing part uses plain host threads:
+// the stub RTOS runs one task at a time, which would never overlap a push() with a poll().
+
+#include "Check.h"
+#include "HostHal.h"
+#include "ErrMgr.h"
+#include "Globals.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ErrMgr;
+
+constexpr uint32_t PRODUCERS = 4;         // Racing threads, one bit each
+constexpr uint32_t TOGGLES = 20000;       // Edges per producer
+constexpr uint32_t SPACING = 64;          // Busy-wait between a producer's edges
+constexpr uint32_t BURST = 8;             // Edges between yields, so the reader gets the CPU on a single core
+
+// Every event the reader has not seen yet, in order
+static std::vector<Event> drain(Cursor& c) {
+  std::vector<Event> out;
+  Event ev;
+  while (poll(c, ev)) out.push_back(ev);
+  return out;
+}
+
+// A whole event: its bit agrees with its snapshot, and the latch covers what is active
+static bool consistent(const Event& ev) {
+  if (ev.bit == LATCH_CLEAR) return !ev.rising && ev.code == ev.active;
+  if (ev.bit >= BIT_COUNT) return false;
+  return (((ev.active >> ev.bit) & 1) != 0) == ev.rising && (ev.code & ev.active) == ev.active;
+}
+
+int main() {
+  HostHal::reset();
+  manualOutputEnable = false;
+  update();
+  assign(UINT32_MAX, 0);
+  begin();
+
+  // Edges: one event per changed bit, lowest bit first; writing the same bits again is silent
+  Cursor c = subscribe();
+  uint32_t mask = (1UL << Overheat) | (1UL << FuseBlown) | (1UL << VoltageDev);
+  assign(mask, (1UL << Overheat) | (1UL << VoltageDev));
+  std::vector<Event> ev = drain(c);
+  CHECK(ev.size() == 2);
+  CHECK(ev.size() == 2 && ev[0].bit == Overheat && ev[0].rising && ev[1].bit == VoltageDev && ev[1].rising);
+  CHECK(ev.size() == 2 && ev[1].active == ((1UL << Overheat) | (1UL << VoltageDev)));
+  assign(mask, (1UL << Overheat) | (1UL << VoltageDev));
+  CHECK(drain(c).empty());
+  assign(mask, 1UL << FuseBlown);
+  ev = drain(c);
+  CHECK(ev.size() == 3);
+  CHECK(ev.size() == 3 && !ev[0].rising && ev[0].bit == Overheat && ev[1].rising && ev[1].bit == FuseBlown &&
+        !ev[2].rising && ev[2].bit == VoltageDev);
+  CHECK(ev.size() == 3 && ev[2].active == (1UL << FuseBlown));
+  for (const Event& e : ev) CHECK(consistent(e));
+
+  // Latch: cleared bits stay in code() until a manual enable, which posts LATCH_CLEAR
+  CHECK(active() == (1UL << FuseBlown));
+  CHECK(code() == mask);
+  manualOutputEnable = true;
+  update();
+  ev = drain(c);
+  CHECK(ev.size() == 1 && ev[0].bit == LATCH_CLEAR && !ev[0].rising && ev[0].code == (1UL << FuseBlown));
+  CHECK(code() == (1UL << FuseBlown));
+  update();  // Held enable: no second clear
+  CHECK(drain(c).empty());
+  manualOutputEnable = false;
+  update();
+  assign(mask, 0);
+  drain(c);
+
+  // Overrun: a reader more than EVENT_DEPTH behind skips to the oldest event still held
+  Cursor slow = subscribe();
+  for (uint32_t k = 0; k < EVENT_DEPTH + 8; k++) assign(ShortCircuit, (k & 1) == 0);
+  ev = drain(slow);
+  CHECK(slow.lost == 8);
+  CHECK(ev.size() == EVENT_DEPTH);
+  CHECK(!ev.empty() && ev[0].rising);  // Event 8 raised the bit, like every even one
+  bool alternates = true;
+  for (size_t k = 1; k < ev.size(); k++) alternates &= ev[k].rising != ev[k - 1].rising;
+  CHECK(alternates);
+  assign(ShortCircuit, false);
+  pollRising(c);
+
+  // Racing producers, one bit each, against a reader polling as fast as it can
+  Cursor race = subscribe();
+  std::atomic<uint32_t> running{PRODUCERS};
+  std::atomic<bool> go{false};
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    producers.emplace_back([p, &running, &go] {
+      while (!go.load()) {}
+      for (uint32_t k = 0; k < TOGGLES; k++) {
+        assign((Bit)p, (k & 1) == 0);
+        for (volatile uint32_t n = 0; n < SPACING; n++) {}
+        if (k % BURST == BURST - 1) std::this_thread::yield();
+      }
+      running.fetch_sub(1);
+    });
+  }
+  go.store(true);
+  uint64_t seen = 0, torn = 0, repeats = 0;
+  int8_t lastRising[PRODUCERS];
+  uint32_t lostAt[PRODUCERS];
+  for (uint32_t p = 0; p < PRODUCERS; p++) lastRising[p] = -1, lostAt[p] = 0;
+  Event e;
+  for (;;) {
+    bool done = running.load() == 0;
+    while (poll(race, e)) {
+      seen++;
+      if (!consistent(e) || e.bit >= PRODUCERS) {
+        torn++;
+        continue;
+      }
+      // With nothing lost since this bit's previous event, its edges must alternate
+      if (lastRising[e.bit] == (int8_t)e.rising && lostAt[e.bit] == race.lost) repeats++;
+      lastRising[e.bit] = e.rising;
+      lostAt[e.bit] = race.lost;
+    }
+    if (done) break;
+  }
+  for (std::thread& t : producers) t.join();
+  printf("%u producers x %u edges: %llu read, %u lost, %llu torn, %llu repeated\n", (unsigned)PRODUCERS,
+         (unsigned)TOGGLES, (unsigned long long)seen, (unsigned)race.lost, (unsigned long long)torn,
+         (unsigned long long)repeats);
+  CHECK(torn == 0);
+  CHECK(repeats == 0);
+  CHECK(seen + race.lost == (uint64_t)PRODUCERS * TOGGLES);  // Each edge read once or counted lost
+  CHECK(active() == 0);  // Every producer ended on a clear
+
+  return checkResult("test_errmgr");
+}
@@ -0,0 +1,110 @@
+// I²t fuse against canned current profiles: constant overloads must open close to the analytic
+// curve at any sample rate, inrush must pass the slow curve but not the fast one, a slight
+// sustained overload must open eventually, and a blown fuse must close again once cooled.
+
+#include "Check.h"
+#include "FuseModel.h"
+
+using namespace FuseModel;
+
+constexpr float RATED = 2.0f;  // Fuse rating (A)
+
+// Time to open at a constant multiple k, stepping every dtS (s); negative if not open after limitS
+static float openTime(const CurveParams& c, float k, float dtS, float limitS = 30.0f) {
+  Fuse f;
+  for (float t = dtS; t <= limitS; t += dtS)
+    if (f.step(k * RATED, RATED, dtS, c)) return t;
+  return -1.0f;
+}
+
+// Replay a profile of (duration s, multiple) segments; true if the fuse opened
+struct Segment {
+  float seconds;
+  float k;
+};
+static bool runProfile(const CurveParams& c, const Segment* seg, int n, float dtS) {
+  Fuse f;
+  bool opened = false;
+  for (int s = 0; s < n; s++)
+    for (float t = 0.0f; t < seg[s].seconds; t += dtS) opened |= f.step(seg[s].k * RATED, RATED, dtS, c);
+  return opened;
+}
+
+int main() {
+  const CurveParams fast = params(Curve::Fast, 0.0f, 0.0f);
+  const CurveParams slow = params(Curve::Slow, 0.0f, 0.0f);
+  const CurveParams custom = params(Curve::Custom, 0.2f, 4.0f);
+
+  // Constant overloads: stepped result against the analytic curve, at 1 ms and at the 35 ms tick
+  struct Case {
+    const char* name;
+    CurveParams c;
+    float k;
+  } cases[] = {
+    {"fast", fast, 1.1f}, {"fast", fast, 2.0f}, {"slow", slow, 1.1f}, {"slow", slow, 2.0f},
+    {"slow", slow, 5.0f}, {"custom", custom, 1.5f}, {"custom", custom, 3.0f},
+  };
+  printf("%-8s %6s %10s %10s %10s\n", "curve", "I/Ir", "curve ms", "1 ms", "35 ms");
+  for (const Case& k : cases) {
+    float expect = tripTime(k.k, k.c);
+    float t1 = openTime(k.c, k.k, 0.001f);
+    float t35 = openTime(k.c, k.k, 0.035f);
+    printf("%-8s %6.2f %10.1f %10.1f %10.1f\n", k.name, k.k, expect * 1e3f, t1 * 1e3f, t35 * 1e3f);
+    CHECK(expect > 0.0f);
+    CHECK_NEAR(t1, expect, 0.02 * expect + 0.001);        // Padé step error stays within 2 %
+    CHECK(t35 > 0.0f && fabsf(t35 - expect) <= 0.1f * expect + 0.035f);  // Within a sample and 10 %
+  }
+
+  // At or above the peak multiple the fuse opens on the first sample; below the rating never
+  CHECK_NEAR(openTime(fast, 3.0f, 0.035f), 0.035, 1e-6);
+  CHECK_NEAR(openTime(slow, 10.0f, 0.035f), 0.035, 1e-6);
+  CHECK(tripTime(1.0f, slow) < 0.0f);
+  CHECK(openTime(fast, 0.98f, 0.035f, 60.0f) < 0.0f);
+  CHECK(openTime(slow, 0.95f, 0.001f, 60.0f) < 0.0f);
+
+  // Inrush: 5x for 30 ms, then 0.9x of the rating. Slow-blow rides through, fast-blow opens.
+  const Segment inrush[] = {{0.03f, 5.0f}, {5.0f, 0.9f}};
+  CHECK(!runProfile(slow, inrush, 2, 0.001f));
+  CHECK(!runProfile(slow, inrush, 2, 0.005f));
+  CHECK(runProfile(fast, inrush, 2, 0.001f));
+
+  // Repeated 20 ms inrush with time to cool between pulses passes the slow curve; back to back it does not
+  const Segment spaced[] = {{0.02f, 5.0f}, {2.0f, 0.5f}, {0.02f, 5.0f}, {2.0f, 0.5f}, {0.02f, 5.0f}, {2.0f, 0.5f}};
+  const Segment packed[] = {{0.02f, 5.0f}, {0.01f, 0.5f}, {0.02f, 5.0f}, {0.01f, 0.5f}, {0.02f, 5.0f}, {0.01f, 0.5f}};
+  CHECK(!runProfile(slow, spaced, 6, 0.001f));
+  CHECK(runProfile(slow, packed, 6, 0.001f));
+
+  // Slight sustained overload (1.05x) opens after the curve time
+  float creep = openTime(slow, 1.05f, 0.035f);
+  printf("slow 1.05x opens after %.2f s (curve %.2f s)\n", creep, tripTime(1.05f, slow));
+  CHECK(creep > 0.0f && fabsf(creep - tripTime(1.05f, slow)) <= 0.1f * tripTime(1.05f, slow) + 0.035f);
+
+  // A blown fuse stays open until cooled below RESET_HEAT, then closes
+  Fuse f;
+  float t = 0.0f;
+  while (!f.step(2.0f * RATED, RATED, 0.001f, fast)) t += 0.001f;
+  float cool = 0.0f;
+  while (f.step(0.0f, RATED, 0.001f, fast) && cool < 10.0f) cool += 0.001f;
+  printf("fast 2x: open after %.1f ms, closed after %.1f ms cooling at heat %.3f\n", t * 1e3f, cool * 1e3f,
+         f.getHeat());
+  CHECK(f.getHeat() < RESET_HEAT && f.getHeat() > RESET_HEAT * 0.9f);
+  CHECK_NEAR(cool, fast.tauS * logf(1.0f / RESET_HEAT), 0.005);
+
+  // Custom parameters are clamped to the supported range
+  CurveParams lo = params(Curve::Custom, 0.0001f, 1.0f);
+  CurveParams hi = params(Curve::Custom, 1000.0f, 100.0f);
+  CHECK_NEAR(lo.tauS, 0.005, 1e-6);
+  CHECK_NEAR(lo.peak, 1.5, 1e-6);
+  CHECK_NEAR(hi.tauS, 60.0, 1e-6);
+  CHECK_NEAR(hi.peak, 20.0, 1e-6);
+
+  // A rating of zero or a NaN sample leaves the state alone
+  Fuse g;
+  g.step(1.5f * RATED, RATED, 0.01f, custom);
+  float heat = g.getHeat();
+  g.step(NAN, RATED, 0.01f, custom);
+  g.step(10.0f, 0.0f, 0.01f, custom);
+  CHECK(g.getHeat() == heat);
+
+  return checkResult("test_fuse_model");
+}
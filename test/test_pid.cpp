@@ -0,0 +1,134 @@
+// PidController unit tests for the float and Q16.16 kernels
+
+#include "Check.h"
+#include "PidController.h"
+
+struct FloatTraits {
+  typedef PidFloatMath Math;
+  static constexpr bool derivativeOnMeasurement = false;
+  static constexpr PidAntiWindup antiWindup = PidAntiWindup::ClampAndUnwind;
+  static constexpr bool clampOutput = false;
+};
+
+struct Q16Traits : FloatTraits {
+  typedef PidQ16Math Math;
+};
+
+template <typename MathT>
+struct MeasTraits {
+  typedef MathT Math;
+  static constexpr bool derivativeOnMeasurement = true;
+  static constexpr PidAntiWindup antiWindup = PidAntiWindup::Clamp;
+  static constexpr bool clampOutput = true;
+};
+
+// P, I and D terms against hand-computed values
+template <typename Traits>
+static void testTerms(double tol) {
+  PidController<Traits> pid;
+  pid.configure(2.0f, 10.0f, 0.5f, 100.0f, 0.01f);
+
+  // P = 2*1, I = 10*1*0.01, D = 0.5*(1-0)/0.01
+  CHECK_NEAR(pid.update(1.0f), 2.0 + 0.1 + 50.0, tol);
+  CHECK_NEAR(pid.getIntegral(), 0.1, tol);
+  CHECK_NEAR(pid.getDerivative(), 50.0, tol);
+
+  // Same error again: derivative drops out, integral keeps accumulating
+  CHECK_NEAR(pid.update(1.0f), 2.0 + 0.2, tol);
+  CHECK_NEAR(pid.getPrevError(), 1.0, tol);
+
+  pid.reset();
+  CHECK_NEAR(pid.getIntegral(), 0.0, tol);
+  CHECK_NEAR(pid.update(-0.5f), -1.0 - 0.05 - 25.0, tol);
+}
+
+// Integral clamps at the limit; unwind backs out the last step only in the saturated direction
+template <typename Traits>
+static void testWindup(double tol) {
+  PidController<Traits> pid;
+  pid.configure(0.0f, 100.0f, 0.0f, 1.5f, 0.01f);
+  for (int k = 0; k < 10; k++) pid.update(1.0f);
+  CHECK_NEAR(pid.getIntegral(), 1.5, tol);
+
+  pid.resetIntegral();
+  pid.update(1.0f);                      // Integral 1.0
+  pid.unwind(false, true);               // Saturated low, error positive: keep
+  CHECK_NEAR(pid.getIntegral(), 1.0, tol);
+  pid.unwind(true, false);               // Saturated high, error positive: undo
+  CHECK_NEAR(pid.getIntegral(), 0.0, tol);
+
+  pid.update(1.0f);
+  pid.halveIntegral();
+  CHECK_NEAR(pid.getIntegral(), 0.5, tol);
+}
+
+// Gains change only through configure(); identical arguments keep the built gains
+template <typename Traits>
+static void testReconfigure(double tol) {
+  PidController<Traits> pid;
+  pid.configure(1.0f, 0.0f, 0.0f, 10.0f, 0.035f);
+  CHECK_NEAR(pid.update(2.0f), 2.0, tol);
+  pid.configure(1.0f, 0.0f, 0.0f, 10.0f, 0.035f);
+  CHECK_NEAR(pid.update(2.0f), 2.0, tol);
+  pid.configure(3.0f, 0.0f, 0.0f, 10.0f, 0.035f);
+  CHECK_NEAR(pid.update(2.0f), 6.0, tol);
+}
+
+// Derivative on measurement ignores setpoint kicks and opposes the measurement's motion
+template <typename MathT>
+static void testDerivativeOnMeasurement(double tol) {
+  PidController<MeasTraits<MathT>> pid;
+  pid.configure(0.0f, 0.0f, 0.1f, 10.0f, 0.01f);
+  pid.setOutputLimits(-50.0f, 50.0f);
+  pid.update(0.0f, 0.0f);
+  CHECK_NEAR(pid.update(5.0f, 0.0f), 0.0, tol);    // Error step, measurement still
+  CHECK_NEAR(pid.update(5.0f, 1.0f), -10.0, tol);  // Measurement rises: -0.1 * 1 / 0.01
+  CHECK_NEAR(pid.update(5.0f, 0.0f), 10.0, tol);
+  CHECK_NEAR(pid.update(0.0f, 20.0f), -50.0, tol); // Output clamp
+}
+
+// Q16: a measurement saturated at Q16_MIN must not wrap when negated (-INT32_MIN)
+static void testQ16NegationSaturates() {
+  CHECK(q16Neg(Q16_MIN) == Q16_MAX);
+  CHECK(q16Neg(Q16_MAX) == -Q16_MAX);
+  CHECK(q16Neg(-Q16_ONE) == Q16_ONE);
+
+  PidController<MeasTraits<PidQ16Math>> pid;
+  pid.configure(0.0f, 0.0f, 1.0f, 10.0f, 1.0f);
+  pid.setOutputLimits(-1000.0f, 1000.0f);
+  pid.update(0.0f, 0.0f);
+  float out = pid.update(0.0f, -1e6f);   // from() saturates the measurement to Q16_MIN
+  CHECK(pid.getDerivative() > 30000.0f); // Falling measurement: positive, saturated derivative
+  CHECK_NEAR(out, 1000.0, 0.0);
+}
+
+// Q16 and float agree on a long pseudo-random error sequence
+static void testQ16TracksFloat() {
+  PidController<FloatTraits> f;
+  PidController<Q16Traits> q;
+  f.configure(3.0f, 1.0f, 0.05f, 50.0f, 0.035f);
+  q.configure(3.0f, 1.0f, 0.05f, 50.0f, 0.035f);
+  uint32_t seed = 12345;
+  double worst = 0.0;
+  for (int k = 0; k < 10000; k++) {
+    seed = seed * 1664525u + 1013904223u;
+    float e = ((seed >> 8) / 16777216.0f - 0.5f) * 2.0f;  // [-1, 1) V
+    worst = fmax(worst, fabs(f.update(e) - q.update(e)));
+  }
+  CHECK(worst < 0.01);
+  CHECK_NEAR(f.getIntegral(), q.getIntegral(), 0.01);
+}
+
+int main() {
+  testTerms<FloatTraits>(1e-4);
+  testTerms<Q16Traits>(2e-3);
+  testWindup<FloatTraits>(1e-5);
+  testWindup<Q16Traits>(1e-3);
+  testReconfigure<FloatTraits>(1e-6);
+  testReconfigure<Q16Traits>(1e-3);
+  testDerivativeOnMeasurement<PidFloatMath>(1e-3);
+  testDerivativeOnMeasurement<PidQ16Math>(2e-2);
+  testQ16NegationSaturates();
+  testQ16TracksFloat();
+  return checkResult("test_pid");
+}
@@ -0,0 +1,107 @@
+// Sequencer on the simulated clock: 5 ms control ticks with INA226 conversions arriving at an uneven
+// pace. Step averages must weight every conversion once however long it was held, steps must start
+// on their deadlines, and pause/resume must keep the remaining dwell.
+
+#include "Check.h"
+#include "HostHal.h"
+#include "Globals.h"
+#include "Sequencer.h"
+
+constexpr uint32_t TICK_US = 5000;
+
+static uint64_t nextConvUs;   // Next conversion (simulated us)
+static uint32_t convCount;    // Conversions so far
+
+// One control tick; conversions alternate 10 ms and 60 ms apart and alternate between two readings,
+// so the held reading covers six times more ticks than the quick one
+static void tick() {
+  HostHal::advanceUs(TICK_US);
+  bool fresh = HostHal::nowUs() >= nextConvUs;
+  if (fresh) {
+    convCount++;
+    bool quick = convCount & 1;
+    labV_meas = quick ? 10.0f : 12.0f;
+    labI_meas = quick ? 1.0f : 2.0f;
+    nextConvUs += quick ? 60000 : 10000;  // The quick reading is replaced after 60 ms, the other after 10
+  }
+  Sequencer::tick(fresh);
+}
+
+static void runMs(uint32_t ms) {
+  for (uint64_t end = HostHal::nowUs() + ms * 1000ULL; HostHal::nowUs() < end;) tick();
+}
+
+int main() {
+  HostHal::reset();
+  nextConvUs = 0;
+  convCount = 0;
+
+  Sequencer::clear();
+  Sequencer::append({5000, 1000, 2000, 70, Sequencer::KEEP_PROFILE});   // 700 ms
+  Sequencer::append({12000, 1500, 3000, 35, Sequencer::KEEP_PROFILE});  // 350 ms
+  Sequencer::setLoops(2);
+  CHECK(Sequencer::start());
+  tick();
+  CHECK(Sequencer::getState() == Sequencer::State::Running);
+  CHECK_NEAR(labV_set, 5.0, 1e-6);
+
+  // First pass, with a 200 ms pause in the middle of step 0
+  runMs(300);
+  Sequencer::pause();
+  runMs(200);
+  CHECK(Sequencer::getState() == Sequencer::State::Paused);
+  CHECK(Sequencer::getCurrentStep() == 0);
+  Sequencer::resume();
+  runMs(450);
+  CHECK(Sequencer::getCurrentStep() == 1);
+  CHECK_NEAR(labV_set, 12.0, 1e-6);
+  CHECK_NEAR(labI_cut, 3.0, 1e-6);
+
+  runMs(1200);
+  CHECK(Sequencer::getState() == Sequencer::State::Running);
+  CHECK(Sequencer::getLoop() == 1);
+
+  runMs(1000);
+  CHECK(Sequencer::getState() == Sequencer::State::Done);
+  CHECK(Sequencer::getLoop() == 2);
+
+  // Results are from the second pass: step starts sit on the programmed deadlines
+  const Sequencer::StepResult& r0 = Sequencer::getResult(0);
+  const Sequencer::StepResult& r1 = Sequencer::getResult(1);
+  printf("step 0: start %u ms, %u samples, %.3f V, %.3f A\n", (unsigned)r0.startMs, r0.samples, r0.vAvg, r0.iAvg);
+  printf("step 1: start %u ms, %u samples, %.3f V, %.3f A\n", (unsigned)r1.startMs, r1.samples, r1.vAvg, r1.iAvg);
+  CHECK_NEAR(r0.startMs, 700 + 200 + 350, 5);  // Pause shifts everything after it by 200 ms
+  CHECK_NEAR(r1.startMs, 700 + 200 + 350 + 700, 5);
+
+  // 70 ms per conversion pair: 20 conversions in step 0, 10 in step 1, give or take an edge
+  CHECK_NEAR(r0.samples, 20, 1);
+  CHECK_NEAR(r1.samples, 10, 1);
+  // Per-conversion average is the midpoint; per-tick weighting would pull it to ~10.3 V
+  CHECK_NEAR(r0.vAvg, 11.0, 0.11);
+  CHECK_NEAR(r0.iAvg, 1.5, 0.06);
+  CHECK_NEAR(r1.vAvg, 11.0, 0.21);
+
+  // Fast profile, 400 s dwell: a conversion every tick, 80000 of them, alternating readings 2 mV / 0.2 mA
+  // apart. The count must not wrap and the average must hold to well under the spread.
+  Sequencer::clear();
+  Sequencer::append({12000, 1000, 2000, 40000, Sequencer::KEEP_PROFILE});
+  Sequencer::append({5000, 1000, 2000, 10, Sequencer::KEEP_PROFILE});
+  Sequencer::setLoops(1);
+  CHECK(Sequencer::start());
+  uint32_t fastTicks = 0;
+  while (Sequencer::getState() != Sequencer::State::Done && fastTicks < 100000) {
+    HostHal::advanceUs(TICK_US);
+    bool odd = ++fastTicks & 1;
+    labV_meas = odd ? 12.001f : 12.003f;
+    labI_meas = odd ? 1.0001f : 1.0003f;
+    Sequencer::tick(true);
+  }
+  const Sequencer::StepResult& rl = Sequencer::getResult(0);
+  printf("400 s step: %u samples, %.5f V, %.6f A\n", (unsigned)rl.samples, rl.vAvg, rl.iAvg);
+  CHECK(Sequencer::getState() == Sequencer::State::Done);
+  CHECK_NEAR(rl.samples, 80000, 1);
+  CHECK_NEAR(rl.vAvg, 12.002, 0.0002);
+  CHECK_NEAR(rl.iAvg, 1.0002, 0.00002);
+
+  return checkResult("test_sequencer");
+}
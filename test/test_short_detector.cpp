@@ -0,0 +1,130 @@
+// ShortDetector replayed on closed-loop plant traces: CV->CC transitions pull the voltage down while
+// the current rises, like a short, and must not trip; shorts below the regulation floor must trip
+// once. A short the converter holds below the overcurrent threshold must be caught strictly ahead of
+// it; a dead short crosses the threshold on its first conversion (the output capacitor discharges
+// into it within microseconds), so it must be caught on that same conversion, at the control tick
+// and at the fast profile's conversion spacing alike.
+
+#include "Check.h"
+#include "Rig.h"
+#include "HostHal.h"
+#include "Globals.h"
+#include "ShortDetector.h"
+#include <algorithm>
+#include <functional>
+
+static const ShortDetector::Config CFG = {0.05f, 0.2f};  // Firmware defaults
+constexpr uint32_t PERIOD_US = 5000;  // Fast INA226 profile: the detector needs a few samples per short
+constexpr uint32_t CONV_US = 280;     // Fast profile conversion spacing (140 us bus + 140 us shunt)
+
+struct Replay {
+  int events = 0;        // Detections over the trace
+  float firstMs = NAN;   // First detection after the disturbance (ms)
+  float thresholdMs = INFINITY; // First sample at or above the threshold (ms), INFINITY = never
+  float savedMs = 0.0f;  // Lead the detector logged for the first event (ms)
+  int plain = 0;         // Samples where slope and collapse alone would have fired
+  float endI = 0.0f;     // Current at the end of the trace (A)
+};
+
+// The slope and collapse tests on their own, as the detector ran them before the CC gate
+struct PlainCheck {
+  static constexpr uint8_t N = ShortDetector::WINDOW;
+  float i[N] = {};
+  uint32_t t[N] = {};
+  float vRef = 0.0f;
+  uint32_t n = 0;
+
+  bool step(uint32_t us, float v, float iNow) {
+    if (n == 0) {
+      vRef = v;
+    } else {
+      float dtMs = (us - t[(n - 1) % N]) * 1e-3f;
+      vRef += (v - vRef) * dtMs / (ShortDetector::V_REF_TAU_MS + dtMs);
+    }
+    uint8_t oldest = (n + 1) % N;  // N - 1 samples back once this one is stored
+    float slope = n >= N ? (iNow - i[oldest]) * 1000.0f / (us - t[oldest]) : 0.0f;
+    i[n % N] = iNow;
+    t[n % N] = us;
+    n++;
+    return slope >= CFG.slopeAms && (vRef - v) / vRef >= CFG.collapse;
+  }
+};
+
+// Run the rig from steady state, apply the disturbance and feed every sample to a fresh detector
+static Replay replay(float iset, float threshold, const std::function<void(float ms)>& disturb,
+                     uint32_t periodUs = PERIOD_US) {
+  Rig::begin(Plant::buck(), 12.0f, 12.0f, iset);
+  controlPeriodUs = periodUs;
+  Rig::run(3000);
+  ShortDetector::Detector det;
+  PlainCheck plain;
+  Replay r;
+  for (int k = 0; k < ShortDetector::WINDOW; k++) {  // Steady-state samples fill the window first
+    Rig::Point p = Rig::tick();
+    det.step((uint32_t)p.us, p.v, p.i, threshold, iset, CFG, 0);
+    plain.step((uint32_t)p.us, p.v, p.i);
+  }
+  uint64_t t0 = HostHal::nowUs();
+  for (float ms = 0.0f; ms < 2000.0f;) {
+    disturb(ms);
+    Rig::Point p = Rig::tick();
+    ms = (p.us - t0) / 1000.0f;
+    if (isinf(r.thresholdMs) && p.i >= threshold) r.thresholdMs = ms;
+    r.endI = p.i;
+    r.plain += plain.step((uint32_t)p.us, p.v, p.i);
+    if (det.step((uint32_t)p.us, p.v, p.i, threshold, iset, CFG, ms)) {
+      if (r.events++ == 0) {
+        r.firstMs = ms;
+        r.savedMs = det.getEvent(0).savedMs;
+      }
+    }
+  }
+  return r;
+}
+
+int main() {
+  // Load step into the current limit: I overshoots towards 3 A while CC drags V from 12 V to 6 V
+  Replay step = replay(1.5f, 3.0f, [](float ms) { if (ms == 0) Plant::setLoad(4.0f); });
+  // Load ramped through the limit over a second
+  Replay ramp = replay(1.5f, 3.0f, [](float ms) { Plant::setLoad(12.0f - 9.0f * std::min(ms, 1000.0f) / 1000.0f); });
+  // Fast ramp into CC at the edge of the regulation floor (3 V): I overshoots past iset while V
+  // collapses, then CC pulls it back
+  Replay fast = replay(1.5f, 9.0f, [](float ms) { Plant::setLoad(ms < 30 ? 12.0f - 10.0f * ms / 30.0f : 2.0f); });
+  // Dead short; CC cannot regulate below the dutyMin floor, so I runs to the converter limit
+  Replay dead = replay(1.0f, 2.0f, [](float ms) { if (ms == 0) Plant::setLoad(0.05f); });
+  // Shorts with the threshold above the converter limit (5 A): only the detector catches them
+  Replay deadHigh = replay(1.0f, 9.0f, [](float ms) { if (ms == 0) Plant::setLoad(0.05f); });
+  Replay ohm = replay(1.0f, 9.0f, [](float ms) { if (ms == 0) Plant::setLoad(1.0f); });
+  // The dead short fed one conversion at a time
+  Replay deadConv = replay(1.0f, 2.0f, [](float ms) { if (ms == 0) Plant::setLoad(0.05f); }, CONV_US);
+
+  printf("%-16s %7s %7s %10s %12s %9s\n", "trace", "events", "plain", "first ms", "threshold ms", "saved ms");
+  const Replay* all[] = {&step, &ramp, &fast, &dead, &deadHigh, &ohm, &deadConv};
+  const char* names[] = {"CV->CC step", "CV->CC ramp", "CV->CC fast", "dead short", "dead, high cut",
+                         "1 ohm short", "dead, per conv"};
+  for (int k = 0; k < 7; k++)
+    printf("%-16s %7d %7d %10.2f %12.2f %9.1f\n", names[k], all[k]->events, all[k]->plain, all[k]->firstMs,
+           all[k]->thresholdMs, all[k]->savedMs);
+
+  // CV->CC transitions never trip; the fast one does look like a short to slope and collapse alone
+  CHECK(step.events == 0);
+  CHECK(ramp.events == 0);
+  CHECK(fast.events == 0);
+  CHECK(fast.plain > 0);
+  CHECK_NEAR(fast.endI, 1.5, 0.1);
+
+  // Shorts held below the threshold trip once, strictly ahead of it
+  for (const Replay* r : {&deadHigh, &ohm}) {
+    CHECK(r->events == 1);
+    CHECK(r->firstMs < r->thresholdMs);
+    CHECK(r->savedMs > 0.0f);
+  }
+  // A dead short is over the threshold on its first conversion; the detector fires on that one too
+  for (const Replay* r : {&dead, &deadConv}) {
+    CHECK(r->events == 1);
+    CHECK(r->firstMs == r->thresholdMs);
+  }
+  CHECK(deadConv.firstMs <= CONV_US / 1000.0f);
+
+  return checkResult("test_short_detector");
+}
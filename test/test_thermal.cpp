@@ -0,0 +1,140 @@
+// Thermal model and derating. The RC model's step response against tau, the derating line between
+// its start and full points, and a closed loop: DcControl holding a CC load on the plant while a
+// heatsink model warms the NTC. The derated steady state must settle without tripping the overheat
+// rule, and the rule's hysteresis must give one trip and one clear for a slow, noisy NTC excursion.
+
+#include "Check.h"
+#include "Rig.h"
+#include "HostHal.h"
+#include "Config.h"
+#include "ErrMgr.h"
+#include "Globals.h"
+#include "Protection.h"
+#include "Thermal.h"
+
+constexpr float AMBIENT_C = 45.0f;       // Air around the heatsink
+constexpr float HEATSINK_C_W = 6.0f;     // NTC-to-ambient (°C/W)
+constexpr float HEATSINK_TAU_S = 20.0f;
+constexpr float LOAD_OHMS = 2.0f;        // Wants 6 A at 12 V, so the 3 A limit holds it in CC
+constexpr uint32_t RUN_S = 300;
+constexpr uint32_t TAIL_S = 60;          // Steady-state window at the end of the run
+
+static float expectedDerate(float tj) {
+  float full = tempLimitC - tempDiffC;
+  float start = full - THERMAL_DERATE_SPAN_C;
+  if (tj <= start) return 1.0f;
+  if (tj >= full) return THERMAL_DERATE_MIN;
+  return 1.0f - (1.0f - THERMAL_DERATE_MIN) * (tj - start) / THERMAL_DERATE_SPAN_C;
+}
+
+static uint32_t overheatEdges = 0;       // Overheat bit changes seen by tickProtection()
+
+static void tickProtection() {
+  bool was = ErrMgr::isActive(ErrMgr::Overheat);
+  Protection::Inputs in = {false, false, Thermal::getJunctionC(), 0.0f, false, false};
+  Protection::evaluate(in);
+  if (ErrMgr::isActive(ErrMgr::Overheat) != was) overheatEdges++;
+}
+
+int main() {
+  uint32_t period = DC_CONTROL_UPDATE_INTERVAL * 1000UL;
+  Thermal::setPeriod(period);
+  Protection::setPeriod(period);
+  ErrMgr::begin();
+
+  // Step response: constant loss at a fixed NTC reaches 63 % of loss * Rth after tau, ~99 % after 5 tau
+  outputActive = true;
+  labTemp_ntc = 25.0f;
+  labV_meas = 10.0f;
+  labI_meas = 1.0f;
+  Thermal::reset();
+  Thermal::update();
+  float lossW = Thermal::getLossW();
+  float finalRise = lossW * THERMAL_RTH_C_W;
+  uint32_t tauTicks = (uint32_t)(THERMAL_TAU_S * 1e6f / period + 0.5f);
+  for (uint32_t k = 1; k < tauTicks; k++) Thermal::update();
+  float atTau = (Thermal::getJunctionC() - labTemp_ntc) / finalRise;
+  for (uint32_t k = tauTicks; k < 5 * tauTicks; k++) Thermal::update();
+  float at5Tau = (Thermal::getJunctionC() - labTemp_ntc) / finalRise;
+  printf("step: %.3f W loss, rise %.3f of %.2f C after tau, %.4f after 5 tau\n", lossW, atTau, finalRise, at5Tau);
+  CHECK_NEAR(lossW, 10.0f * (1.0f / THERMAL_EFFICIENCY - 1.0f) + THERMAL_RDS_ON, 1e-4f);
+  CHECK_NEAR(atTau, 1.0f - expf(-1.0f), 0.01f);
+  CHECK_NEAR(at5Tau, 1.0f, 0.01f);
+
+  // Derating slope: output off so the junction is the NTC, swept through the derating band
+  outputActive = false;
+  Thermal::reset();
+  labV_meas = 5.0f;
+  labI_set = 3.0f;
+  float worst = 0.0f, prev = 1.0f;
+  bool monotonic = true;
+  for (float t = 40.0f; t <= 75.0f; t += 0.25f) {
+    labTemp_ntc = t;
+    Thermal::update();
+    float d = Thermal::getDerate();
+    worst = max(worst, fabsf(d - expectedDerate(t)));
+    monotonic &= d <= prev;
+    prev = d;
+    float limit = min(labI_set * d, d < 1.0f ? systemPowerMax * d / labV_meas : labI_set);
+    worst = max(worst, fabsf(Thermal::limitCurrent(labI_set) - limit));
+  }
+  printf("slope: worst deviation %.2e, %.3f/C over %.0f C\n", worst,
+         (1.0f - THERMAL_DERATE_MIN) / THERMAL_DERATE_SPAN_C, THERMAL_DERATE_SPAN_C);
+  CHECK(worst < 1e-5f);
+  CHECK(monotonic);
+
+  // Closed loop: CC load on the buck plant, NTC on a heatsink warmed by the same loss estimate
+  Rig::begin(Plant::buck(), LOAD_OHMS, 12.0f, 3.0f);
+  ErrMgr::update();
+  ErrMgr::assign(UINT32_MAX, 0);
+  ErrMgr::begin();
+  Protection::reset();
+  Thermal::reset();
+  overheatEdges = 0;
+  float sink = 0.0f;                     // Heatsink rise above ambient (°C)
+  float hsAlpha = 1.0f - expf(-(period * 1e-6f) / HEATSINK_TAU_S);
+  float peakTj = 0.0f, tailMin = INFINITY, tailMax = -INFINITY, tailDerate = 0.0f;
+  uint32_t ticks = RUN_S * 1000000UL / period, tail = TAIL_S * 1000000UL / period, derating = 0;
+  for (uint32_t k = 0; k < ticks; k++) {
+    labTemp_ntc = AMBIENT_C + sink;
+    Thermal::update();
+    Rig::tick();
+    sink += (Thermal::getLossW() * HEATSINK_C_W - sink) * hsAlpha;
+    tickProtection();
+    float tj = Thermal::getJunctionC();
+    peakTj = max(peakTj, tj);
+    if (Thermal::getDerate() < 1.0f) derating++;
+    if (k >= ticks - tail) {
+      tailMin = min(tailMin, tj);
+      tailMax = max(tailMax, tj);
+      tailDerate = Thermal::getDerate();
+    }
+  }
+  printf("loop: Tj peak %.2f C, steady %.2f..%.2f C, derate %.3f, %.2f A at %.2f V, %u overheat edges\n",
+         peakTj, tailMin, tailMax, tailDerate, labI_meas, labV_meas, (unsigned)overheatEdges);
+  CHECK(derating > 0);
+  CHECK(tailDerate > THERMAL_DERATE_MIN && tailDerate < 0.9f);      // Settled inside the band
+  CHECK(tailMax - tailMin < 0.2f);                                  // Converged, no limit cycle
+  CHECK(peakTj < tempLimitC - tempDiffC);                           // Never near the trip point
+  CHECK_NEAR(labI_meas, 3.0f * tailDerate, 0.05f);                  // CC loop follows the derated limit
+  CHECK(overheatEdges == 0);
+
+  // Hysteresis: NTC drifts past the limit and back with ±0.3 °C noise; one trip, one clear
+  outputActive = false;
+  Thermal::reset();
+  Protection::reset();
+  overheatEdges = 0;
+  uint32_t seed = 1;
+  float temp = 60.0f;
+  for (uint32_t k = 0; k < 4000; k++) {
+    temp += k < 2000 ? 0.008f : -0.008f;  // 60 -> 76 -> 60 °C
+    seed = seed * 1664525u + 1013904223u;
+    labTemp_ntc = temp + ((seed >> 8) / 16777216.0f - 0.5f) * 0.6f;
+    Thermal::update();
+    tickProtection();
+  }
+  printf("hysteresis: %u overheat edges over a 60 -> 76 -> 60 C sweep\n", (unsigned)overheatEdges);
+  CHECK(overheatEdges == 2);
+
+  return checkResult("test_thermal");
+}
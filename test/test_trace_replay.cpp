@@ -0,0 +1,155 @@
+// Trace record and replay on the simulated clock: a mock-source run with a load creeping past the
+// fuse rating is recorded to flash, loaded into the trace player and replayed through the control
+// path. The replay must blow the fuse on the recorded tick and run at least 1000x real time. Starting a
+// replay restarts the control path (loops, slew, NTC filter, thermal model, fuse, short predictor,
+// protection), so 1000 replays back to back in one process, each following whatever the previous one
+// left behind, must agree bit for bit with each other and with the first.
+
+#include "Check.h"
+#include "HostHal.h"
+#include "BlackBox.h"
+#include "ControlTask.h"
+#include "DcControl.h"
+#include "ErrMgr.h"
+#include "Globals.h"
+#include "OutputControl.h"
+#include "SensorSource.h"
+#include "TraceRecorder.h"
+#include <LittleFS.h>
+#include <chrono>
+
+constexpr uint32_t RECORD_MS = 8000;     // Recorded run
+constexpr uint32_t REPLAYS = 1000;       // Back-to-back replays compared against the first
+constexpr uint32_t ENABLE_TICK = 30;     // Output enable in the recorded run
+constexpr double MIN_SPEEDUP = 1000.0;   // Replay speed against the recorded time
+
+// What a replay did to the control path
+struct Digest {
+  uint32_t ticks;        // Ticks until the trace ran out
+  uint32_t faultTick;    // First tick with the fuse blown (0 = none)
+  uint32_t code;         // Latched errors at the end
+  double dutySum;        // Sum of PWM duty over all ticks (%)
+  double vSum;           // Sum of labV_meas over all ticks (V)
+};
+
+static bool same(const Digest& a, const Digest& b) {
+  return a.ticks == b.ticks && a.faultTick == b.faultTick && a.code == b.code && a.dutySum == b.dutySum &&
+         a.vSum == b.vSum;
+}
+
+// One control tick from loop(), as on a board without the control task
+static void tick() {
+  HostHal::advanceUs(controlPeriodUs);
+  ControlTask::poll();
+  TraceRecorder::update();
+}
+
+// Recorded run: 12 V output enabled after a second, load ramping 0.5 -> 3.0 A against a 2 A fuse
+static uint32_t record() {
+  labV_set = 12.0f;
+  labI_set = 2.5f;
+  labI_cut = 2.0f;
+  manualOutputEnable = false;
+  modeAuto = true;
+  SensorSource::select(SensorSource::Kind::Mock);
+  CHECK(TraceRecorder::start(TraceRecorder::Dest::Flash));
+
+  uint32_t ticks = RECORD_MS * 1000UL / controlPeriodUs;
+  uint32_t faultTick = 0;
+  for (uint32_t k = 1; k <= ticks; k++) {
+    float i = 0.5f + 2.5f * k / ticks;
+    SensorSource::mock().set(12.0f - 0.2f * i, i, 1.65f);
+    if (k == ENABLE_TICK) manualOutputEnable = true;
+    tick();
+    if (!faultTick && ErrMgr::isActive(ErrMgr::FuseBlown)) faultTick = k;
+  }
+  TraceRecorder::stop();
+  TraceRecorder::update();
+  return faultTick;
+}
+
+// Play the loaded trace once from its start; the first tick restarts the control path
+static Digest replay() {
+  Digest d = {};
+  SensorSource::select(SensorSource::Kind::Mock);
+  SensorSource::select(SensorSource::Kind::Trace);
+  while (!SensorSource::trace().finished()) {
+    tick();
+    d.ticks++;
+    d.dutySum += DcControl::getPwmDuty();
+    d.vSum += labV_meas;
+    if (!d.faultTick && ErrMgr::isActive(ErrMgr::FuseBlown)) d.faultTick = d.ticks;
+  }
+  d.code = ErrMgr::code();
+  return d;
+}
+
+int main() {
+  HostHal::reset();
+  HostHal::setTaskCreateFails(true);  // poll() runs the ticks
+
+  // setup() mounts once and hands the result to both flash users
+  bool fsMounted = LittleFS.begin(true);
+  CHECK(fsMounted);
+  TraceRecorder::begin(fsMounted);
+  BlackBox::begin(fsMounted);
+  CHECK(HostHal::fsBeginCount() == 1);
+
+  OutputControl::begin();
+  DcControl::begin();
+  ErrMgr::begin();
+  ControlTask::begin();
+  CHECK(!ControlTask::isRunning());
+
+  uint32_t recordedFault = record();
+  File f = LittleFS.open(TraceRecorder::TRACE_PATH, "r");
+  size_t size = f.size();
+  f.close();
+  printf("recorded %u records (%u bytes), fault at tick %u\n", (unsigned)TraceRecorder::getRecordCount(),
+         (unsigned)size, (unsigned)recordedFault);
+  CHECK(recordedFault > 0);
+  CHECK(TraceRecorder::getDropped() == 0);
+  CHECK(size == sizeof(TraceHeader) + TraceRecorder::getRecordCount() * sizeof(TraceRecord));
+
+  // Upload checks: header plus whole records, and the free space a replacement trace may use
+  CHECK(TraceRecorder::isValidSize(size));
+  CHECK(!TraceRecorder::isValidSize(size + 7));
+  CHECK(!TraceRecorder::isValidSize(sizeof(TraceHeader)));
+  CHECK(!TraceRecorder::isValidSize(sizeof(TraceHeader) - 1));
+  size_t fullFree = TraceRecorder::freeBytes();
+  CHECK(fullFree == LittleFS.totalBytes() - LittleFS.usedBytes() + size);  // The old trace is replaced
+  HostHal::setFsCapacity(LittleFS.usedBytes() + 100);
+  CHECK(TraceRecorder::freeBytes() == 100 + size);
+  HostHal::setFsCapacity(1024 * 1024);
+
+  TraceRecorder::requestLoad();
+  TraceRecorder::update();
+  CHECK(SensorSource::trace().getCount() == TraceRecorder::getRecordCount());
+
+  // Straight after the recording, with its fault still latched: reproduces the recorded fault, and fast
+  auto t0 = std::chrono::steady_clock::now();
+  Digest first = replay();
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  double speedup = RECORD_MS / 1000.0 / wallS;
+  printf("replay: %u ticks, fault at tick %u, code 0x%x, %.1f us per tick, %.0fx real time\n", (unsigned)first.ticks,
+         (unsigned)first.faultTick, (unsigned)first.code, wallS * 1e6 / first.ticks, speedup);
+  CHECK(first.code & (1UL << ErrMgr::FuseBlown));
+  CHECK(first.faultTick == recordedFault);
+  CHECK(speedup >= MIN_SPEEDUP);
+
+  // Back to back, each replay inherits the previous one's end state (blown fuse, hot junction, wound-up
+  // loops) and a later clock; all must match the first exactly
+  Digest last = {};
+  uint32_t differ = 0;
+  for (uint32_t n = 0; n < REPLAYS; n++) {
+    last = replay();
+    if (!same(last, first)) differ++;
+  }
+  printf("%u replays: %u differ; ticks %u, fault tick %u, duty sum %.6f (first %.6f), V sum %.6f (first %.6f)\n",
+         (unsigned)REPLAYS, (unsigned)differ, (unsigned)last.ticks, (unsigned)last.faultTick, last.dutySum,
+         first.dutySum, last.vSum, first.vSum);
+  CHECK(differ == 0);
+  CHECK(same(last, first));
+
+  return checkResult("test_trace_replay");
+}